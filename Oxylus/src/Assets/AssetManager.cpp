@@ -2,6 +2,7 @@
 
 #include <filesystem>
 
+#include "Audio/AudioClip.hpp"
 #include "Audio/AudioSource.hpp"
 #include "Render/Mesh.h"
 
@@ -36,13 +37,18 @@ Shared<Mesh> AssetManager::get_mesh_asset(const std::string& path, const uint32_
   return load_mesh_asset(path, loadingFlags);
 }
 
-Shared<AudioSource> AssetManager::get_audio_asset(const std::string& path) {
+Shared<AudioClip> AssetManager::get_audio_clip(const std::string& path) {
   OX_SCOPED_ZONE;
-  if (asset_library.audio_assets.contains(path)) {
-    return asset_library.audio_assets[path];
+  if (asset_library.audio_clips.contains(path)) {
+    return asset_library.audio_clips[path];
   }
 
-  return load_audio_asset(path);
+  return load_audio_clip(path);
+}
+
+Shared<AudioSource> AssetManager::get_audio_asset(const std::string& path) {
+  OX_SCOPED_ZONE;
+  return create_shared<AudioSource>(get_audio_clip(path));
 }
 
 Shared<TextureAsset> AssetManager::load_texture_asset(const std::string& path) {
@@ -68,10 +74,10 @@ Shared<Mesh> AssetManager::load_mesh_asset(const std::string& path, uint32_t loa
   return asset_library.mesh_assets.emplace(path, asset).first->second;
 }
 
-Shared<AudioSource> AssetManager::load_audio_asset(const std::string& path) {
+Shared<AudioClip> AssetManager::load_audio_clip(const std::string& path) {
   OX_SCOPED_ZONE;
-  Shared<AudioSource> source = create_shared<AudioSource>(path);
-  return asset_library.audio_assets.emplace(path, source).first->second;
+  Shared<AudioClip> clip = create_shared<AudioClip>(path);
+  return asset_library.audio_clips.emplace(path, clip).first->second;
 }
 
 void AssetManager::free_unused_assets() {
@@ -89,5 +95,12 @@ void AssetManager::free_unused_assets() {
 
   if (t_count > 0)
     OX_LOG_INFO("Cleaned up {} mesh assets.", t_count);
+
+  const auto a_count = std::erase_if(asset_library.audio_clips, [](const std::pair<std::string, Shared<AudioClip>>& pair) {
+    return pair.second.use_count() <= 1;
+  });
+
+  if (a_count > 0)
+    OX_LOG_INFO("Cleaned up {} audio clips.", a_count);
 }
 }
@@ -11,6 +11,7 @@ struct ImageCreateInfo;
 class Material;
 class Mesh;
 class AudioSource;
+class AudioClip;
 
 using AssetID = std::string;
 
@@ -19,6 +20,9 @@ public:
   static Shared<TextureAsset> get_texture_asset(const TextureLoadInfo& info);
   static Shared<TextureAsset> get_texture_asset(const std::string& name, const TextureLoadInfo& info);
   static Shared<Mesh> get_mesh_asset(const std::string& path, uint32_t loadingFlags = 0);
+  /// Decoded or streamed audio data, shared by every voice of the same file.
+  static Shared<AudioClip> get_audio_clip(const std::string& path);
+  /// Creates a new voice for the clip at path. Voices aren't cached, the clip is.
   static Shared<AudioSource> get_audio_asset(const std::string& path);
 
   static void free_unused_assets();
@@ -27,12 +31,12 @@ private:
   static struct AssetLibrary {
     ankerl::unordered_dense::map<AssetID, Shared<TextureAsset>> texture_assets ;
     ankerl::unordered_dense::map<AssetID, Shared<Mesh>> mesh_assets;
-    ankerl::unordered_dense::map<AssetID, Shared<AudioSource>> audio_assets;
+    ankerl::unordered_dense::map<AssetID, Shared<AudioClip>> audio_clips;
   } asset_library;
 
   static Shared<TextureAsset> load_texture_asset(const std::string& path);
   static Shared<TextureAsset> load_texture_asset(const std::string& path, const TextureLoadInfo& info);
   static Shared<Mesh> load_mesh_asset(const std::string& path, uint32_t loadingFlags);
-  static Shared<AudioSource> load_audio_asset(const std::string& path);
+  static Shared<AudioClip> load_audio_clip(const std::string& path);
 };
 }
@@ -0,0 +1,64 @@
+#include "AudioClip.hpp"
+
+#include <miniaudio.h>
+
+#include "AudioEngine.hpp"
+
+#include "Core/App.hpp"
+
+#include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+static float get_file_length(const std::string& path) {
+  ma_decoder decoder;
+  if (ma_decoder_init_file(path.c_str(), nullptr, &decoder) != MA_SUCCESS)
+    return -1.0f;
+
+  ma_uint64 frames = 0;
+  ma_decoder_get_length_in_pcm_frames(&decoder, &frames);
+  const float length = decoder.outputSampleRate > 0 ? (float)frames / (float)decoder.outputSampleRate : 0.0f;
+  ma_decoder_uninit(&decoder);
+  return length;
+}
+
+AudioClip::AudioClip(std::string path, const AudioClipLoadMode mode) : path(std::move(path)) {
+  OX_SCOPED_ZONE;
+
+  length = get_file_length(this->path);
+  if (length < 0.0f) {
+    OX_LOG_ERROR("Failed to load audio clip: {}", this->path);
+    length = 0.0f;
+    return;
+  }
+
+  streamed = mode == AudioClipLoadMode::Stream || (mode == AudioClipLoadMode::Auto && length > STREAM_THRESHOLD_SECONDS);
+  if (streamed) {
+    loaded = true;
+    return;
+  }
+
+  // Registering keeps the decoded data resident for as long as the clip lives, voices created with MA_SOUND_FLAG_DECODE just reference it.
+  auto* resource_manager = ma_engine_get_resource_manager(App::get_system<AudioEngine>()->get_engine());
+  const ma_result result = ma_resource_manager_register_file(resource_manager, this->path.c_str(), MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE);
+  if (result != MA_SUCCESS) {
+    OX_LOG_ERROR("Failed to decode audio clip: {}", this->path);
+    return;
+  }
+
+  loaded = true;
+}
+
+AudioClip::~AudioClip() {
+  if (!loaded || streamed)
+    return;
+
+  auto* resource_manager = ma_engine_get_resource_manager(App::get_system<AudioEngine>()->get_engine());
+  ma_resource_manager_unregister_file(resource_manager, path.c_str());
+}
+
+uint32_t AudioClip::get_sound_flags() const {
+  // Streams are opened async so starting one never waits for the first page to decode.
+  return streamed ? MA_SOUND_FLAG_STREAM | MA_SOUND_FLAG_ASYNC : MA_SOUND_FLAG_DECODE;
+}
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace ox {
+enum class AudioClipLoadMode {
+  Auto = 0, // Decode short clips, stream long ones
+  Decode,
+  Stream,
+};
+
+/// Audio data shared by every AudioSource playing the same file.
+/// Short clips are decoded once into memory and every voice reads from that copy.
+/// Long clips are streamed, miniaudio's resource manager decodes pages ahead on its job thread.
+class AudioClip {
+public:
+  /// Clips longer than this are streamed in Auto mode.
+  static constexpr float STREAM_THRESHOLD_SECONDS = 10.0f;
+
+  explicit AudioClip(std::string path, AudioClipLoadMode mode = AudioClipLoadMode::Auto);
+  ~AudioClip();
+  AudioClip(const AudioClip& other) = delete;
+  AudioClip(AudioClip&& other) = delete;
+
+  const std::string& get_path() const { return path; }
+  bool is_loaded() const { return loaded; }
+  bool is_streamed() const { return streamed; }
+  float get_length() const { return length; }
+
+  /// ma_sound flags voices have to be created with to share this clip's data.
+  uint32_t get_sound_flags() const;
+
+private:
+  std::string path;
+  float length = 0.0f; // Seconds
+  bool streamed = false;
+  bool loaded = false;
+};
+}
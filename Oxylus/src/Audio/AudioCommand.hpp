@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+#include "AudioListener.hpp"
+#include "AudioSource.hpp"
+
+namespace ox {
+class AudioVoice;
+
+/// Request from the game thread to the audio thread.
+/// Commands are executed in the order of their time, commands with the same time in push order. See AudioEngine::execute_commands.
+struct AudioCommand {
+  enum class Type : uint8_t {
+    AddVoice,
+    RemoveVoice, // Hands ownership of the voice to the audio thread, it's deleted there
+    Play,
+    Pause,
+    UnPause,
+    Stop,
+    SetConfig,
+    SetPosition,
+    SetDirection,
+    SetVelocity,
+
+    SetListenerConfig,
+    SetListenerPosition,
+    SetListenerDirection,
+    SetListenerVelocity,
+  };
+
+  Type type = Type::Play;
+  double time = 0.0; // AudioEngine::now() based seconds, the command isn't executed before this
+  bool delayed = false; // Play from AudioSource::play_delayed, counted in AudioVoice's pending plays
+  AudioVoice* voice = nullptr;
+  uint32_t listener = 0;
+  Vec3 vector = {};
+  AudioSourceConfig config = {};
+  AudioListenerConfig listener_config = {};
+};
+}
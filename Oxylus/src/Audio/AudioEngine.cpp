@@ -2,8 +2,15 @@
 
 #define MINIAUDIO_IMPLEMENTATION
 
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
 #include <miniaudio.h>
 
+#include "AudioVoice.hpp"
+
+#include "Core/App.hpp"
+
 #include "Utils/Log.hpp"
 #include "Utils/Profiler.hpp"
 
@@ -13,19 +20,187 @@ void AudioEngine::init() {
   ma_engine_config config = ma_engine_config_init();
   config.listenerCount = 1;
 
-  engine = new ma_engine();
-  const ma_result result = ma_engine_init(&config, engine);
+  auto* new_engine = new ma_engine();
+  const ma_result result = ma_engine_init(&config, new_engine);
   OX_CHECK_EQ(result, MA_SUCCESS, "Failed to initialize audio engine!");
+  ma_engine_listener_set_world_up(new_engine, 0, 0, 1, 0);
+  engine.store(new_engine, std::memory_order_release);
+
+  if (AudioCVar::cvar_threaded.get()) {
+    running = true;
+    thread = std::thread([this] { run(); });
+  }
 
   OX_LOG_INFO("Initalized audio engine.");
 }
 
 void AudioEngine::deinit() {
-  ma_engine_uninit(engine);
-  delete engine;
+  running = false;
+  if (thread.joinable())
+    thread.join();
+
+  // Flush what's left, then release the sounds of sources that outlive the engine.
+  // Their voices are deleted by push_command once the sources are destroyed.
+  execute_commands(true);
+  voice_manager.release_all();
+
+  auto* old_engine = engine.exchange(nullptr, std::memory_order_acq_rel);
+  ma_engine_uninit(old_engine);
+  delete old_engine;
+}
+
+void AudioEngine::update() {
+  if (!running.load(std::memory_order_relaxed) && get_engine())
+    tick((float)App::get_timestep().get_seconds());
 }
 
 ma_engine* AudioEngine::get_engine() const {
-  return engine;
+  return engine.load(std::memory_order_acquire);
+}
+
+void AudioEngine::push_command(const AudioCommand& command) {
+  if (!get_engine()) {
+    // Shut down already, nothing would drain the queue.
+    if (command.type == AudioCommand::Type::RemoveVoice)
+      delete command.voice;
+    return;
+  }
+
+  commands.push(command);
+}
+
+double AudioEngine::now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void AudioEngine::run() {
+  CpuProfiler::set_thread_name("Audio");
+  const double step_time = 1.0 / UPDATE_RATE;
+
+  double last = now();
+  while (running.load(std::memory_order_relaxed)) {
+    const double current = now();
+    tick((float)(current - last));
+    last = current;
+
+    const double next = current + step_time;
+    const double after = now();
+    if (next > after)
+      std::this_thread::sleep_for(std::chrono::duration<double>(next - after));
+  }
+}
+
+void AudioEngine::tick(const float delta_time) {
+  OX_SCOPED_ZONE_N("Audio Update");
+
+  execute_commands();
+
+  const ma_vec3f listener_position = ma_engine_listener_get_position(get_engine(), 0);
+  voice_manager.update(Vec3(listener_position.x, listener_position.y, listener_position.z),
+                       delta_time,
+                       (uint32_t)glm::max(AudioCVar::cvar_max_voices.get(), 0));
+}
+
+// Earliest time first, then push order. std heaps keep the largest element in front.
+bool AudioEngine::is_scheduled_after(const ScheduledCommand& a, const ScheduledCommand& b) {
+  return a.command.time != b.command.time ? a.command.time > b.command.time : a.sequence > b.sequence;
+}
+
+void AudioEngine::execute_commands(const bool flush) {
+  OX_SCOPED_ZONE;
+
+  const double current = flush ? DBL_MAX : now();
+
+  // Commands that are due run right away, delayed ones wait in the heap without holding back anything pushed after them.
+  AudioCommand command;
+  while (commands.try_pop(command)) {
+    // Scheduled commands that came due before this one was pushed go first, a stop can't cancel a play that already started.
+    execute_scheduled(std::min(command.time, current));
+
+    if (command.type == AudioCommand::Type::Stop || command.type == AudioCommand::Type::RemoveVoice)
+      cancel_scheduled(command);
+
+    if (command.time > current) {
+      scheduled_commands.emplace_back(ScheduledCommand{command, scheduled_sequence++});
+      std::push_heap(scheduled_commands.begin(), scheduled_commands.end(), is_scheduled_after);
+      continue;
+    }
+
+    execute_command(command);
+  }
+
+  execute_scheduled(current);
+}
+
+void AudioEngine::execute_scheduled(const double time) {
+  while (!scheduled_commands.empty() && scheduled_commands.front().command.time <= time) {
+    std::pop_heap(scheduled_commands.begin(), scheduled_commands.end(), is_scheduled_after);
+    const AudioCommand command = scheduled_commands.back().command;
+    scheduled_commands.pop_back();
+    execute_command(command);
+  }
+}
+
+void AudioEngine::cancel_scheduled(const AudioCommand& command) {
+  if (scheduled_commands.empty())
+    return;
+
+  const bool remove = command.type == AudioCommand::Type::RemoveVoice;
+  const auto cancelled = std::erase_if(scheduled_commands, [&command, remove](const ScheduledCommand& scheduled) {
+    const AudioCommand& pending = scheduled.command;
+    if (pending.voice != command.voice || (!remove && pending.type != AudioCommand::Type::Play && pending.type != AudioCommand::Type::UnPause))
+      return false;
+    if (pending.delayed)
+      pending.voice->remove_pending_play();
+    return true;
+  });
+
+  if (cancelled != 0)
+    std::make_heap(scheduled_commands.begin(), scheduled_commands.end(), is_scheduled_after);
+}
+
+void AudioEngine::execute_command(const AudioCommand& command) {
+  AudioVoice* voice = command.voice;
+  switch (command.type) {
+    case AudioCommand::Type::AddVoice: voice_manager.add(voice); break;
+    case AudioCommand::Type::RemoveVoice: {
+      voice_manager.remove(voice);
+      delete voice;
+      break;
+    }
+    case AudioCommand::Type::Play: {
+      voice->play();
+      if (command.delayed)
+        voice->remove_pending_play();
+      break;
+    }
+    case AudioCommand::Type::Pause: voice->pause(); break;
+    case AudioCommand::Type::UnPause: voice->un_pause(); break;
+    case AudioCommand::Type::Stop: voice->stop(); break;
+    case AudioCommand::Type::SetConfig: voice->set_config(command.config); break;
+    case AudioCommand::Type::SetPosition: voice->set_position(command.vector); break;
+    case AudioCommand::Type::SetDirection: voice->set_direction(command.vector); break;
+    case AudioCommand::Type::SetVelocity: voice->set_velocity(command.vector); break;
+    case AudioCommand::Type::SetListenerConfig: {
+      const auto& config = command.listener_config;
+      ma_engine_listener_set_cone(get_engine(), command.listener, config.cone_inner_angle, config.cone_outer_angle, config.cone_outer_gain);
+      break;
+    }
+    case AudioCommand::Type::SetListenerPosition: {
+      const Vec3& v = command.vector;
+      ma_engine_listener_set_position(get_engine(), command.listener, v.x, v.y, v.z);
+      break;
+    }
+    case AudioCommand::Type::SetListenerDirection: {
+      const Vec3& v = command.vector;
+      ma_engine_listener_set_direction(get_engine(), command.listener, v.x, v.y, v.z);
+      break;
+    }
+    case AudioCommand::Type::SetListenerVelocity: {
+      const Vec3& v = command.vector;
+      ma_engine_listener_set_velocity(get_engine(), command.listener, v.x, v.y, v.z);
+      break;
+    }
+  }
 }
 }
@@ -1,16 +1,71 @@
 #pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AudioCommand.hpp"
+#include "AudioVoiceManager.hpp"
+
 #include "Core/ESystem.hpp"
+
+#include "Thread/LockFreeQueue.hpp"
+
+#include "Utils/CVars.hpp"
+
 struct ma_engine;
 
 namespace ox {
+namespace AudioCVar {
+inline AutoCVar_Int cvar_max_voices("audio.max_voices", "maximum number of voices mixed at once, the rest are virtual", 32);
+inline AutoCVar_Int cvar_threaded("audio.threaded", "update voices on a dedicated audio thread, read at init", 1);
+}
+
+/// Owns the miniaudio engine and the voices.
+/// The game thread never calls into miniaudio for sources and listeners, it pushes AudioCommands instead.
+/// They are executed on the audio thread which also runs the voice manager at UPDATE_RATE,
+/// so a frame hitch delays nothing but the commands of that frame.
+/// With audio.threaded off the same work runs in update() on the main thread.
 class AudioEngine : public ESystem {
 public:
+  static constexpr uint32_t COMMAND_QUEUE_SIZE = 4096;
+  static constexpr float UPDATE_RATE = 100.0f;
+
   void init() override;
   void deinit() override;
+  void update() override;
 
   ma_engine* get_engine() const;
 
+  /// Thread safe. Spins if the audio thread is more than COMMAND_QUEUE_SIZE commands behind.
+  void push_command(const AudioCommand& command);
+
+  static double now();
+
 private:
-  ma_engine* engine = nullptr;
+  std::atomic<ma_engine*> engine = nullptr; // Read by push_command from any thread, null outside init/deinit
+  LockFreeQueue<AudioCommand> commands{COMMAND_QUEUE_SIZE};
+
+  std::thread thread;
+  std::atomic<bool> running = false;
+
+  // Only touched by the audio thread
+  AudioVoiceManager voice_manager = {};
+  struct ScheduledCommand {
+    AudioCommand command = {};
+    uint64_t sequence = 0; // Keeps push order between commands with the same time
+  };
+  std::vector<ScheduledCommand> scheduled_commands = {}; // Popped but not due yet, a min-heap on time
+  uint64_t scheduled_sequence = 0;
+
+  static bool is_scheduled_after(const ScheduledCommand& a, const ScheduledCommand& b);
+
+  void run();
+  void tick(float delta_time);
+  /// flush executes everything regardless of its time.
+  void execute_commands(bool flush = false);
+  void execute_command(const AudioCommand& command);
+  void execute_scheduled(double time);
+  /// Stop drops the voice's scheduled plays, RemoveVoice everything scheduled for it.
+  void cancel_scheduled(const AudioCommand& command);
 };
 }
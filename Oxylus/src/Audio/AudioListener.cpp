@@ -1,38 +1,43 @@
 #include "AudioListener.hpp"
 
-#include <miniaudio.h>
+#include "AudioCommand.hpp"
 #include "AudioEngine.hpp"
 
 #include "Core/App.hpp"
 
 namespace ox {
-void AudioListener::set_config(const AudioListenerConfig& config) const {
-  auto* engine = App::get_system<AudioEngine>()->get_engine();
-  ma_engine_listener_set_cone(engine,
-    m_ListenerIndex,
-    config.cone_inner_angle,
-    config.cone_outer_angle,
-    config.cone_outer_gain);
+static void push_listener_command(const uint32_t listener, const AudioCommand::Type type, const Vec3& vector) {
+  App::get_system<AudioEngine>()->push_command(AudioCommand{.type = type, .time = AudioEngine::now(), .listener = listener, .vector = vector});
 }
 
-void AudioListener::set_position(const glm::vec3& position) const {
-  auto* engine = App::get_system<AudioEngine>()->get_engine();
-  ma_engine_listener_set_position(engine, m_ListenerIndex, position.x, position.y, position.z);
+void AudioListener::set_config(const AudioListenerConfig& config) {
+  if (config == m_config)
+    return;
+  m_config = config;
+  App::get_system<AudioEngine>()->push_command(AudioCommand{.type = AudioCommand::Type::SetListenerConfig,
+                                                            .time = AudioEngine::now(),
+                                                            .listener = m_ListenerIndex,
+                                                            .listener_config = config});
+}
 
-  static bool setupWorldUp = false;
-  if (!setupWorldUp) {
-    ma_engine_listener_set_world_up(engine, m_ListenerIndex, 0, 1, 0);
-    setupWorldUp = true;
-  }
+void AudioListener::set_position(const Vec3& position) {
+  if (position == m_position)
+    return;
+  m_position = position;
+  push_listener_command(m_ListenerIndex, AudioCommand::Type::SetListenerPosition, position);
 }
 
-void AudioListener::set_direction(const glm::vec3& forward) const {
-  auto* engine = App::get_system<AudioEngine>()->get_engine();
-  ma_engine_listener_set_direction(engine, m_ListenerIndex, forward.x, forward.y, forward.z);
+void AudioListener::set_direction(const Vec3& forward) {
+  if (forward == m_direction)
+    return;
+  m_direction = forward;
+  push_listener_command(m_ListenerIndex, AudioCommand::Type::SetListenerDirection, forward);
 }
 
-void AudioListener::set_velocity(const glm::vec3& velocity) const {
-  auto* engine = App::get_system<AudioEngine>()->get_engine();
-  ma_engine_listener_set_velocity(engine, m_ListenerIndex, velocity.x, velocity.y, velocity.z);
+void AudioListener::set_velocity(const Vec3& velocity) {
+  if (velocity == m_velocity)
+    return;
+  m_velocity = velocity;
+  push_listener_command(m_ListenerIndex, AudioCommand::Type::SetListenerVelocity, velocity);
 }
 }
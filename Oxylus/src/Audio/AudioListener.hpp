@@ -6,18 +6,28 @@ struct AudioListenerConfig {
   float cone_inner_angle = glm::radians(360.0f);
   float cone_outer_angle = glm::radians(360.0f);
   float cone_outer_gain = 0.0f;
+
+  bool operator==(const AudioListenerConfig& other) const = default;
 };
 
+/// Game side handle of a miniaudio listener, changes are pushed to the audio thread as AudioCommands.
+/// Keep it alive across frames, setters only push a command when the value changed.
 class AudioListener {
 public:
   AudioListener() = default;
 
-  void set_config(const AudioListenerConfig& config) const;
-  void set_position(const Vec3& position) const;
-  void set_direction(const Vec3& forward) const;
-  void set_velocity(const Vec3& velocity) const;
+  void set_config(const AudioListenerConfig& config);
+  void set_position(const Vec3& position);
+  void set_direction(const Vec3& forward);
+  void set_velocity(const Vec3& velocity);
 
 private:
   uint32_t m_ListenerIndex = 0;
+
+  // Matches miniaudio's listener defaults
+  AudioListenerConfig m_config = {};
+  Vec3 m_position = Vec3(0.0f);
+  Vec3 m_direction = Vec3(0.0f, 0.0f, -1.0f);
+  Vec3 m_velocity = Vec3(0.0f);
 };
 }
@@ -1,154 +1,165 @@
 #include "AudioSource.hpp"
 
-#include <miniaudio.h>
-
+#include "AudioClip.hpp"
+#include "AudioCommand.hpp"
 #include "AudioEngine.hpp"
+#include "AudioVoice.hpp"
 
-#include "Core/App.hpp"
+#include "Assets/AssetManager.hpp"
 
-#include "Utils/Log.hpp"
+#include "Core/App.hpp"
 
 namespace ox {
-AudioSource::AudioSource(const std::string& filepath) : m_path(filepath) {
-  m_sound = create_unique<ma_sound>();
+static void push_voice_command(AudioVoice* voice, const AudioCommand::Type type) {
+  App::get_system<AudioEngine>()->push_command(AudioCommand{.type = type, .time = AudioEngine::now(), .voice = voice});
+}
 
-  auto* engine = App::get_system<AudioEngine>()->get_engine();
-  const ma_result result = ma_sound_init_from_file(engine,
-                                                   filepath.c_str(),
-                                                   MA_SOUND_FLAG_NO_SPATIALIZATION,
-                                                   nullptr,
-                                                   nullptr,
-                                                   m_sound.get());
-  if (result != MA_SUCCESS)
-    OX_LOG_ERROR("Failed to load sound: {}", filepath);
+static void push_voice_vector(AudioVoice* voice, const AudioCommand::Type type, const Vec3& vector) {
+  App::get_system<AudioEngine>()->push_command(AudioCommand{.type = type, .time = AudioEngine::now(), .voice = voice, .vector = vector});
+}
+
+AudioSource::AudioSource(const std::string& filepath) : AudioSource(AssetManager::get_audio_clip(filepath)) {}
+
+AudioSource::AudioSource(Shared<AudioClip> clip) : m_clip(std::move(clip)) {
+  m_voice = new AudioVoice(m_clip);
+  push_voice_command(m_voice, AudioCommand::Type::AddVoice);
 }
 
 AudioSource::~AudioSource() {
-  ma_sound_uninit(m_sound.get());
-  m_sound = nullptr;
+  push_voice_command(m_voice, AudioCommand::Type::RemoveVoice);
+  m_voice = nullptr;
+}
+
+const char* AudioSource::get_path() const {
+  return m_clip->get_path().c_str();
+}
+
+void AudioSource::play() {
+  m_voice->m_playing.store(true, std::memory_order_relaxed);
+  push_voice_command(m_voice, AudioCommand::Type::Play);
 }
 
-void AudioSource::play() const {
-  ma_sound_seek_to_pcm_frame(m_sound.get(), 0);
-  ma_sound_start(m_sound.get());
+void AudioSource::play_delayed(const float delay) {
+  m_voice->add_pending_play();
+  App::get_system<AudioEngine>()->push_command(
+    AudioCommand{.type = AudioCommand::Type::Play, .time = AudioEngine::now() + glm::max(delay, 0.0f), .delayed = true, .voice = m_voice});
 }
 
-void AudioSource::pause() const {
-  ma_sound_stop(m_sound.get());
+void AudioSource::pause() {
+  push_voice_command(m_voice, AudioCommand::Type::Pause);
 }
 
-void AudioSource::un_pause() const {
-  ma_sound_start(m_sound.get());
+void AudioSource::un_pause() {
+  push_voice_command(m_voice, AudioCommand::Type::UnPause);
 }
 
-void AudioSource::stop() const {
-  ma_sound_stop(m_sound.get());
-  ma_sound_seek_to_pcm_frame(m_sound.get(), 0);
+void AudioSource::stop() {
+  push_voice_command(m_voice, AudioCommand::Type::Stop);
 }
 
 bool AudioSource::is_playing() const {
-  return ma_sound_is_playing(m_sound.get());
+  return m_voice->is_playing();
 }
 
-static ma_attenuation_model GetAttenuationModel(const AttenuationModelType model) {
-  switch (model) {
-    case AttenuationModelType::None: return ma_attenuation_model_none;
-    case AttenuationModelType::Inverse: return ma_attenuation_model_inverse;
-    case AttenuationModelType::Linear: return ma_attenuation_model_linear;
-    case AttenuationModelType::Exponential: return ma_attenuation_model_exponential;
-  }
+bool AudioSource::is_virtual() const {
+  return m_voice->is_virtual();
+}
 
-  return ma_attenuation_model_none;
+void AudioSource::push_config() const {
+  App::get_system<AudioEngine>()->push_command(
+    AudioCommand{.type = AudioCommand::Type::SetConfig, .time = AudioEngine::now(), .voice = m_voice, .config = m_config});
 }
 
 void AudioSource::set_config(const AudioSourceConfig& config) {
-  ma_sound* sound = m_sound.get();
-  ma_sound_set_volume(sound, config.volume_multiplier);
-  ma_sound_set_pitch(sound, config.pitch_multiplier);
-  ma_sound_set_looping(sound, config.looping);
+  if (config == m_config)
+    return;
 
-  if (m_spatialization != config.spatialization) {
-    m_spatialization = config.spatialization;
-    ma_sound_set_spatialization_enabled(sound, config.spatialization);
-  }
+  m_config = config;
+  push_config();
+}
 
-  if (config.spatialization) {
-    ma_sound_set_attenuation_model(sound, GetAttenuationModel(config.attenuation_model));
-    ma_sound_set_rolloff(sound, config.roll_off);
-    ma_sound_set_min_gain(sound, config.min_gain);
-    ma_sound_set_max_gain(sound, config.max_gain);
-    ma_sound_set_min_distance(sound, config.min_distance);
-    ma_sound_set_max_distance(sound, config.max_distance);
+#define SET_CONFIG_FIELD(field, value) \
+  if (m_config.field == (value))       \
+    return;                            \
+  m_config.field = (value);            \
+  push_config()
 
-    ma_sound_set_cone(sound, config.cone_inner_angle, config.cone_outer_angle, config.cone_outer_gain);
-    ma_sound_set_doppler_factor(sound, glm::max(config.doppler_factor, 0.0f));
-  }
-  else {
-    ma_sound_set_attenuation_model(sound, ma_attenuation_model_none);
-  }
+void AudioSource::set_volume(const float volume) {
+  SET_CONFIG_FIELD(volume_multiplier, volume);
 }
 
-void AudioSource::set_volume(float volume) const {
-  ma_sound_set_volume(m_sound.get(), volume);
+void AudioSource::set_pitch(const float pitch) {
+  SET_CONFIG_FIELD(pitch_multiplier, pitch);
 }
 
-void AudioSource::set_pitch(float pitch) const {
-  ma_sound_set_pitch(m_sound.get(), pitch);
+void AudioSource::set_looping(const bool state) {
+  SET_CONFIG_FIELD(looping, state);
 }
 
-void AudioSource::set_looping(const bool state) const {
-  ma_sound_set_looping(m_sound.get(), state);
+void AudioSource::set_spatialization(const bool state) {
+  SET_CONFIG_FIELD(spatialization, state);
 }
 
-void AudioSource::set_spatialization(const bool state) {
-  m_spatialization = state;
-  ma_sound_set_spatialization_enabled(m_sound.get(), state);
+void AudioSource::set_attenuation_model(const AttenuationModelType type) {
+  SET_CONFIG_FIELD(attenuation_model, type);
 }
 
-void AudioSource::set_attenuation_model(const AttenuationModelType type) const {
-  if (m_spatialization)
-    ma_sound_set_attenuation_model(m_sound.get(), GetAttenuationModel(type));
-  else
-    ma_sound_set_attenuation_model(m_sound.get(), GetAttenuationModel(AttenuationModelType::None));
+void AudioSource::set_roll_off(const float rollOff) {
+  SET_CONFIG_FIELD(roll_off, rollOff);
 }
 
-void AudioSource::set_roll_off(const float rollOff) const {
-  ma_sound_set_rolloff(m_sound.get(), rollOff);
+void AudioSource::set_min_gain(const float minGain) {
+  SET_CONFIG_FIELD(min_gain, minGain);
 }
 
-void AudioSource::set_min_gain(const float minGain) const {
-  ma_sound_set_min_gain(m_sound.get(), minGain);
+void AudioSource::set_max_gain(const float maxGain) {
+  SET_CONFIG_FIELD(max_gain, maxGain);
 }
 
-void AudioSource::set_max_gain(const float maxGain) const {
-  ma_sound_set_max_gain(m_sound.get(), maxGain);
+void AudioSource::set_min_distance(const float minDistance) {
+  SET_CONFIG_FIELD(min_distance, minDistance);
 }
 
-void AudioSource::set_min_distance(const float minDistance) const {
-  ma_sound_set_min_distance(m_sound.get(), minDistance);
+void AudioSource::set_max_distance(const float maxDistance) {
+  SET_CONFIG_FIELD(max_distance, maxDistance);
 }
 
-void AudioSource::set_max_distance(const float maxDistance) const {
-  ma_sound_set_max_distance(m_sound.get(), maxDistance);
+void AudioSource::set_cone(const float innerAngle, const float outerAngle, const float outerGain) {
+  AudioSourceConfig config = m_config;
+  config.cone_inner_angle = innerAngle;
+  config.cone_outer_angle = outerAngle;
+  config.cone_outer_gain = outerGain;
+  set_config(config);
 }
 
-void AudioSource::set_cone(const float innerAngle, const float outerAngle, const float outerGain) const {
-  ma_sound_set_cone(m_sound.get(), innerAngle, outerAngle, outerGain);
+void AudioSource::set_doppler_factor(const float factor) {
+  SET_CONFIG_FIELD(doppler_factor, factor);
 }
 
-void AudioSource::set_doppler_factor(const float factor) const {
-  ma_sound_set_doppler_factor(m_sound.get(), glm::max(factor, 0.0f));
+void AudioSource::set_priority(const int priority) {
+  SET_CONFIG_FIELD(priority, priority);
 }
 
-void AudioSource::set_position(const glm::vec3& position) const {
-  ma_sound_set_position(m_sound.get(), position.x, position.y, position.z);
+#undef SET_CONFIG_FIELD
+
+void AudioSource::set_position(const Vec3& position) {
+  if (position == m_position)
+    return;
+  m_position = position;
+  push_voice_vector(m_voice, AudioCommand::Type::SetPosition, position);
 }
 
-void AudioSource::set_direction(const glm::vec3& forward) const {
-  ma_sound_set_direction(m_sound.get(), forward.x, forward.y, forward.z);
+void AudioSource::set_direction(const Vec3& forward) {
+  if (forward == m_direction)
+    return;
+  m_direction = forward;
+  push_voice_vector(m_voice, AudioCommand::Type::SetDirection, forward);
 }
 
-void AudioSource::set_velocity(const glm::vec3& velocity) const {
-  ma_sound_set_velocity(m_sound.get(), velocity.x, velocity.y, velocity.z);
+void AudioSource::set_velocity(const Vec3& velocity) {
+  if (velocity == m_velocity)
+    return;
+  m_velocity = velocity;
+  push_voice_vector(m_voice, AudioCommand::Type::SetVelocity, velocity);
 }
 }
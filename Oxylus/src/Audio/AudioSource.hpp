@@ -8,6 +8,9 @@
 struct ma_sound;
 
 namespace ox {
+class AudioClip;
+class AudioVoice;
+
 enum class AttenuationModelType {
   None = 0,
   Inverse,
@@ -34,42 +37,65 @@ struct AudioSourceConfig {
   float cone_outer_gain = 0.0f;
 
   float doppler_factor = 1.0f;
+
+  int priority = 128; // Higher priority voices keep playing when the voice budget is full
+
+  bool operator==(const AudioSourceConfig& other) const = default;
 };
 
+/// Game side handle of a voice playing an AudioClip. Voices are cheap, the clip data is shared between all voices of the same file.
+/// Every call is turned into an AudioCommand for the audio thread, nothing here touches miniaudio.
+/// Setters only push a command when the value actually changed.
 class AudioSource {
 public:
   explicit AudioSource(const std::string& filepath);
+  explicit AudioSource(Shared<AudioClip> clip);
   ~AudioSource();
   AudioSource(const AudioSource& other) = delete;
   AudioSource(AudioSource&& other) = delete;
 
-  const char* get_path() const { return m_path.c_str(); }
+  const char* get_path() const;
+  const Shared<AudioClip>& get_clip() const { return m_clip; }
 
-  void play() const;
-  void pause() const;
-  void un_pause() const;
-  void stop() const;
+  void play();
+  /// Starts playing delay seconds from now, independent of the frame rate.
+  void play_delayed(float delay);
+  void pause();
+  void un_pause();
+  void stop();
+  /// True while playing, even if the voice is currently virtual.
   bool is_playing() const;
+  /// True while the AudioVoiceManager keeps the voice out of the mixer.
+  bool is_virtual() const;
+  const AudioSourceConfig& get_config() const { return m_config; }
   void set_config(const AudioSourceConfig& config);
-  void set_volume(float volume) const;
-  void set_pitch(float pitch) const;
-  void set_looping(bool state) const;
+  void set_volume(float volume);
+  void set_pitch(float pitch);
+  void set_looping(bool state);
   void set_spatialization(bool state);
-  void set_attenuation_model(AttenuationModelType type) const;
-  void set_roll_off(float rollOff) const;
-  void set_min_gain(float minGain) const;
-  void set_max_gain(float maxGain) const;
-  void set_min_distance(float minDistance) const;
-  void set_max_distance(float maxDistance) const;
-  void set_cone(float innerAngle, float outerAngle, float outerGain) const;
-  void set_doppler_factor(float factor) const;
-  void set_position(const Vec3& position) const;
-  void set_direction(const Vec3& forward) const;
-  void set_velocity(const Vec3& velocity) const;
+  void set_attenuation_model(AttenuationModelType type);
+  void set_roll_off(float rollOff);
+  void set_min_gain(float minGain);
+  void set_max_gain(float maxGain);
+  void set_min_distance(float minDistance);
+  void set_max_distance(float maxDistance);
+  void set_cone(float innerAngle, float outerAngle, float outerGain);
+  void set_doppler_factor(float factor);
+  void set_priority(int priority);
+  void set_position(const Vec3& position);
+  void set_direction(const Vec3& forward);
+  void set_velocity(const Vec3& velocity);
+
+  const Vec3& get_position() const { return m_position; }
 
 private:
-  std::string m_path;
-  Unique<ma_sound> m_sound;
-  bool m_spatialization = false;
+  Shared<AudioClip> m_clip;
+  AudioVoice* m_voice = nullptr; // Handed over to the audio thread on destruction
+  AudioSourceConfig m_config = {};
+  Vec3 m_position = Vec3(0.0f);
+  Vec3 m_direction = Vec3(0.0f, 0.0f, -1.0f);
+  Vec3 m_velocity = Vec3(0.0f);
+
+  void push_config() const;
 };
 }
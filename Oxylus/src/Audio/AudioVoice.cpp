@@ -0,0 +1,185 @@
+#include "AudioVoice.hpp"
+
+#include <cmath>
+#include <miniaudio.h>
+
+#include "AudioClip.hpp"
+#include "AudioEngine.hpp"
+
+#include "Core/App.hpp"
+
+#include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+AudioVoice::AudioVoice(Shared<AudioClip> clip) : m_clip(std::move(clip)) {
+  m_sound = create_unique<ma_sound>();
+
+  auto* engine = App::get_system<AudioEngine>()->get_engine();
+  const ma_result result = ma_sound_init_from_file(engine,
+                                                   m_clip->get_path().c_str(),
+                                                   m_clip->get_sound_flags() | MA_SOUND_FLAG_NO_SPATIALIZATION,
+                                                   nullptr,
+                                                   nullptr,
+                                                   m_sound.get());
+  if (result != MA_SUCCESS) {
+    OX_LOG_ERROR("Failed to load sound: {}", m_clip->get_path());
+    m_sound = nullptr;
+    return;
+  }
+
+  apply_config();
+}
+
+AudioVoice::~AudioVoice() {
+  release();
+}
+
+void AudioVoice::release() {
+  if (!m_sound)
+    return;
+
+  ma_sound_uninit(m_sound.get());
+  m_sound = nullptr;
+  m_playing.store(false, std::memory_order_relaxed);
+}
+
+void AudioVoice::play() {
+  m_playing.store(true, std::memory_order_relaxed);
+  m_cursor = 0.0f;
+  if (!m_virtual) {
+    ma_sound_seek_to_pcm_frame(m_sound.get(), 0);
+    ma_sound_start(m_sound.get());
+  }
+}
+
+void AudioVoice::pause() {
+  m_playing.store(false, std::memory_order_relaxed);
+  if (!m_virtual)
+    ma_sound_stop(m_sound.get());
+}
+
+void AudioVoice::un_pause() {
+  m_playing.store(true, std::memory_order_relaxed);
+  if (!m_virtual)
+    ma_sound_start(m_sound.get());
+}
+
+void AudioVoice::stop() {
+  m_playing.store(false, std::memory_order_relaxed);
+  m_cursor = 0.0f;
+  if (!m_virtual) {
+    ma_sound_stop(m_sound.get());
+    ma_sound_seek_to_pcm_frame(m_sound.get(), 0);
+  }
+}
+
+static ma_attenuation_model GetAttenuationModel(const AttenuationModelType model) {
+  switch (model) {
+    case AttenuationModelType::None: return ma_attenuation_model_none;
+    case AttenuationModelType::Inverse: return ma_attenuation_model_inverse;
+    case AttenuationModelType::Linear: return ma_attenuation_model_linear;
+    case AttenuationModelType::Exponential: return ma_attenuation_model_exponential;
+  }
+
+  return ma_attenuation_model_none;
+}
+
+void AudioVoice::set_config(const AudioSourceConfig& config) {
+  if (config == m_config)
+    return;
+
+  m_config = config;
+  apply_config();
+}
+
+void AudioVoice::apply_config() const {
+  OX_SCOPED_ZONE;
+  ma_sound* sound = m_sound.get();
+  ma_sound_set_volume(sound, m_config.volume_multiplier);
+  ma_sound_set_pitch(sound, m_config.pitch_multiplier);
+  ma_sound_set_looping(sound, m_config.looping);
+  ma_sound_set_spatialization_enabled(sound, m_config.spatialization);
+
+  if (m_config.spatialization) {
+    ma_sound_set_attenuation_model(sound, GetAttenuationModel(m_config.attenuation_model));
+    ma_sound_set_rolloff(sound, m_config.roll_off);
+    ma_sound_set_min_gain(sound, m_config.min_gain);
+    ma_sound_set_max_gain(sound, m_config.max_gain);
+    ma_sound_set_min_distance(sound, m_config.min_distance);
+    ma_sound_set_max_distance(sound, m_config.max_distance);
+
+    ma_sound_set_cone(sound, m_config.cone_inner_angle, m_config.cone_outer_angle, m_config.cone_outer_gain);
+    ma_sound_set_doppler_factor(sound, glm::max(m_config.doppler_factor, 0.0f));
+  }
+  else {
+    ma_sound_set_attenuation_model(sound, ma_attenuation_model_none);
+  }
+}
+
+void AudioVoice::set_position(const Vec3& position) {
+  m_position = position;
+  ma_sound_set_position(m_sound.get(), position.x, position.y, position.z);
+}
+
+void AudioVoice::set_direction(const Vec3& forward) {
+  ma_sound_set_direction(m_sound.get(), forward.x, forward.y, forward.z);
+}
+
+void AudioVoice::set_velocity(const Vec3& velocity) const {
+  ma_sound_set_velocity(m_sound.get(), velocity.x, velocity.y, velocity.z);
+}
+
+float AudioVoice::get_cursor() const {
+  ma_uint64 frames = 0;
+  ma_uint32 sample_rate = 0;
+  ma_sound_get_cursor_in_pcm_frames(m_sound.get(), &frames);
+  ma_sound_get_data_format(m_sound.get(), nullptr, nullptr, &sample_rate, nullptr, 0);
+  return sample_rate > 0 ? (float)frames / (float)sample_rate : 0.0f;
+}
+
+void AudioVoice::make_virtual() {
+  if (m_virtual)
+    return;
+
+  m_cursor = get_cursor();
+  ma_sound_stop(m_sound.get());
+  m_virtual.store(true, std::memory_order_relaxed);
+}
+
+void AudioVoice::make_real() {
+  if (!m_virtual)
+    return;
+
+  ma_uint32 sample_rate = 0;
+  ma_sound_get_data_format(m_sound.get(), nullptr, nullptr, &sample_rate, nullptr, 0);
+  ma_sound_seek_to_pcm_frame(m_sound.get(), (ma_uint64)(m_cursor * (float)sample_rate));
+  if (m_playing.load(std::memory_order_relaxed))
+    ma_sound_start(m_sound.get());
+  m_virtual.store(false, std::memory_order_relaxed);
+}
+
+void AudioVoice::advance_virtual(const float delta_time) {
+  if (!m_virtual || !m_playing.load(std::memory_order_relaxed))
+    return;
+
+  m_cursor += delta_time * m_config.pitch_multiplier;
+
+  const float length = m_clip->get_length();
+  if (length <= 0.0f || m_cursor < length)
+    return;
+
+  if (m_config.looping) {
+    m_cursor = std::fmod(m_cursor, length);
+  }
+  else {
+    m_playing.store(false, std::memory_order_relaxed);
+    m_cursor = 0.0f;
+  }
+}
+
+void AudioVoice::update_finished() {
+  if (!m_virtual && m_playing.load(std::memory_order_relaxed) && !m_config.looping && ma_sound_at_end(m_sound.get()))
+    m_playing.store(false, std::memory_order_relaxed);
+}
+}
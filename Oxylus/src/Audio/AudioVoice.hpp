@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+
+#include "AudioSource.hpp"
+
+struct ma_sound;
+
+namespace ox {
+class AudioClip;
+
+/// Mixer side of an AudioSource.
+/// Created by the source on the game thread, after that only the audio thread touches it apart from the atomic state flags.
+class AudioVoice {
+public:
+  explicit AudioVoice(Shared<AudioClip> clip);
+  ~AudioVoice();
+  AudioVoice(const AudioVoice& other) = delete;
+  AudioVoice(AudioVoice&& other) = delete;
+
+  /// Uninitializes the sound, used when the engine shuts down before the source is destroyed.
+  void release();
+
+  void play();
+  void pause();
+  void un_pause();
+  void stop();
+  bool is_playing() const { return m_playing.load(std::memory_order_relaxed) || m_pending_plays.load(std::memory_order_relaxed) != 0; }
+  bool is_virtual() const { return m_virtual.load(std::memory_order_relaxed); }
+
+  /// Delayed plays that were queued but haven't started yet, is_playing() counts them.
+  /// AudioSource::play_delayed adds one, the audio thread removes it when the play runs or is cancelled.
+  void add_pending_play() { m_pending_plays.fetch_add(1, std::memory_order_relaxed); }
+  void remove_pending_play() { m_pending_plays.fetch_sub(1, std::memory_order_relaxed); }
+
+  const AudioSourceConfig& get_config() const { return m_config; }
+  void set_config(const AudioSourceConfig& config);
+  const Vec3& get_position() const { return m_position; }
+  void set_position(const Vec3& position);
+  void set_direction(const Vec3& forward);
+  void set_velocity(const Vec3& velocity) const;
+
+  // Driven by the AudioVoiceManager
+  void make_virtual();
+  void make_real();
+  /// Advances the cursor of a virtual voice, stops it when it reaches the end.
+  void advance_virtual(float delta_time);
+  /// Stops real voices that played to the end.
+  void update_finished();
+
+private:
+  Shared<AudioClip> m_clip;
+  Unique<ma_sound> m_sound;
+  AudioSourceConfig m_config = {};
+  Vec3 m_position = Vec3(0.0f);
+
+  // Written by the audio thread and read by the AudioSource on the game thread.
+  // AudioSource::play also sets m_playing right away so scripts see their own request before the command runs.
+  std::atomic<bool> m_playing = false;
+  std::atomic<bool> m_virtual = false;
+  std::atomic<uint32_t> m_pending_plays = 0;
+  float m_cursor = 0.0f; // Seconds, only tracked while virtual
+
+  void apply_config() const;
+  float get_cursor() const;
+
+  friend class AudioSource;
+};
+}
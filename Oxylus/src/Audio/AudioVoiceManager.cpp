@@ -0,0 +1,90 @@
+#include "AudioVoiceManager.hpp"
+
+#include <algorithm>
+
+#include "AudioVoice.hpp"
+
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+void AudioVoiceManager::add(AudioVoice* voice) {
+  voices.emplace_back(voice);
+}
+
+void AudioVoiceManager::remove(AudioVoice* voice) {
+  std::erase(voices, voice);
+}
+
+void AudioVoiceManager::release_all() {
+  for (auto* voice : voices)
+    voice->release();
+  voices.clear();
+}
+
+float AudioVoiceManager::get_audibility(const AudioVoice& voice, const Vec3& listener_position) {
+  const auto& config = voice.get_config();
+  if (!config.spatialization)
+    return config.volume_multiplier;
+
+  const float distance = glm::distance(voice.get_position(), listener_position);
+  if (distance > config.max_distance)
+    return 0.0f;
+
+  // Mirrors miniaudio's attenuation models, cones and doppler are ignored for the estimate.
+  const float min_distance = glm::max(config.min_distance, 0.0001f);
+  const float clamped = glm::clamp(distance, min_distance, glm::max(config.max_distance, min_distance));
+  float gain = 1.0f;
+  switch (config.attenuation_model) {
+    case AttenuationModelType::None: break;
+    case AttenuationModelType::Inverse: gain = min_distance / (min_distance + config.roll_off * (clamped - min_distance)); break;
+    case AttenuationModelType::Linear: {
+      const float range = config.max_distance - min_distance;
+      gain = range > 0.0f ? 1.0f - config.roll_off * (clamped - min_distance) / range : 1.0f;
+      break;
+    }
+    case AttenuationModelType::Exponential: gain = glm::pow(clamped / min_distance, -config.roll_off); break;
+  }
+
+  return config.volume_multiplier * glm::clamp(gain, config.min_gain, config.max_gain);
+}
+
+void AudioVoiceManager::update(const Vec3& listener_position, const float delta_time, const uint32_t max_real_voices) {
+  OX_SCOPED_ZONE;
+
+  candidates.clear();
+  for (auto* voice : voices) {
+    voice->update_finished();
+    if (!voice->is_playing())
+      continue;
+
+    const float audibility = get_audibility(*voice, listener_position);
+    if (audibility < MIN_AUDIBLE_GAIN) {
+      voice->make_virtual();
+      continue;
+    }
+
+    candidates.emplace_back(Candidate{voice, audibility});
+  }
+
+  const uint32_t real_count = glm::min((uint32_t)candidates.size(), max_real_voices);
+  std::partial_sort(candidates.begin(),
+                    candidates.begin() + real_count,
+                    candidates.end(),
+                    [](const Candidate& a, const Candidate& b) {
+    const int pa = a.voice->get_config().priority;
+    const int pb = b.voice->get_config().priority;
+    return pa != pb ? pa > pb : a.audibility > b.audibility;
+  });
+
+  // Virtualize the losers first so the mixer never goes over the budget for a frame.
+  for (uint32_t i = real_count; i < (uint32_t)candidates.size(); i++)
+    candidates[i].voice->make_virtual();
+  for (uint32_t i = 0; i < real_count; i++)
+    candidates[i].voice->make_real();
+
+  real_voice_count = real_count;
+
+  for (auto* voice : voices)
+    voice->advance_virtual(delta_time);
+}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+
+#include "Core/Types.hpp"
+
+namespace ox {
+class AudioVoice;
+
+/// Keeps the number of voices miniaudio mixes under a fixed budget.
+/// Every update the playing voices are ranked by priority and then by estimated audibility at the listener.
+/// The top ones stay real, the rest are stopped in the mixer and only advance their cursor so they resume in sync once they win a slot back.
+class AudioVoiceManager {
+public:
+  /// Voices estimated quieter than this are virtualized regardless of the budget.
+  static constexpr float MIN_AUDIBLE_GAIN = 0.001f;
+
+  AudioVoiceManager() = default;
+
+  void add(AudioVoice* voice);
+  void remove(AudioVoice* voice);
+  /// Uninitializes every voice's sound, the voices themselves stay alive until their sources are destroyed.
+  void release_all();
+
+  void update(const Vec3& listener_position, float delta_time, uint32_t max_real_voices);
+
+  uint32_t get_voice_count() const { return (uint32_t)voices.size(); }
+  uint32_t get_real_voice_count() const { return real_voice_count; }
+
+private:
+  struct Candidate {
+    AudioVoice* voice = nullptr;
+    float audibility = 0.0f;
+  };
+
+  std::vector<AudioVoice*> voices = {};
+  std::vector<Candidate> candidates = {};
+  uint32_t real_voice_count = 0;
+
+  static float get_audibility(const AudioVoice& voice, const Vec3& listener_position);
+};
+}
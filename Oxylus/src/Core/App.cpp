@@ -1,8 +1,10 @@
 #include "App.hpp"
 
+#include <algorithm>
 #include <filesystem>
 
 #include "FileSystem.hpp"
+#include "FrameAllocator.hpp"
 #include "Layer.hpp"
 #include "LayerStack.hpp"
 #include "Project.hpp"
@@ -22,9 +24,12 @@
 
 #include "UI/ImGuiLayer.hpp"
 
+#include "Utils/CVars.hpp"
 #include "Utils/FileDialogs.hpp"
+#include "Utils/FrameStats.hpp"
 #include "Utils/Profiler.hpp"
 #include "Utils/Random.hpp"
+#include "Utils/Timer.hpp"
 
 namespace ox {
 App* App::instance = nullptr;
@@ -61,20 +66,25 @@ App::App(AppSpec spec) : app_spec(std::move(spec)) {
 
   register_system<Random>();
   register_system<TaskScheduler>();
-  register_system<FileDialogs>();
+  if (!app_spec.headless)
+    register_system<FileDialogs>();
   register_system<AudioEngine>();
   register_system<LuaManager>();
   register_system<ModuleRegistry>();
   register_system<RendererConfig>();
 
-  Window::init_window(app_spec);
-  Window::set_dispatcher(&dispatcher);
-  Input::init();
-  Input::set_dispatcher_events(dispatcher);
+  if (!app_spec.headless) {
+    Window::init_window(app_spec);
+    Window::set_dispatcher(&dispatcher);
+    Input::init();
+    Input::set_dispatcher_events(dispatcher);
+  }
 
-  for (auto& [_, system] : system_registry) {
-    system->set_dispatcher(&dispatcher);
-    system->init();
+  init_systems();
+
+  if (app_spec.headless) {
+    imgui_layer = nullptr;
+    return;
   }
 
   VkContext::init();
@@ -102,46 +112,162 @@ App& App::push_overlay(Layer* layer) {
 }
 
 void App::run() {
+  CpuProfiler::set_thread_name("Main");
   while (is_running) {
+    CpuProfiler::begin_frame();
+    FrameStats::begin_frame();
+    FrameAllocator::begin_frame();
+    CVarSystem::get()->dispatch_changes();
     update_timestep();
 
     update_layers(timestep);
 
-    for (auto& [_, system] : system_registry)
-      system->update();
+    {
+      FrameStats::PhaseScope phase(FramePhase::Systems);
+      for (auto* system : ordered_systems)
+        system->update();
+    }
 
     update_renderer();
 
     Input::reset_pressed();
 
+    if (app_spec.headless) {
+      if (app_spec.frame_limit > 0 && ++frame_count >= app_spec.frame_limit)
+        close();
+      continue;
+    }
+
     Window::poll_events();
     while (VkContext::get()->suspend) {
       Window::wait_for_events();
     }
   }
 
+  shutdown();
+}
+
+void App::init_systems() {
+  OX_SCOPED_ZONE;
+  const Timer timer = {};
+
+  for (auto* system : ordered_systems)
+    system->set_dispatcher(&dispatcher);
+
+  std::vector<uint8_t> initialized(systems.size(), 0);
+  std::vector<uint32_t> pending = system_order;
+  std::vector<uint32_t> order = {};
+  order.reserve(pending.size());
+
+  // The scheduler runs everyone else's init, so it goes first on its own.
+  auto* task_scheduler = get_system<TaskScheduler>();
+  if (task_scheduler) {
+    const uint32_t index = SystemTypeIndex::get<TaskScheduler>();
+    task_scheduler->init();
+    initialized[index] = 1;
+    order.emplace_back(index);
+    std::erase(pending, index);
+  }
+
+  const auto is_done = [&](const uint32_t dependency) {
+    // Dependencies that aren't registered (e.g. FileDialogs in headless apps) don't hold anything up.
+    return dependency >= systems.size() || !systems[dependency].system || initialized[dependency];
+  };
+
+  // Every wave initializes the systems whose dependencies are done, main thread ones here and the rest on the workers.
+  std::vector<uint32_t> ready = {};
+  std::vector<uint32_t> parallel = {};
+  while (!pending.empty()) {
+    ready.clear();
+    parallel.clear();
+    for (const uint32_t index : pending) {
+      if (std::ranges::all_of(systems[index].dependencies, is_done))
+        ready.emplace_back(index);
+    }
+
+    if (ready.empty()) {
+      for (const uint32_t index : pending)
+        OX_LOG_ERROR("{} is part of a dependency cycle.", systems[index].name);
+      OX_LOG_ERROR("Initializing the remaining systems in registration order.");
+      ready = pending;
+    }
+
+    for (const uint32_t index : ready) {
+      if (!systems[index].init_on_main_thread && task_scheduler)
+        parallel.emplace_back(index);
+    }
+
+    enki::TaskSet task((uint32_t)parallel.size(), [this, &parallel](const enki::TaskSetPartition range, uint32_t) {
+      for (uint32_t i = range.start; i < range.end; ++i)
+        systems[parallel[i]].system->init();
+    });
+    if (!parallel.empty())
+      task_scheduler->get()->AddTaskSetToPipe(&task);
+
+    for (const uint32_t index : ready) {
+      if (systems[index].init_on_main_thread || !task_scheduler)
+        systems[index].system->init();
+    }
+
+    if (!parallel.empty())
+      task_scheduler->get()->WaitforTask(&task);
+
+    for (const uint32_t index : ready) {
+      initialized[index] = 1;
+      order.emplace_back(index);
+      std::erase(pending, index);
+    }
+  }
+
+  system_order = std::move(order);
+  ordered_systems.clear();
+  for (const uint32_t index : system_order)
+    ordered_systems.emplace_back(systems[index].system.get());
+
+  OX_LOG_INFO("Initialized {} systems in {:.2f}ms", ordered_systems.size(), timer.get_elapsed_ms());
+}
+
+void App::shutdown() {
   layer_stack.reset();
 
   if (Project::get_active())
     Project::get_active()->unload_module();
 
-  for (auto& [_, system] : system_registry)
-    system->deinit();
+  // Dependents go first.
+  for (auto it = ordered_systems.rbegin(); it != ordered_systems.rend(); ++it)
+    (*it)->deinit();
 
-  Renderer::deinit();
+  if (!app_spec.headless)
+    Renderer::deinit();
   ThreadManager::get()->wait_all_threads();
-  Window::close_window(Window::get_glfw_window());
+  FrameAllocator::release();
+  if (!app_spec.headless)
+    Window::close_window(Window::get_glfw_window());
 }
 
 void App::update_layers(const Timestep& ts) {
   OX_SCOPED_ZONE_N("LayersLoop");
+  FrameStats::PhaseScope phase(FramePhase::Layers);
   for (Layer* layer : *layer_stack.get())
     layer->on_update(ts);
 }
 
-void App::update_renderer() { Renderer::draw(VkContext::get(), imgui_layer, *layer_stack.get()); }
+void App::update_renderer() {
+  if (app_spec.headless)
+    Renderer::draw_headless();
+  else
+    Renderer::draw(VkContext::get(), imgui_layer, *layer_stack.get());
+}
 
 void App::update_timestep() {
+  if (app_spec.headless) {
+    if (app_spec.fixed_timestep > 0.0f)
+      timestep.on_update_fixed(app_spec.fixed_timestep * 1000.0);
+    else
+      timestep.on_update();
+    return;
+  }
+
   timestep.on_update();
 
   ImGuiIO& io = ImGui::GetIO();
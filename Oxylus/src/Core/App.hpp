@@ -1,7 +1,7 @@
 #pragma once
 #include <string>
-
-#include <ankerl/unordered_dense.h>
+#include <typeinfo>
+#include <vector>
 
 #include "Base.hpp"
 #include "ESystem.hpp"
@@ -32,11 +32,16 @@ struct AppSpec {
   std::string working_directory = {};
   std::string assets_path = "Resources";
   uint32_t device_index = 0;
+  /// Skips the window, Vulkan device, renderer and ImGui. Scenes get a NullRenderPipeline unless they are given one
+  /// that doesn't touch the GPU. Used for simulation servers, perf tests and profiling on machines without a GPU.
+  bool headless = false;
+  /// Headless only. Seconds every frame advances the timestep by, 0 uses the measured frame time.
+  float fixed_timestep = 0.0f;
+  /// Headless only. The app closes after this many frames, 0 runs until close() is called.
+  uint64_t frame_limit = 0;
   ApplicationCommandLineArgs command_line_args;
 };
 
-using SystemRegistry = ankerl::unordered_dense::map<size_t, Shared<ESystem>>;
-
 class App {
 public:
   App(AppSpec spec);
@@ -61,41 +66,51 @@ public:
   static std::string get_relative(const std::string& path);
   static std::string get_absolute(const std::string& path);
 
-  static SystemRegistry& get_system_registry() { return instance->system_registry; }
+  /// Registered systems in initialization order, dependencies before their dependents.
+  static const std::vector<ESystem*>& get_systems() { return instance->ordered_systems; }
 
+  /// Systems have to be registered before the app initializes them, see SystemDependencies.
   template <typename T, typename... Args>
   static void register_system(Args&&... args) {
-    auto typeName = typeid(T).hash_code();
-    OX_ASSERT(!instance->system_registry.contains(typeName), "Registering system more than once.");
-
-    Shared<T> system = create_shared<T>(std::forward<Args>(args)...);
-    instance->system_registry.emplace(typeName, std::move(system));
+    const uint32_t index = SystemTypeIndex::get<T>();
+    auto& systems = instance->systems;
+    if (systems.size() <= index)
+      systems.resize(index + 1);
+    OX_ASSERT(!systems[index].system, "Registering system more than once.");
+
+    auto& entry = systems[index];
+    entry.system = create_shared<T>(std::forward<Args>(args)...);
+    entry.name = typeid(T).name();
+    if constexpr (HasSystemDependencies<T>)
+      entry.dependencies = T::Dependencies::get_indices();
+    entry.init_on_main_thread = system_inits_on_main_thread<T>();
+
+    instance->system_order.emplace_back(index);
+    instance->ordered_systems.emplace_back(entry.system.get());
   }
 
   template <typename T>
   static void unregister_system() {
-    const auto typeName = typeid(T).hash_code();
-
-    if (instance->system_registry.contains(typeName)) {
-      instance->system_registry.erase(typeName);
-    }
+    const uint32_t index = SystemTypeIndex::get<T>();
+    auto& systems = instance->systems;
+    if (index >= systems.size() || !systems[index].system)
+      return;
+
+    std::erase(instance->system_order, index);
+    std::erase(instance->ordered_systems, systems[index].system.get());
+    systems[index] = {};
   }
 
   template <typename T>
   static T* get_system() {
-    const auto typeName = typeid(T).hash_code();
-
-    if (instance->system_registry.contains(typeName)) {
-      return dynamic_cast<T*>(instance->system_registry[typeName].get());
-    }
-
-    return nullptr;
+    const uint32_t index = SystemTypeIndex::get<T>();
+    const auto& systems = instance->systems;
+    return index < systems.size() ? static_cast<T*>(systems[index].system.get()) : nullptr;
   }
 
   template <typename T>
-  static T* has_system() {
-    const auto typeName = typeid(T).hash_code();
-    return instance->system_registry.contains(typeName);
+  static bool has_system() {
+    return get_system<T>() != nullptr;
   }
 
 private:
@@ -105,7 +120,16 @@ private:
   ImGuiLayer* imgui_layer;
   Shared<LayerStack> layer_stack;
 
-  SystemRegistry system_registry = {};
+  struct SystemEntry {
+    Shared<ESystem> system = nullptr;
+    const char* name = nullptr;
+    std::vector<uint32_t> dependencies = {}; // SystemTypeIndex of each
+    bool init_on_main_thread = false;
+  };
+
+  std::vector<SystemEntry> systems = {};      // Indexed by SystemTypeIndex, types that aren't registered have empty slots
+  std::vector<uint32_t> system_order = {};    // Registration order, initialization order after init_systems()
+  std::vector<ESystem*> ordered_systems = {}; // Same order as system_order
   EventDispatcher dispatcher;
 
   Shared<ThreadManager> thread_manager;
@@ -113,8 +137,11 @@ private:
 
   bool is_running = true;
   float last_frame_time = 0.0f;
+  uint64_t frame_count = 0;
 
   void run();
+  void init_systems();
+  void shutdown();
   void update_layers(const Timestep& ts);
   void update_renderer();
   void update_timestep();
@@ -1,9 +1,10 @@
 ﻿#pragma once
 
 #include <cstdint>
-#include <cstdlib>
 #include <cstring>
 
+#include "Memory.hpp"
+
 namespace ox {
 // Non-owning raw buffer
 struct Buffer {
@@ -12,8 +13,8 @@ struct Buffer {
 
   Buffer() = default;
 
-  Buffer(uint64_t size) {
-    Allocate(size);
+  Buffer(uint64_t size, MemoryTag tag = MemoryTag::General) {
+    Allocate(size, tag);
   }
 
   Buffer(const Buffer&) = default;
@@ -24,15 +25,15 @@ struct Buffer {
     return result;
   }
 
-  void Allocate(uint64_t size) {
+  void Allocate(uint64_t size, MemoryTag tag = MemoryTag::General) {
     Release();
 
-    Data = (uint8_t*)malloc(size);
+    Data = (uint8_t*)Memory::allocate(size, tag);
     Size = size;
   }
 
   void Release() {
-    free(Data);
+    Memory::free(Data);
     Data = nullptr;
     Size = 0;
   }
@@ -1,9 +1,43 @@
 ﻿#pragma once
+#include <atomic>
+#include <vector>
+
 #include "Base.hpp"
 
 #include "Event/Event.hpp"
 
 namespace ox {
+/// Dense index per system type, handed out the first time a type is registered or looked up.
+/// App keeps its systems in a flat array indexed by it, so get_system<T>() is a single load.
+class SystemTypeIndex {
+public:
+  template <typename T> static uint32_t get() {
+    static const uint32_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+  }
+
+private:
+  static inline std::atomic<uint32_t> next_index = 0;
+};
+
+/// Systems list what has to be initialized before them with `using Dependencies = SystemDependencies<A, B>;`.
+/// Systems whose dependencies are done initialize in parallel on the task scheduler and deinitialize in reverse order.
+template <typename... Systems> struct SystemDependencies {
+  static std::vector<uint32_t> get_indices() { return {SystemTypeIndex::get<Systems>()...}; }
+};
+
+template <typename T>
+concept HasSystemDependencies = requires { typename T::Dependencies; };
+
+/// Systems that have to initialize on the main thread (e.g. because of per-thread OS state) set
+/// `static constexpr bool INIT_ON_MAIN_THREAD = true;`.
+template <typename T> constexpr bool system_inits_on_main_thread() {
+  if constexpr (requires { T::INIT_ON_MAIN_THREAD; })
+    return T::INIT_ON_MAIN_THREAD;
+  else
+    return false;
+}
+
 /// Engine systems interface
 class ESystem {
 public:
@@ -12,5 +12,7 @@ int main(int argc, char** argv) {
 
   delete app;
 
+  ox::Log::shutdown();
+
   return 0;
 }
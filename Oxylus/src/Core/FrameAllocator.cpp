@@ -0,0 +1,90 @@
+#include "FrameAllocator.hpp"
+
+#include <array>
+#include <mutex>
+#include <new>
+
+#include "Base.hpp"
+
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+namespace {
+struct ThreadArenas {
+  std::array<LinearArena, FrameAllocator::FRAMES_IN_FLIGHT> arenas = {
+    LinearArena(FrameAllocator::BLOCK_SIZE, MemoryTag::Renderer),
+    LinearArena(FrameAllocator::BLOCK_SIZE, MemoryTag::Renderer),
+    LinearArena(FrameAllocator::BLOCK_SIZE, MemoryTag::Renderer),
+  };
+};
+static_assert(FrameAllocator::FRAMES_IN_FLIGHT == 3, "Update ThreadArenas");
+
+// Owned here and not by the thread_local so arenas of a thread that exited stay valid until their frame is over.
+std::mutex threads_mutex;
+std::vector<Unique<ThreadArenas>> threads = {};
+thread_local ThreadArenas* thread_arenas = nullptr;
+
+class FrameResource final : public std::pmr::memory_resource {
+protected:
+  void* do_allocate(const size_t bytes, const size_t alignment) override {
+    void* ptr = FrameAllocator::get().allocate(bytes, alignment);
+    if (!ptr)
+      throw std::bad_alloc();
+    return ptr;
+  }
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+};
+
+FrameResource frame_resource = {};
+}
+
+std::atomic<uint64_t> FrameAllocator::frame = 0;
+
+void FrameAllocator::begin_frame() {
+  OX_SCOPED_ZONE;
+  const uint64_t next = frame.load(std::memory_order_relaxed) + 1;
+  const size_t slot = next % FRAMES_IN_FLIGHT;
+
+  std::lock_guard lock(threads_mutex);
+  for (const auto& thread : threads)
+    thread->arenas[slot].reset();
+  frame.store(next, std::memory_order_relaxed);
+}
+
+void FrameAllocator::release() {
+  std::lock_guard lock(threads_mutex);
+  threads.clear();
+  thread_arenas = nullptr;
+}
+
+LinearArena& FrameAllocator::get() {
+  if (!thread_arenas) {
+    std::lock_guard lock(threads_mutex);
+    thread_arenas = threads.emplace_back(create_unique<ThreadArenas>()).get();
+  }
+  return thread_arenas->arenas[frame.load(std::memory_order_relaxed) % FRAMES_IN_FLIGHT];
+}
+
+std::pmr::memory_resource* FrameAllocator::get_resource() {
+  return &frame_resource;
+}
+
+size_t FrameAllocator::get_used() {
+  std::lock_guard lock(threads_mutex);
+  size_t used = 0;
+  for (const auto& thread : threads)
+    used += thread->arenas[get_frame() % FRAMES_IN_FLIGHT].get_used();
+  return used;
+}
+
+size_t FrameAllocator::get_capacity() {
+  std::lock_guard lock(threads_mutex);
+  size_t capacity = 0;
+  for (const auto& thread : threads) {
+    for (const auto& arena : thread->arenas)
+      capacity += arena.get_capacity();
+  }
+  return capacity;
+}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <memory_resource>
+#include <vector>
+
+#include "Memory.hpp"
+
+namespace ox {
+/// Per-thread bump allocators for data that only lives for a frame.
+/// Every thread gets one LinearArena per frame in flight. begin_frame() rotates to the next slot and resets it,
+/// so anything allocated is valid until FRAMES_IN_FLIGHT frames later. Frees are no-ops.
+/// begin_frame() runs on the main thread between frames, nothing may allocate from it concurrently.
+class FrameAllocator {
+public:
+  /// Same as the renderer's frames in flight, see VkContext.
+  static constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+  static constexpr size_t BLOCK_SIZE = 256 * 1024;
+
+  static void begin_frame();
+  /// Releases every thread's arenas, only at shutdown.
+  static void release();
+
+  /// The calling thread's arena for the current frame.
+  static LinearArena& get();
+  /// Allocates from the calling thread's arena, safe to hand to containers used from any thread.
+  static std::pmr::memory_resource* get_resource();
+
+  template <typename T> static T* allocate_array(size_t count) { return get().allocate_array<T>(count); }
+
+  static uint64_t get_frame() { return frame.load(std::memory_order_relaxed); }
+  /// Bytes used this frame by every thread.
+  static size_t get_used();
+  static size_t get_capacity();
+
+private:
+  static std::atomic<uint64_t> frame;
+};
+
+/// Vector backed by the frame allocator. Don't keep one across frames.
+template <typename T> using FrameVector = std::pmr::vector<T>;
+
+template <typename T> FrameVector<T> make_frame_vector(size_t size = 0) {
+  FrameVector<T> vector(FrameAllocator::get_resource());
+  vector.resize(size);
+  return vector;
+}
+}
@@ -1,4 +1,279 @@
 #include "Memory.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Utils/Log.hpp"
+
 namespace ox {
-}
\ No newline at end of file
+namespace {
+struct alignas(Memory::DEFAULT_ALIGNMENT) AllocationHeader {
+  uint64_t size = 0;
+  uint32_t alignment = 0;
+  MemoryTag tag = MemoryTag::General;
+};
+static_assert(sizeof(AllocationHeader) == Memory::DEFAULT_ALIGNMENT);
+
+struct TagCounters {
+  std::atomic<int64_t> live_bytes = 0;
+  std::atomic<int64_t> peak_bytes = 0;
+  std::atomic<int64_t> live_allocations = 0;
+  std::atomic<uint64_t> total_allocations = 0;
+};
+
+std::array<TagCounters, (size_t)MemoryTag::Count> counters = {};
+
+void track_allocation(const MemoryTag tag, const int64_t size) {
+  auto& c = counters[(size_t)tag];
+  const int64_t live = c.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  c.live_allocations.fetch_add(1, std::memory_order_relaxed);
+  c.total_allocations.fetch_add(1, std::memory_order_relaxed);
+
+  int64_t peak = c.peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !c.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void track_free(const MemoryTag tag, const int64_t size) {
+  auto& c = counters[(size_t)tag];
+  c.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+  c.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// The header sits right before the returned pointer. Over-aligned blocks pad the front by a whole alignment.
+AllocationHeader* get_header(void* ptr) { return static_cast<AllocationHeader*>(ptr) - 1; }
+
+class TrackingResource final : public std::pmr::memory_resource {
+public:
+  MemoryTag tag = MemoryTag::General;
+
+protected:
+  void* do_allocate(const size_t bytes, const size_t alignment) override {
+    void* ptr = Memory::allocate(bytes, tag, alignment);
+    if (!ptr)
+      throw std::bad_alloc();
+    return ptr;
+  }
+  void do_deallocate(void* ptr, size_t, size_t) override { Memory::free(ptr); }
+  bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+};
+
+std::array<TrackingResource, (size_t)MemoryTag::Count> resources = [] {
+  std::array<TrackingResource, (size_t)MemoryTag::Count> r = {};
+  for (size_t i = 0; i < r.size(); i++)
+    r[i].tag = (MemoryTag)i;
+  return r;
+}();
+}
+
+void* Memory::allocate(const size_t size, const MemoryTag tag, size_t alignment) {
+  alignment = std::max(alignment, DEFAULT_ALIGNMENT);
+
+  uint8_t* base = nullptr;
+  if (alignment == DEFAULT_ALIGNMENT)
+    base = static_cast<uint8_t*>(std::malloc(size + sizeof(AllocationHeader)));
+  else
+    base = static_cast<uint8_t*>(::operator new(size + alignment, std::align_val_t(alignment), std::nothrow));
+  if (!base)
+    return nullptr;
+
+  void* ptr = base + (alignment == DEFAULT_ALIGNMENT ? sizeof(AllocationHeader) : alignment);
+  *get_header(ptr) = {.size = size, .alignment = (uint32_t)alignment, .tag = tag};
+  track_allocation(tag, (int64_t)size);
+  return ptr;
+}
+
+void* Memory::reallocate(void* ptr, const size_t size, const MemoryTag tag) {
+  if (!ptr)
+    return allocate(size, tag);
+
+  const AllocationHeader header = *get_header(ptr);
+  if (header.alignment != DEFAULT_ALIGNMENT) {
+    void* new_ptr = allocate(size, header.tag, header.alignment);
+    if (new_ptr) {
+      std::memcpy(new_ptr, ptr, std::min<size_t>(size, header.size));
+      free(ptr);
+    }
+    return new_ptr;
+  }
+
+  void* base = std::realloc(get_header(ptr), size + sizeof(AllocationHeader));
+  if (!base)
+    return nullptr;
+
+  void* new_ptr = static_cast<AllocationHeader*>(base) + 1;
+  get_header(new_ptr)->size = size;
+  track_free(header.tag, (int64_t)header.size);
+  track_allocation(header.tag, (int64_t)size);
+  return new_ptr;
+}
+
+void Memory::free(void* ptr) {
+  if (!ptr)
+    return;
+
+  auto* header = get_header(ptr);
+  track_free(header->tag, (int64_t)header->size);
+  if (header->alignment == DEFAULT_ALIGNMENT)
+    std::free(header);
+  else
+    ::operator delete(static_cast<uint8_t*>(ptr) - header->alignment, std::align_val_t(header->alignment));
+}
+
+MemoryStats Memory::get_stats(const MemoryTag tag) {
+  const auto& c = counters[(size_t)tag];
+  return {
+    .live_bytes = c.live_bytes.load(std::memory_order_relaxed),
+    .peak_bytes = c.peak_bytes.load(std::memory_order_relaxed),
+    .live_allocations = c.live_allocations.load(std::memory_order_relaxed),
+    .total_allocations = c.total_allocations.load(std::memory_order_relaxed),
+  };
+}
+
+MemoryStats Memory::get_total_stats() {
+  MemoryStats total = {};
+  for (size_t i = 0; i < (size_t)MemoryTag::Count; i++) {
+    const auto stats = get_stats((MemoryTag)i);
+    total.live_bytes += stats.live_bytes;
+    total.peak_bytes += stats.peak_bytes; // Sum of the per-tag peaks, an upper bound of the real one
+    total.live_allocations += stats.live_allocations;
+    total.total_allocations += stats.total_allocations;
+  }
+  return total;
+}
+
+void Memory::reset_peak(const MemoryTag tag) {
+  auto& c = counters[(size_t)tag];
+  c.peak_bytes.store(c.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+const char* Memory::get_tag_name(const MemoryTag tag) {
+  switch (tag) {
+    case MemoryTag::General  : return "General";
+    case MemoryTag::Renderer : return "Renderer";
+    case MemoryTag::Assets   : return "Assets";
+    case MemoryTag::Physics  : return "Physics";
+    case MemoryTag::Scripting: return "Scripting";
+    case MemoryTag::ECS      : return "ECS";
+    case MemoryTag::Audio    : return "Audio";
+    case MemoryTag::Count    : break;
+  }
+  return "Unknown";
+}
+
+std::pmr::memory_resource* Memory::get_resource(const MemoryTag tag) {
+  return &resources[(size_t)tag];
+}
+
+LinearArena::LinearArena(const size_t block_size, const MemoryTag tag) : block_size(block_size), tag(tag) {}
+
+LinearArena::~LinearArena() {
+  for (const auto& block : blocks)
+    Memory::free(block.data);
+}
+
+void* LinearArena::allocate(const size_t size, const size_t alignment) {
+  while (current < blocks.size()) {
+    auto& block = blocks[current];
+    const uintptr_t address = (uintptr_t)block.data + block.offset;
+    const size_t padding = (alignment - address % alignment) % alignment;
+    if (block.offset + padding + size <= block.size) {
+      block.offset += padding + size;
+      used += padding + size;
+      return block.data + block.offset - size;
+    }
+    current++;
+  }
+
+  // Nothing left that fits, oversized requests get a block of their own.
+  const size_t size_with_alignment = size + alignment;
+  const size_t new_block_size = std::max(block_size, size_with_alignment);
+  auto& block = blocks.emplace_back(Block{.data = static_cast<uint8_t*>(Memory::allocate(new_block_size, tag)), .size = new_block_size});
+  if (!block.data) {
+    OX_LOG_ERROR("LinearArena couldn't allocate a block of {} bytes", new_block_size);
+    blocks.pop_back();
+    return nullptr;
+  }
+  capacity += new_block_size;
+  current = blocks.size() - 1;
+  return allocate(size, alignment);
+}
+
+void LinearArena::reset() {
+  for (auto& block : blocks)
+    block.offset = 0;
+  current = 0;
+  used = 0;
+}
+
+void LinearArena::shrink() {
+  reset();
+  for (size_t i = 1; i < blocks.size(); i++) {
+    capacity -= blocks[i].size;
+    Memory::free(blocks[i].data);
+  }
+  if (blocks.size() > 1)
+    blocks.resize(1);
+}
+
+PoolAllocator::PoolAllocator(const size_t block_size, const size_t blocks_per_chunk, const MemoryTag tag)
+  : block_size(std::max(block_size, sizeof(FreeBlock))), blocks_per_chunk(blocks_per_chunk), tag(tag) {
+  // Keep every block aligned like the chunk itself.
+  this->block_size = (this->block_size + Memory::DEFAULT_ALIGNMENT - 1) & ~(Memory::DEFAULT_ALIGNMENT - 1);
+}
+
+PoolAllocator::~PoolAllocator() {
+  if (live_blocks > 0)
+    OX_LOG_WARN("PoolAllocator destroyed with {} live blocks", live_blocks);
+  for (void* chunk : chunks)
+    Memory::free(chunk);
+}
+
+void PoolAllocator::add_chunk() {
+  auto* chunk = static_cast<uint8_t*>(Memory::allocate(block_size * blocks_per_chunk, tag));
+  if (!chunk)
+    return;
+  chunks.emplace_back(chunk);
+
+  // Link back to front so blocks are handed out in address order.
+  for (size_t i = blocks_per_chunk; i-- > 0;) {
+    auto* block = reinterpret_cast<FreeBlock*>(chunk + i * block_size);
+    block->next = free_list;
+    free_list = block;
+  }
+}
+
+void* PoolAllocator::allocate() {
+  if (!free_list)
+    add_chunk();
+  if (!free_list)
+    return nullptr;
+
+  FreeBlock* block = free_list;
+  free_list = block->next;
+  live_blocks++;
+  return block;
+}
+
+void PoolAllocator::free(void* ptr) {
+  if (!ptr)
+    return;
+
+  auto* block = static_cast<FreeBlock*>(ptr);
+  block->next = free_list;
+  free_list = block;
+  live_blocks--;
+}
+
+void* PoolAllocator::do_allocate(const size_t bytes, const size_t alignment) {
+  if (bytes > block_size || alignment > Memory::DEFAULT_ALIGNMENT)
+    throw std::bad_alloc();
+  void* ptr = allocate();
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+}
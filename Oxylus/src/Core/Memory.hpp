@@ -1,5 +1,124 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
 
 namespace ox {
-}
+/// Subsystem an allocation is accounted to.
+enum class MemoryTag : uint8_t {
+  General = 0,
+  Renderer,
+  Assets,
+  Physics,
+  Scripting,
+  ECS,
+  Audio,
+
+  Count
+};
+
+struct MemoryStats {
+  int64_t live_bytes = 0;
+  int64_t peak_bytes = 0;
+  int64_t live_allocations = 0;
+  uint64_t total_allocations = 0;
+};
+
+/// Tracking allocator every engine allocation that opts in goes through. Thread-safe, the counters are atomics.
+/// Each block has a small header with its size and tag, so frees don't need to know either.
+class Memory {
+public:
+  static constexpr size_t DEFAULT_ALIGNMENT = 16;
+
+  static void* allocate(size_t size, MemoryTag tag = MemoryTag::General, size_t alignment = DEFAULT_ALIGNMENT);
+  /// Blocks with DEFAULT_ALIGNMENT are grown in place when the system allocator can.
+  static void* reallocate(void* ptr, size_t size, MemoryTag tag = MemoryTag::General);
+  static void free(void* ptr);
+
+  static MemoryStats get_stats(MemoryTag tag);
+  static MemoryStats get_total_stats();
+  static void reset_peak(MemoryTag tag);
+  static const char* get_tag_name(MemoryTag tag);
+
+  /// std::pmr adapter over allocate/free, lets containers opt in: `std::pmr::vector<T> v(Memory::get_resource(MemoryTag::Renderer));`
+  static std::pmr::memory_resource* get_resource(MemoryTag tag);
+};
+
+/// Bump allocator over a list of blocks, individual frees are no-ops and reset() makes the whole arena reusable.
+/// Blocks are kept across resets, after warming up an arena doesn't allocate anymore. Not thread-safe.
+class LinearArena : public std::pmr::memory_resource {
+public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  explicit LinearArena(size_t block_size = DEFAULT_BLOCK_SIZE, MemoryTag tag = MemoryTag::General);
+  ~LinearArena() override;
+  LinearArena(const LinearArena& other) = delete;
+  LinearArena& operator=(const LinearArena& other) = delete;
+
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+  template <typename T> T* allocate_array(size_t count) { return static_cast<T*>(allocate(sizeof(T) * count, alignof(T))); }
+
+  void reset();
+  /// Frees every block but the first, for arenas that spiked once.
+  void shrink();
 
+  size_t get_used() const { return used; }
+  size_t get_capacity() const { return capacity; }
+
+protected:
+  void* do_allocate(size_t bytes, size_t alignment) override { return allocate(bytes, alignment); }
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+  struct Block {
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+  };
+
+  std::vector<Block> blocks = {};
+  size_t current = 0; // Index of the block being bumped
+  size_t block_size = 0;
+  size_t used = 0;
+  size_t capacity = 0;
+  MemoryTag tag = MemoryTag::General;
+};
+
+/// Fixed-size blocks carved out of larger chunks, freed blocks go on an intrusive free list. Not thread-safe.
+/// As a memory_resource it only serves requests that fit a block, anything bigger is a bug in the caller.
+class PoolAllocator : public std::pmr::memory_resource {
+public:
+  PoolAllocator(size_t block_size, size_t blocks_per_chunk, MemoryTag tag = MemoryTag::General);
+  ~PoolAllocator() override;
+  PoolAllocator(const PoolAllocator& other) = delete;
+  PoolAllocator& operator=(const PoolAllocator& other) = delete;
+
+  void* allocate();
+  void free(void* ptr);
+
+  size_t get_block_size() const { return block_size; }
+  size_t get_live_blocks() const { return live_blocks; }
+  size_t get_capacity() const { return chunks.size() * blocks_per_chunk; }
+
+protected:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* ptr, size_t, size_t) override { free(ptr); }
+  bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+  struct FreeBlock {
+    FreeBlock* next = nullptr;
+  };
+
+  std::vector<void*> chunks = {};
+  FreeBlock* free_list = nullptr;
+  size_t block_size = 0;
+  size_t blocks_per_chunk = 0;
+  size_t live_blocks = 0;
+  MemoryTag tag = MemoryTag::General;
+
+  void add_chunk();
+};
+}
@@ -3,13 +3,11 @@
 #include "Utils/Timestep.hpp"
 #include "Event/Event.hpp"
 
-#include <string>
+#include <entt/entity/entity.hpp>
 
-namespace JPH {
-class ContactSettings;
-class ContactManifold;
-class Body;
-}
+#include "Core/Types.hpp"
+
+#include <string>
 
 namespace ox {
 class Scene;
@@ -50,8 +48,12 @@ public:
   virtual void on_shutdown() { }
 
   /// Physics interfaces
-  virtual void on_contact_added(Scene* scene, const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold& manifold, const JPH::ContactSettings& settings) { }
-  virtual void on_contact_persisted(Scene* scene, const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold& manifold, const JPH::ContactSettings& settings) { }
+  /// Called on the game thread after the physics step that found the contact. Position and normal are in world space,
+  /// the normal points from body1 towards body2.
+  virtual void on_contact_added(Scene* scene, entt::entity body1, entt::entity body2, const Vec3& position, const Vec3& normal) { }
+  virtual void on_contact_persisted(Scene* scene, entt::entity body1, entt::entity body2, const Vec3& position, const Vec3& normal) { }
+  /// Called on the game thread when a character controller starts touching a body.
+  virtual void on_character_contact(Scene* scene, entt::entity character, entt::entity other, const Vec3& position, const Vec3& normal) { }
 
   void set_dispatcher(EventDispatcher* dispatcher) { m_dispatcher = dispatcher; }
 
@@ -3,9 +3,10 @@
 #include <random>
 
 namespace ox {
-static std::random_device s_RandomDevice;
-static std::mt19937_64 s_Engine(s_RandomDevice());
-static std::uniform_int_distribution<uint64_t> s_UniformDistribution;
+// Not the engine's seeded generators, ids have to stay unique across runs that share a seed.
+// Thread local since entities and assets are created from worker threads.
+static thread_local std::mt19937_64 s_Engine(std::random_device{}());
+static thread_local std::uniform_int_distribution<uint64_t> s_UniformDistribution;
 
 UUID::UUID() : _uuid(s_UniformDistribution(s_Engine)) { }
 
@@ -42,10 +42,13 @@ Module* ModuleRegistry::get_lib(const std::string& name) {
 }
 
 void ModuleRegistry::clear() {
-  for (auto&& [name, module] : libs) {
+  for (auto&& [name, module] : libs)
     delete module->interface;
+
+  // Queued log records point at format strings and formatters in the module's code, they have to be written before it's unloaded.
+  Log::flush();
+  for (auto&& [name, module] : libs)
     module->lib.reset();
-  }
   libs.clear();
 }
 }
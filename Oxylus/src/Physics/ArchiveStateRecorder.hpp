@@ -0,0 +1,31 @@
+#pragma once
+#include <cstring>
+
+#include "Jolt/Jolt.h"
+#include "Jolt/Physics/StateRecorder.h"
+
+#include "Utils/Archive.hpp"
+
+namespace ox {
+/// Streams Jolt's SaveState/RestoreState data straight into an engine Archive.
+/// Reading past the end of the archive fails the recorder instead of reading out of bounds, Jolt's restore then returns false.
+class ArchiveStateRecorder final : public JPH::StateRecorder {
+public:
+  explicit ArchiveStateRecorder(Archive& archive) : archive(archive) {}
+
+  void WriteBytes(const void* inData, size_t inNumBytes) override { archive.write_bytes(inData, inNumBytes); }
+  void ReadBytes(void* outData, size_t inNumBytes) override {
+    if (failed)
+      std::memset(outData, 0, inNumBytes);
+    else if (!archive.read_bytes(outData, inNumBytes))
+      failed = true;
+  }
+
+  bool IsEOF() const override { return !archive.can_read(1); }
+  bool IsFailed() const override { return failed; }
+
+private:
+  Archive& archive;
+  bool failed = false;
+};
+}
@@ -0,0 +1,196 @@
+#include "CharacterUpdater.hpp"
+
+#include <algorithm>
+
+#include "ArchiveStateRecorder.hpp"
+#include "JoltJobSystem.hpp"
+#include "Physics.hpp"
+
+#include "Core/App.hpp"
+
+#include "Jolt/Physics/Character/CharacterVirtual.h"
+
+#include "Thread/TaskScheduler.hpp"
+
+#include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+CharacterUpdater::CharacterUpdater() {
+  const uint32_t thread_count = App::get_system<TaskScheduler>()->get()->GetNumTaskThreads();
+  temp_allocators.reserve(thread_count);
+  for (uint32_t i = 0; i < thread_count; i++)
+    temp_allocators.emplace_back(create_unique<JoltTempAllocator>(TEMP_ALLOCATOR_SIZE));
+}
+
+CharacterUpdater::~CharacterUpdater() = default;
+
+void CharacterUpdater::add(entt::entity entity, const Shared<JPH::CharacterVirtual>& character, const CharacterControllerSettings& settings) {
+  const uint32_t key = static_cast<uint32_t>(entity);
+  if (entity_to_index.contains(key))
+    remove(entity);
+
+  entity_to_index.emplace(key, (uint32_t)characters.size());
+  characters.emplace_back(Entry{.entity = entity, .character = character, .settings = settings});
+}
+
+void CharacterUpdater::remove(entt::entity entity) {
+  const auto it = entity_to_index.find(static_cast<uint32_t>(entity));
+  if (it == entity_to_index.end())
+    return;
+
+  const uint32_t index = it->second;
+  entity_to_index.erase(it);
+
+  if (index != characters.size() - 1) {
+    characters[index] = std::move(characters.back());
+    entity_to_index[static_cast<uint32_t>(characters[index].entity)] = index;
+  }
+  characters.pop_back();
+}
+
+void CharacterUpdater::set_velocity(entt::entity entity, const Vec3& velocity) {
+  const auto it = entity_to_index.find(static_cast<uint32_t>(entity));
+  if (it != entity_to_index.end())
+    characters[it->second].velocity = velocity;
+}
+
+void CharacterUpdater::update(const float delta_time) {
+  OX_SCOPED_ZONE;
+
+  App::get_system<TaskScheduler>()->parallel_for((uint32_t)characters.size(), MIN_RANGE, [this, delta_time](const uint32_t i, const uint32_t thread_num) {
+    update_character(characters[i], delta_time, *temp_allocators[thread_num]);
+  });
+
+  states.resize(characters.size());
+  contacts.clear();
+  for (size_t i = 0; i < characters.size(); i++) {
+    const auto& entry = characters[i];
+    const JPH::Vec3 position = entry.character->GetPosition();
+    const JPH::Quat rotation = entry.character->GetRotation();
+    states[i] = {
+      .entity = entry.entity,
+      .position = {position.GetX(), position.GetY(), position.GetZ()},
+      .rotation = Quat(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ()),
+      .grounded = entry.character->GetGroundState() == JPH::CharacterBase::EGroundState::OnGround,
+    };
+    contacts.insert(contacts.end(), entry.new_contacts.begin(), entry.new_contacts.end());
+  }
+}
+
+void CharacterUpdater::save_state(Archive& archive) const {
+  OX_SCOPED_ZONE;
+
+  ArchiveStateRecorder recorder(archive);
+  archive << characters.size();
+  for (const auto& entry : characters) {
+    archive << static_cast<uint32_t>(entry.entity);
+    archive << entry.velocity.x << entry.velocity.y << entry.velocity.z;
+    archive << entry.touching;
+    entry.character->SaveState(recorder);
+  }
+}
+
+bool CharacterUpdater::restore_state(Archive& archive) {
+  OX_SCOPED_ZONE;
+
+  ArchiveStateRecorder recorder(archive);
+  size_t count = 0;
+  archive >> count;
+  if (count != characters.size()) {
+    OX_LOG_ERROR("Character state was saved with {} characters, there are {} now.", count, characters.size());
+    return false;
+  }
+
+  for (auto& entry : characters) {
+    uint32_t entity = 0;
+    archive >> entity;
+    if (entity != static_cast<uint32_t>(entry.entity)) {
+      OX_LOG_ERROR("Character state was saved with different characters.");
+      return false;
+    }
+    archive >> entry.velocity.x >> entry.velocity.y >> entry.velocity.z;
+
+    size_t touching_count = 0;
+    archive >> touching_count;
+    if (!archive.can_read(touching_count)) {
+      OX_LOG_ERROR("Character state is truncated or corrupt.");
+      return false;
+    }
+    entry.touching.resize(touching_count);
+    for (auto& body_id : entry.touching)
+      archive >> body_id;
+
+    entry.character->RestoreState(recorder);
+  }
+
+  if (recorder.IsFailed()) {
+    OX_LOG_ERROR("Character state is truncated or corrupt.");
+    return false;
+  }
+
+  return true;
+}
+
+void CharacterUpdater::update_character(Entry& entry, const float delta_time, JoltTempAllocator& temp_allocator) const {
+  auto& character = *entry.character;
+  const auto* physics_system = Physics::get_physics_system();
+
+  const JPH::Vec3 gravity = {0.0f, -entry.settings.gravity, 0.0f};
+  const JPH::Vec3 desired = {entry.velocity.x, 0.0f, entry.velocity.z};
+
+  // Keep the vertical velocity while in the air, follow the ground when standing on it.
+  character.UpdateGroundVelocity();
+  const bool grounded = character.GetGroundState() == JPH::CharacterBase::EGroundState::OnGround;
+  JPH::Vec3 velocity;
+  if (grounded) {
+    velocity = character.GetGroundVelocity();
+    if (entry.velocity.y > 0.0f)
+      velocity += JPH::Vec3(0.0f, entry.settings.jump_force, 0.0f);
+  }
+  // A jump request only lives for one step, otherwise it fires again on every grounded step until the velocity is changed.
+  entry.velocity.y = 0.0f;
+  else {
+    velocity = JPH::Vec3(0.0f, character.GetLinearVelocity().GetY(), 0.0f);
+  }
+  velocity += gravity * delta_time + desired;
+  character.SetLinearVelocity(velocity);
+
+  JPH::CharacterVirtual::ExtendedUpdateSettings update_settings;
+  update_settings.mStickToFloorStepDown = JPH::Vec3(0.0f, -entry.settings.stick_to_floor_distance, 0.0f);
+  update_settings.mWalkStairsStepUp = JPH::Vec3(0.0f, entry.settings.max_step_height, 0.0f);
+
+  character.ExtendedUpdate(delta_time,
+                           gravity,
+                           update_settings,
+                           // Tag layers past Default aren't in the layer filters, characters always move on MOVING.
+                           physics_system->GetDefaultBroadPhaseLayerFilter(PhysicsLayers::MOVING),
+                           physics_system->GetDefaultLayerFilter(PhysicsLayers::MOVING),
+                           {},
+                           {},
+                           temp_allocator);
+
+  // Only report bodies that weren't touched in the previous update
+  entry.new_contacts.clear();
+  static thread_local std::vector<uint32_t> touching = {};
+  touching.clear();
+  for (const auto& contact : character.GetActiveContacts()) {
+    if (!contact.mHadCollision)
+      continue;
+
+    const uint32_t body_id = contact.mBodyB.GetIndexAndSequenceNumber();
+    touching.emplace_back(body_id);
+    if (std::binary_search(entry.touching.begin(), entry.touching.end(), body_id))
+      continue;
+
+    entry.new_contacts.emplace_back(CharacterContact{
+      .character = entry.entity,
+      .other = static_cast<entt::entity>(contact.mUserData),
+      .position = {contact.mPosition.GetX(), contact.mPosition.GetY(), contact.mPosition.GetZ()},
+      .normal = {contact.mContactNormal.GetX(), contact.mContactNormal.GetY(), contact.mContactNormal.GetZ()},
+    });
+  }
+  std::ranges::sort(touching);
+  entry.touching.assign(touching.begin(), touching.end());
+}
+}
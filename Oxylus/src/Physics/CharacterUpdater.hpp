@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+
+#include <ankerl/unordered_dense.h>
+#include <entt/entity/entity.hpp>
+
+#include "Core/Base.hpp"
+#include "Core/Types.hpp"
+
+namespace JPH {
+class CharacterVirtual;
+}
+
+namespace ox {
+class JoltTempAllocator;
+class Archive;
+
+struct CharacterControllerSettings {
+  float max_step_height = 0.4f;         // Stairs up to this height are walked up
+  float stick_to_floor_distance = 0.5f; // Max distance the character snaps down to keep touching the floor
+  float gravity = 20.0f;
+  float jump_force = 8.0f; // Upward speed a jump starts with
+};
+
+/// Only the first contact with a body is reported, a character resting on or sliding along a body doesn't report it again.
+struct CharacterContact {
+  entt::entity character = entt::null;
+  entt::entity other = entt::null;
+  Vec3 position = {};
+  Vec3 normal = {};
+};
+
+/// Moves kinematic JPH::CharacterVirtual controllers in parallel on the task scheduler.
+/// Characters don't collide with each other, they only read the physics world so each one can be updated on any worker.
+class CharacterUpdater {
+public:
+  static constexpr uint32_t MIN_RANGE = 8;
+  static constexpr uint32_t TEMP_ALLOCATOR_SIZE = 256 * 1024;
+
+  struct CharacterState {
+    entt::entity entity = entt::null;
+    Vec3 position = {};
+    Quat rotation = {};
+    bool grounded = false;
+  };
+
+  CharacterUpdater();
+  ~CharacterUpdater();
+
+  void add(entt::entity entity, const Shared<JPH::CharacterVirtual>& character, const CharacterControllerSettings& settings);
+  void remove(entt::entity entity);
+  /// Horizontal velocity the character moves with. A positive y requests a single jump with the character's jump_force,
+  /// it's consumed by the next step and dropped if the character isn't grounded then.
+  void set_velocity(entt::entity entity, const Vec3& velocity);
+
+  void update(float delta_time);
+
+  /// Character state and their velocities, in update order. Restoring needs the same characters that were saved.
+  void save_state(Archive& archive) const;
+  bool restore_state(Archive& archive);
+
+  size_t size() const { return characters.size(); }
+  const std::vector<CharacterState>& get_states() const { return states; }
+  /// New contacts found by the last update.
+  const std::vector<CharacterContact>& get_contacts() const { return contacts; }
+
+private:
+  struct Entry {
+    entt::entity entity = entt::null;
+    Shared<JPH::CharacterVirtual> character = nullptr;
+    CharacterControllerSettings settings = {};
+    Vec3 velocity = {};
+    std::vector<uint32_t> touching = {}; // Bodies the character touched last update, sorted
+    std::vector<CharacterContact> new_contacts = {};
+  };
+
+  std::vector<Entry> characters = {};
+  ankerl::unordered_dense::map<uint32_t, uint32_t> entity_to_index = {};
+
+  std::vector<CharacterState> states = {};
+  std::vector<CharacterContact> contacts = {};
+
+  // One per scheduler thread, JoltTempAllocator isn't thread safe
+  std::vector<Unique<JoltTempAllocator>> temp_allocators = {};
+
+  void update_character(Entry& entry, float delta_time, JoltTempAllocator& temp_allocator) const;
+};
+}
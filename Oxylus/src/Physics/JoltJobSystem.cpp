@@ -0,0 +1,137 @@
+#include "JoltJobSystem.hpp"
+
+#include <bit>
+#include <thread>
+
+#include "Jolt/Core/Memory.h"
+
+#include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+JoltJobSystem::JoltJobSystem(enki::TaskScheduler* scheduler, const uint32_t max_jobs, const uint32_t max_barriers) :
+  JobSystemWithBarrier(max_barriers),
+  scheduler(scheduler),
+  task_count(max_jobs),
+  tasks(create_unique<JobTask[]>(max_jobs)),
+  idle_tasks(std::bit_ceil(std::max(max_jobs, 2u))) {
+  OX_CHECK_NULL(scheduler, "JoltJobSystem needs an initialized task scheduler");
+  jobs.Init(max_jobs, max_jobs);
+  for (uint32_t i = 0; i < task_count; i++) {
+    tasks[i].owner = this;
+    tasks[i].index = i;
+    idle_tasks.try_push(i);
+  }
+}
+
+JoltJobSystem::~JoltJobSystem() {
+  for (uint32_t i = 0; i < task_count; i++) {
+    if (!tasks[i].GetIsComplete())
+      scheduler->WaitforTask(&tasks[i]);
+  }
+}
+
+int JoltJobSystem::GetMaxConcurrency() const {
+  return (int)scheduler->GetNumTaskThreads();
+}
+
+JPH::JobHandle JoltJobSystem::CreateJob(const char* inName, const JPH::ColorArg inColor, const JobFunction& inJobFunction, const JPH::uint32 inNumDependencies) {
+  OX_SCOPED_ZONE;
+  uint32_t index = jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+  if (index == JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex) {
+    // Warn once per wait, not on every retry.
+    OX_LOG_WARN("JoltJobSystem ran out of jobs, waiting for a free one.");
+    do {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      index = jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+    } while (index == JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex);
+  }
+
+  Job* job = &jobs.Get(index);
+
+  // Keep a reference before queueing, the job may finish before we return.
+  JobHandle handle(job);
+
+  if (inNumDependencies == 0)
+    QueueJob(job);
+
+  return handle;
+}
+
+void JoltJobSystem::QueueJob(Job* inJob) {
+  // Released once the job has been executed.
+  inJob->AddRef();
+
+  uint32_t index;
+  if (!idle_tasks.try_pop(index)) {
+    // Every task is in flight, running the job here beats blocking on one of them.
+    inJob->Execute();
+    inJob->Release();
+    return;
+  }
+
+  // An idle task's previous job already ran, this only waits for enki to finish its bookkeeping after ExecuteRange.
+  auto& task = tasks[index];
+  if (!task.GetIsComplete())
+    scheduler->WaitforTask(&task);
+
+  task.job = inJob;
+  scheduler->AddTaskSetToPipe(&task);
+}
+
+void JoltJobSystem::QueueJobs(Job** inJobs, const JPH::uint inNumJobs) {
+  for (JPH::uint i = 0; i < inNumJobs; ++i)
+    QueueJob(inJobs[i]);
+}
+
+void JoltJobSystem::FreeJob(Job* inJob) {
+  jobs.DestructObject(inJob);
+}
+
+void JoltJobSystem::JobTask::ExecuteRange(enki::TaskSetPartition, uint32_t) {
+  OX_SCOPED_ZONE_N("Jolt Job");
+  job->Execute();
+  job->Release();
+  job = nullptr;
+  owner->idle_tasks.try_push(index);
+}
+
+JoltTempAllocator::JoltTempAllocator(const uint32_t size) : capacity(size) {
+  base = static_cast<uint8_t*>(JPH::AlignedAllocate(size, JPH_RVECTOR_ALIGNMENT));
+}
+
+JoltTempAllocator::~JoltTempAllocator() {
+  OX_ASSERT(top == 0, "JoltTempAllocator destroyed while allocations are still alive");
+  JPH::AlignedFree(base);
+}
+
+void* JoltTempAllocator::Allocate(const JPH::uint inSize) {
+  if (inSize == 0)
+    return nullptr;
+
+  const uint32_t size = (uint32_t)JPH::AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+  if (top + size > capacity) {
+    overflow_count++;
+    return JPH::AlignedAllocate(size, JPH_RVECTOR_ALIGNMENT);
+  }
+
+  void* address = base + top;
+  top += size;
+  peak = std::max(peak, top);
+  return address;
+}
+
+void JoltTempAllocator::Free(void* inAddress, const JPH::uint inSize) {
+  if (inAddress == nullptr)
+    return;
+
+  if (!owns(inAddress)) {
+    JPH::AlignedFree(inAddress);
+    return;
+  }
+
+  const uint32_t size = (uint32_t)JPH::AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+  top -= size;
+  OX_ASSERT(base + top == inAddress, "Jolt temporary allocations must be freed in reverse order");
+}
+}
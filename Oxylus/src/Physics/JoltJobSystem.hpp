@@ -0,0 +1,71 @@
+#pragma once
+#include <TaskScheduler.h>
+
+#include "Jolt/Jolt.h"
+#include "Jolt/Core/FixedSizeFreeList.h"
+#include "Jolt/Core/JobSystemWithBarrier.h"
+#include "Jolt/Core/TempAllocator.h"
+
+#include "Core/Base.hpp"
+
+#include "Thread/LockFreeQueue.hpp"
+
+namespace ox {
+/// Runs Jolt jobs on the engine's enki scheduler instead of a separate thread pool.
+class JoltJobSystem final : public JPH::JobSystemWithBarrier {
+public:
+  JoltJobSystem(enki::TaskScheduler* scheduler, uint32_t max_jobs, uint32_t max_barriers);
+  ~JoltJobSystem() override;
+
+  int GetMaxConcurrency() const override;
+  JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0) override;
+
+protected:
+  void QueueJob(Job* inJob) override;
+  void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+  void FreeJob(Job* inJob) override;
+
+private:
+  struct JobTask : enki::ITaskSet {
+    JoltJobSystem* owner = nullptr;
+    uint32_t index = 0;
+    Job* job = nullptr;
+
+    void ExecuteRange(enki::TaskSetPartition range, uint32_t thread_num) override;
+  };
+
+  enki::TaskScheduler* scheduler = nullptr;
+  JPH::FixedSizeFreeList<Job> jobs;
+
+  // enki tasks and the indices of the idle ones. A task goes back to the idle list once its job has run,
+  // when none is idle the job runs inline instead of waiting for one.
+  uint32_t task_count = 0;
+  Unique<JobTask[]> tasks = nullptr;
+  LockFreeQueue<uint32_t> idle_tasks;
+};
+
+/// Stack allocator for Jolt's temporary allocations that works on a fixed block of engine memory.
+/// Allocations that don't fit in the block fall back to the heap instead of asserting like JPH::TempAllocatorImpl.
+class JoltTempAllocator final : public JPH::TempAllocator {
+public:
+  explicit JoltTempAllocator(uint32_t size);
+  ~JoltTempAllocator() override;
+
+  void* Allocate(JPH::uint inSize) override;
+  void Free(void* inAddress, JPH::uint inSize) override;
+
+  uint32_t get_capacity() const { return capacity; }
+  uint32_t get_used() const { return top; }
+  uint32_t get_peak() const { return peak; }
+  uint32_t get_overflow_count() const { return overflow_count; }
+
+private:
+  uint8_t* base = nullptr;
+  uint32_t capacity = 0;
+  uint32_t top = 0;
+  uint32_t peak = 0;
+  uint32_t overflow_count = 0;
+
+  bool owns(const void* address) const { return address >= base && address < base + capacity; }
+};
+}
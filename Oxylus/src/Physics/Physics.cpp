@@ -2,25 +2,31 @@
 
 #include <cstdarg>
 
+#include "ArchiveStateRecorder.hpp"
 #include "JoltHelpers.hpp"
+#include "JoltJobSystem.hpp"
 #include "RayCast.hpp"
 
+#include "Core/App.hpp"
 #include "Core/Base.hpp"
+#include "Core/Memory.hpp"
 
 #include "Jolt/RegisterTypes.h"
 #include "Jolt/Physics/Collision/CastResult.h"
 #include "Jolt/Physics/Collision/RayCast.h"
 
+#include "Thread/TaskScheduler.hpp"
+
 #include "Utils/Log.hpp"
 #include "Utils/Profiler.hpp"
 
 namespace ox {
 BPLayerInterfaceImpl Physics::layer_interface;
-JPH::TempAllocatorImpl* Physics::temp_allocator = nullptr;
+JoltTempAllocator* Physics::temp_allocator = nullptr;
 ObjectVsBroadPhaseLayerFilterImpl Physics::object_vs_broad_phase_layer_filter_interface;
 ObjectLayerPairFilterImpl Physics::object_layer_pair_filter_interface;
 JPH::PhysicsSystem* Physics::physics_system = nullptr;
-JPH::JobSystemThreadPool* Physics::job_system = nullptr;
+JoltJobSystem* Physics::job_system = nullptr;
 
 std::map<Physics::EntityLayer, Physics::EntityLayerData> Physics::layer_collision_mask =
 {
@@ -48,8 +54,11 @@ static bool AssertFailedImpl(const char* inExpression, const char* inMessage, co
 #endif
 
 void Physics::init() {
-  // TODO: Override default allocators with Oxylus allocators.
-  JPH::RegisterDefaultAllocator();
+  // Jolt's heap and temp allocations are accounted to MemoryTag::Physics.
+  JPH::Allocate = [](const size_t size) { return Memory::allocate(size, MemoryTag::Physics); };
+  JPH::Free = [](void* block) { Memory::free(block); };
+  JPH::AlignedAllocate = [](const size_t size, const size_t alignment) { return Memory::allocate(size, MemoryTag::Physics, alignment); };
+  JPH::AlignedFree = [](void* block) { Memory::free(block); };
 
   // Install callbacks
   JPH::Trace = TraceImpl;
@@ -60,10 +69,11 @@ void Physics::init() {
   JPH::Factory::sInstance = new JPH::Factory();
   JPH::RegisterTypes();
 
-  temp_allocator = new JPH::TempAllocatorImpl(10 * 1024 * 1024);
+  temp_allocator = new JoltTempAllocator(TEMP_ALLOCATOR_SIZE);
 
-  job_system = new JPH::JobSystemThreadPool();
-  job_system->Init(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, (int)std::thread::hardware_concurrency() - 1);
+  // Jolt jobs run on the engine task scheduler so physics doesn't fight with another thread pool.
+  auto* task_scheduler = App::get_system<TaskScheduler>()->get().get();
+  job_system = new JoltJobSystem(task_scheduler, JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
   physics_system = new JPH::PhysicsSystem();
   physics_system->Init(
     MAX_BODIES,
@@ -87,9 +97,34 @@ void Physics::shutdown() {
   JPH::UnregisterTypes();
   delete JPH::Factory::sInstance;
   JPH::Factory::sInstance = nullptr;
-  delete temp_allocator;
   delete physics_system;
   delete job_system;
+  delete temp_allocator;
+}
+
+void Physics::save_state(Archive& archive) {
+  OX_SCOPED_ZONE;
+
+  ArchiveStateRecorder recorder(archive);
+  const size_t size_pos = archive.write_unknown_jump_position();
+  physics_system->SaveState(recorder);
+  archive.patch_unknown_jump_position(size_pos);
+}
+
+bool Physics::restore_state(Archive& archive) {
+  OX_SCOPED_ZONE;
+
+  uint64_t end_pos = 0;
+  archive >> end_pos;
+
+  ArchiveStateRecorder recorder(archive);
+  if (end_pos > archive.get_size() || !physics_system->RestoreState(recorder) || archive.get_pos() != end_pos) {
+    OX_LOG_ERROR("Failed to restore physics state. It has to be restored with the same bodies it was saved with.");
+    archive.jump(end_pos);
+    return false;
+  }
+
+  return true;
 }
 
 JPH::PhysicsSystem* Physics::get_physics_system() {
@@ -3,12 +3,20 @@
 
 #include "PhysicsInterfaces.hpp"
 
-#include "Jolt/Core/JobSystemThreadPool.h"
 #include "Jolt/Physics/Collision/CollisionCollectorImpl.h"
 #include "Jolt/Physics/PhysicsSystem.h"
 
+#include "Utils/CVars.hpp"
+
 namespace ox {
+namespace PhysicsCVar {
+inline AutoCVar_Int cvar_threaded("physics.threaded", "run the physics simulation on its own thread", 0);
+}
+
 class RayCast;
+class Archive;
+class JoltJobSystem;
+class JoltTempAllocator;
 
 class Physics {
 public:
@@ -25,6 +33,9 @@ public:
   static constexpr uint32_t MAX_BODIES = 1024;
   static constexpr uint32_t MAX_BODY_PAIRS = 1024;
   static constexpr uint32_t MAX_CONTACT_CONSTRAINS = 1024;
+  // Minimum stable value is 16.0
+  static constexpr float STEP_RATE = 50.0f;
+  static constexpr uint32_t TEMP_ALLOCATOR_SIZE = 10 * 1024 * 1024;
   static BPLayerInterfaceImpl layer_interface;
   static ObjectVsBroadPhaseLayerFilterImpl object_vs_broad_phase_layer_filter_interface;
   static ObjectLayerPairFilterImpl object_layer_pair_filter_interface;
@@ -36,12 +47,20 @@ public:
   static JPH::PhysicsSystem* get_physics_system();
   static JPH::BodyInterface& get_body_interface();
   static const JPH::BroadPhaseQuery& get_broad_phase();
+  static JoltJobSystem* get_job_system() { return job_system; }
+  static JoltTempAllocator* get_temp_allocator() { return temp_allocator; }
+
+  /// Saves the whole simulation state (bodies, contacts, constraints). Only valid to restore in the same session,
+  /// with the same bodies still alive, which is what rollback and replays need.
+  static void save_state(Archive& archive);
+  static bool restore_state(Archive& archive);
 
+  /// Broadphase only, hits are against body bounding boxes. Use PhysicsQuery for surface hits.
   static JPH::AllHitCollisionCollector<JPH::RayCastBodyCollector> cast_ray(const RayCast& ray_cast);
 
 private:
   static JPH::PhysicsSystem* physics_system;
-  static JPH::TempAllocatorImpl* temp_allocator;
-  static JPH::JobSystemThreadPool* job_system;
+  static JoltTempAllocator* temp_allocator;
+  static JoltJobSystem* job_system;
 };
 }
@@ -0,0 +1,64 @@
+#include "PhysicsCommand.hpp"
+
+#include "Physics.hpp"
+
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+void execute_physics_command(PhysicsCommand& command, CharacterUpdater& character_updater) {
+  OX_SCOPED_ZONE;
+
+  auto& body_interface = Physics::get_body_interface();
+
+  const JPH::BodyID id(command.body_id);
+  const JPH::EActivation activation = command.activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate;
+  const JPH::Vec3 vector = {command.vector.x, command.vector.y, command.vector.z};
+
+  switch (command.type) {
+    case PhysicsCommand::Type::AddBody: {
+      body_interface.AddBody(id, activation);
+      break;
+    }
+    case PhysicsCommand::Type::RemoveBody: {
+      if (body_interface.IsAdded(id))
+        body_interface.RemoveBody(id);
+      body_interface.DestroyBody(id);
+      break;
+    }
+    case PhysicsCommand::Type::AddForce: {
+      body_interface.AddForce(id, vector);
+      break;
+    }
+    case PhysicsCommand::Type::AddImpulse: {
+      body_interface.AddImpulse(id, vector);
+      break;
+    }
+    case PhysicsCommand::Type::SetLinearVelocity: {
+      body_interface.SetLinearVelocity(id, vector);
+      break;
+    }
+    case PhysicsCommand::Type::SetAngularVelocity: {
+      body_interface.SetAngularVelocity(id, vector);
+      break;
+    }
+    case PhysicsCommand::Type::Teleport: {
+      const JPH::Quat rotation = {command.rotation.x, command.rotation.y, command.rotation.z, command.rotation.w};
+      body_interface.SetPositionAndRotation(id, vector, rotation, activation);
+      break;
+    }
+    case PhysicsCommand::Type::AddCharacter: {
+      character_updater.add(command.entity, command.character, command.character_settings);
+      command.character = nullptr;
+      break;
+    }
+    case PhysicsCommand::Type::RemoveCharacter: {
+      character_updater.remove(command.entity);
+      break;
+    }
+    case PhysicsCommand::Type::SetCharacterVelocity: {
+      character_updater.set_velocity(command.entity, command.vector);
+      break;
+    }
+  }
+}
+}
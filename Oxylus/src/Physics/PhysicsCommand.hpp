@@ -0,0 +1,40 @@
+#pragma once
+#include <entt/entity/entity.hpp>
+
+#include "CharacterUpdater.hpp"
+
+#include "Core/Types.hpp"
+
+namespace ox {
+/// Gameplay -> physics command. Everything that touches bodies while the simulation thread is running goes through these,
+/// single threaded scenes queue them until the next step so recordings see the same inputs.
+struct PhysicsCommand {
+  enum class Type : uint8_t {
+    AddBody = 0,   // body is created on the game thread, only added to the broadphase here
+    RemoveBody,    // removes and destroys the body
+    AddForce,
+    AddImpulse,
+    SetLinearVelocity,
+    SetAngularVelocity,
+    Teleport,      // sets position and rotation
+    AddCharacter,
+    RemoveCharacter,
+    SetCharacterVelocity,
+  };
+
+  Type type = Type::AddBody;
+  bool activate = true;
+  uint32_t body_id = UINT32_MAX;
+  Vec3 vector = {};
+  Quat rotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+  entt::entity entity = entt::null;                // Characters are referred to by their entity
+  Shared<JPH::CharacterVirtual> character = nullptr; // AddCharacter only
+  CharacterControllerSettings character_settings = {};
+
+  /// Commands that only change the state of existing bodies and characters. These are what a PhysicsRecording stores.
+  bool is_input() const { return type != Type::AddBody && type != Type::RemoveBody && type != Type::AddCharacter && type != Type::RemoveCharacter; }
+};
+
+/// Applies a command to the physics world. Has to be called between steps.
+void execute_physics_command(PhysicsCommand& command, CharacterUpdater& character_updater);
+}
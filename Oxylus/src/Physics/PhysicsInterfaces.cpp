@@ -4,7 +4,6 @@
 
 #include "Jolt/Physics/Body/Body.h"
 
-#include "Scene/Scene.hpp"
 #include "Utils/Log.hpp"
 #include "Utils/Profiler.hpp"
 
@@ -64,7 +63,9 @@ void Physics3DBodyActivationListener::OnBodyActivated(const JPH::BodyID& inBodyI
 void Physics3DBodyActivationListener::OnBodyDeactivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) {
   OX_SCOPED_ZONE;
 
-  /* Body Deactivated */
+  // Called with the body locked, the transform is read once the step is done.
+  // A full queue drops it and the body keeps its last interpolated transform.
+  m_DeactivatedBodies.try_push(inBodyID);
 }
 
 void Physics3DContactListener::GetFrictionAndRestitution(const JPH::Body& inBody, const JPH::SubShapeID& inSubShapeID, float& outFriction, float& outRestitution) {
@@ -107,7 +108,7 @@ void Physics3DContactListener::OnContactAdded(const JPH::Body& inBody1, const JP
 
   OverrideContactSettings(inBody1, inBody2, inManifold, ioSettings);
 
-  m_Scene->on_contact_added(inBody1, inBody2, inManifold, ioSettings);
+  RecordContact(inBody1, inBody2, inManifold, false);
 }
 
 void Physics3DContactListener::OnContactPersisted(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings) {
@@ -115,7 +116,21 @@ void Physics3DContactListener::OnContactPersisted(const JPH::Body& inBody1, cons
 
   OverrideContactSettings(inBody1, inBody2, inManifold, ioSettings);
 
-  m_Scene->on_contact_persisted(inBody1, inBody2, inManifold, ioSettings);
+  RecordContact(inBody1, inBody2, inManifold, true);
+}
+
+void Physics3DContactListener::RecordContact(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, const bool inPersisted) {
+  const JPH::RVec3 position = inManifold.mRelativeContactPointsOn1.empty() ? inManifold.mBaseOffset : inManifold.GetWorldSpaceContactPointOn1(0);
+  const JPH::Vec3 normal = inManifold.mWorldSpaceNormal;
+
+  // Dropped when the game thread isn't keeping up
+  m_Contacts.try_push(ox::BodyContact{
+    .body1 = static_cast<entt::entity>(inBody1.GetUserData()),
+    .body2 = static_cast<entt::entity>(inBody2.GetUserData()),
+    .position = {(float)position.GetX(), (float)position.GetY(), (float)position.GetZ()},
+    .normal = {normal.GetX(), normal.GetY(), normal.GetZ()},
+    .persisted = inPersisted,
+  });
 }
 
 void Physics3DContactListener::OnContactRemoved(const JPH::SubShapeIDPair& inSubShapePair) {
@@ -1,12 +1,25 @@
 ﻿#pragma once
 #include "Jolt/Jolt.h"
 #include "Jolt/Physics/Body/BodyActivationListener.h"
+#include "Jolt/Physics/Body/BodyID.h"
 #include "Jolt/Physics/Collision/ContactListener.h"
 #include "Jolt/Physics/Collision/ObjectLayer.h"
 #include "Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h"
 
+#include <entt/entity/entity.hpp>
+
+#include "Core/Types.hpp"
+
+#include "Thread/LockFreeQueue.hpp"
+
 namespace ox {
-class Scene;
+struct BodyContact {
+  entt::entity body1 = entt::null;
+  entt::entity body2 = entt::null;
+  Vec3 position = {}; // World space, first contact point on body1
+  Vec3 normal = {};   // World space, from body1 towards body2
+  bool persisted = false;
+};
 }
 
 namespace PhysicsLayers {
@@ -56,16 +69,34 @@ public:
   bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override;
 };
 
+// Records bodies that went to sleep so their final transform can be written back,
+// only active bodies are read back after a step.
 class Physics3DBodyActivationListener : public JPH::BodyActivationListener {
 public:
+  static constexpr uint32_t DEACTIVATED_QUEUE_SIZE = 4096;
+
+  Physics3DBodyActivationListener() : m_DeactivatedBodies(DEACTIVATED_QUEUE_SIZE) {}
+
+  bool PopDeactivatedBody(JPH::BodyID& body_id) { return m_DeactivatedBodies.try_pop(body_id); }
+
   void OnBodyActivated([[maybe_unused]] const JPH::BodyID& inBodyID, [[maybe_unused]] JPH::uint64 inBodyUserData) override;
 
-  void OnBodyDeactivated([[maybe_unused]] const JPH::BodyID& inBodyID, [[maybe_unused]] JPH::uint64 inBodyUserData) override;
+  void OnBodyDeactivated(const JPH::BodyID& inBodyID, [[maybe_unused]] JPH::uint64 inBodyUserData) override;
+
+private:
+  ox::LockFreeQueue<JPH::BodyID> m_DeactivatedBodies;
 };
 
+// Contacts are reported from physics worker threads, so they're only recorded here
+// and the scene dispatches them on the game thread after the step.
 class Physics3DContactListener : public JPH::ContactListener {
 public:
-  Physics3DContactListener(ox::Scene* scene) : m_Scene(scene) {}
+  static constexpr uint32_t CONTACT_QUEUE_SIZE = 4096;
+
+  Physics3DContactListener() : m_Contacts(CONTACT_QUEUE_SIZE) {}
+
+  bool PopContact(ox::BodyContact& contact) { return m_Contacts.try_pop(contact); }
+
   JPH::ValidateResult OnContactValidate(const JPH::Body& inBody1, const JPH::Body& inBody2, JPH::RVec3Arg inBaseOffset, const JPH::CollideShapeResult& inCollisionResult) override;
 
   void OnContactAdded(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings) override;
@@ -75,7 +106,9 @@ public:
   void OnContactRemoved([[maybe_unused]] const JPH::SubShapeIDPair& inSubShapePair) override;
 
 private:
-  ox::Scene* m_Scene = nullptr;
+  ox::LockFreeQueue<ox::BodyContact> m_Contacts;
+
+  void RecordContact(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, bool inPersisted);
   static void GetFrictionAndRestitution(const JPH::Body& inBody, const JPH::SubShapeID& inSubShapeID, float& outFriction, float& outRestitution);
 
   static void OverrideContactSettings(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings);
@@ -0,0 +1,282 @@
+#include "PhysicsQuery.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "JoltHelpers.hpp"
+#include "Physics.hpp"
+
+#include "Core/App.hpp"
+
+#include "Jolt/Jolt.h"
+#include "Jolt/Physics/Body/BodyLock.h"
+#include "Jolt/Physics/Body/BodyFilter.h"
+#include "Jolt/Physics/Collision/CastResult.h"
+#include "Jolt/Physics/Collision/CollideShape.h"
+#include "Jolt/Physics/Collision/CollisionCollectorImpl.h"
+#include "Jolt/Physics/Collision/NarrowPhaseQuery.h"
+#include "Jolt/Physics/Collision/RayCast.h"
+#include "Jolt/Physics/Collision/ShapeCast.h"
+#include "Jolt/Physics/Collision/Shape/BoxShape.h"
+#include "Jolt/Physics/Collision/Shape/CapsuleShape.h"
+#include "Jolt/Physics/Collision/Shape/SphereShape.h"
+
+#include "Thread/TaskScheduler.hpp"
+
+#include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+// Filters on Physics::EntityLayer flags, object layers are the index of the flag.
+class LayerMaskFilter final : public JPH::ObjectLayerFilter {
+public:
+  explicit LayerMaskFilter(const uint16_t mask) : mask(mask) {}
+
+  bool ShouldCollide(const JPH::ObjectLayer inLayer) const override { return inLayer < 16 && (mask & BIT(inLayer)) != 0; }
+
+private:
+  uint16_t mask;
+};
+
+// Collects every hit into a reused per-thread array so all-hit queries don't allocate once warmed up.
+template <typename CollectorType>
+class ScratchCollector final : public CollectorType {
+public:
+  using ResultType = typename CollectorType::ResultType;
+
+  explicit ScratchCollector(std::vector<ResultType>& storage) : hits(storage) { hits.clear(); }
+
+  void AddHit(const ResultType& inResult) override { hits.emplace_back(inResult); }
+
+  std::vector<ResultType>& hits;
+};
+
+static JPH::Quat to_jolt_quat(const Quat& q) { return {q.x, q.y, q.z, q.w}; }
+
+static const JPH::NarrowPhaseQuery& get_narrow_phase() { return Physics::get_physics_system()->GetNarrowPhaseQuery(); }
+
+static void fill_hit(const JPH::BodyID body_id, const JPH::SubShapeID& sub_shape, const JPH::Vec3 position, const float fraction, QueryHit& hit) {
+  hit.body_id = body_id.GetIndexAndSequenceNumber();
+  hit.position = convert_from_jolt_vec3(position);
+  hit.fraction = fraction;
+
+  const JPH::BodyLockRead lock(Physics::get_physics_system()->GetBodyLockInterface(), body_id);
+  if (lock.Succeeded()) {
+    const JPH::Body& body = lock.GetBody();
+    hit.entity = static_cast<entt::entity>(body.GetUserData());
+    hit.normal = convert_from_jolt_vec3(body.GetWorldSpaceSurfaceNormal(sub_shape, position));
+  }
+}
+
+static void fill_hit(const JPH::CollideShapeResult& result, const float fraction, QueryHit& hit) {
+  hit.body_id = result.mBodyID2.GetIndexAndSequenceNumber();
+  hit.entity = static_cast<entt::entity>(Physics::get_body_interface().GetUserData(result.mBodyID2));
+  hit.position = convert_from_jolt_vec3(result.mContactPointOn2);
+  hit.normal = convert_from_jolt_vec3(-result.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero()));
+  hit.fraction = fraction;
+}
+
+template <typename F>
+static auto with_query_shape(const ShapeQuery& query, F&& function) {
+  switch (query.type) {
+    case ShapeQuery::Type::Box: {
+      const JPH::Vec3 half_extent = convert_to_jolt_vec3(glm::max(glm::abs(query.size), Vec3(0.001f)));
+      JPH::BoxShape shape(half_extent, std::min(JPH::cDefaultConvexRadius, half_extent.ReduceMin()));
+      shape.SetEmbedded();
+      return function(shape);
+    }
+    case ShapeQuery::Type::Capsule: {
+      JPH::CapsuleShape shape(glm::max(query.size.y, 0.001f), glm::max(query.size.x, 0.001f));
+      shape.SetEmbedded();
+      return function(shape);
+    }
+    case ShapeQuery::Type::Sphere:
+    default: {
+      JPH::SphereShape shape(glm::max(query.size.x, 0.001f));
+      shape.SetEmbedded();
+      return function(shape);
+    }
+  }
+}
+
+static JPH::RShapeCast make_shape_cast(const JPH::Shape& shape, const ShapeQuery& query) {
+  const auto transform = JPH::RMat44::sRotationTranslation(to_jolt_quat(query.rotation), convert_to_jolt_vec3(query.position));
+  return JPH::RShapeCast::sFromWorldTransform(&shape, JPH::Vec3::sReplicate(1.0f), transform, convert_to_jolt_vec3(query.direction));
+}
+
+bool PhysicsQuery::raycast(const RayQuery& query, QueryHit& hit, const QueryMode mode) {
+  OX_SCOPED_ZONE;
+  hit = {};
+
+  const JPH::RRayCast ray{convert_to_jolt_vec3(query.origin), convert_to_jolt_vec3(query.direction)};
+  const LayerMaskFilter layer_filter(query.layer_mask);
+  const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(query.ignore_body));
+
+  if (mode == QueryMode::Any) {
+    JPH::AnyHitCollisionCollector<JPH::CastRayCollector> collector;
+    get_narrow_phase().CastRay(ray, JPH::RayCastSettings(), collector, JPH::BroadPhaseLayerFilter(), layer_filter, body_filter);
+    if (!collector.HadHit())
+      return false;
+    fill_hit(collector.mHit.mBodyID, collector.mHit.mSubShapeID2, ray.GetPointOnRay(collector.mHit.mFraction), collector.mHit.mFraction, hit);
+    return true;
+  }
+
+  JPH::RayCastResult result;
+  if (!get_narrow_phase().CastRay(ray, result, JPH::BroadPhaseLayerFilter(), layer_filter, body_filter))
+    return false;
+
+  fill_hit(result.mBodyID, result.mSubShapeID2, ray.GetPointOnRay(result.mFraction), result.mFraction, hit);
+  return true;
+}
+
+uint32_t PhysicsQuery::raycast_all(const RayQuery& query, std::span<QueryHit> hits) {
+  OX_SCOPED_ZONE;
+  thread_local std::vector<JPH::RayCastResult> scratch = {};
+
+  const JPH::RRayCast ray{convert_to_jolt_vec3(query.origin), convert_to_jolt_vec3(query.direction)};
+  const LayerMaskFilter layer_filter(query.layer_mask);
+  const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(query.ignore_body));
+
+  ScratchCollector<JPH::CastRayCollector> collector(scratch);
+  get_narrow_phase().CastRay(ray, JPH::RayCastSettings(), collector, JPH::BroadPhaseLayerFilter(), layer_filter, body_filter);
+
+  std::sort(scratch.begin(), scratch.end(), [](const JPH::RayCastResult& a, const JPH::RayCastResult& b) { return a.mFraction < b.mFraction; });
+
+  const uint32_t count = std::min((uint32_t)scratch.size(), (uint32_t)hits.size());
+  for (uint32_t i = 0; i < count; i++) {
+    hits[i] = {};
+    fill_hit(scratch[i].mBodyID, scratch[i].mSubShapeID2, ray.GetPointOnRay(scratch[i].mFraction), scratch[i].mFraction, hits[i]);
+  }
+
+  return count;
+}
+
+bool PhysicsQuery::shape_cast(const ShapeQuery& query, QueryHit& hit, const QueryMode mode) {
+  OX_SCOPED_ZONE;
+  hit = {};
+
+  const LayerMaskFilter layer_filter(query.layer_mask);
+  const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(query.ignore_body));
+
+  return with_query_shape(query, [&](const JPH::Shape& shape) {
+    const JPH::RShapeCast shape_cast = make_shape_cast(shape, query);
+
+    if (mode == QueryMode::Any) {
+      JPH::AnyHitCollisionCollector<JPH::CastShapeCollector> collector;
+      get_narrow_phase().CastShape(shape_cast, JPH::ShapeCastSettings(), JPH::RVec3::sZero(), collector, JPH::BroadPhaseLayerFilter(), layer_filter, body_filter);
+      if (!collector.HadHit())
+        return false;
+      fill_hit(collector.mHit, collector.mHit.mFraction, hit);
+      return true;
+    }
+
+    JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+    get_narrow_phase().CastShape(shape_cast, JPH::ShapeCastSettings(), JPH::RVec3::sZero(), collector, JPH::BroadPhaseLayerFilter(), layer_filter, body_filter);
+    if (!collector.HadHit())
+      return false;
+    fill_hit(collector.mHit, collector.mHit.mFraction, hit);
+    return true;
+  });
+}
+
+uint32_t PhysicsQuery::shape_cast_all(const ShapeQuery& query, std::span<QueryHit> hits) {
+  OX_SCOPED_ZONE;
+  thread_local std::vector<JPH::ShapeCastResult> scratch = {};
+
+  const LayerMaskFilter layer_filter(query.layer_mask);
+  const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(query.ignore_body));
+
+  with_query_shape(query, [&](const JPH::Shape& shape) {
+    ScratchCollector<JPH::CastShapeCollector> collector(scratch);
+    get_narrow_phase().CastShape(make_shape_cast(shape, query), JPH::ShapeCastSettings(), JPH::RVec3::sZero(), collector, JPH::BroadPhaseLayerFilter(), layer_filter, body_filter);
+    return true;
+  });
+
+  std::sort(scratch.begin(), scratch.end(), [](const JPH::ShapeCastResult& a, const JPH::ShapeCastResult& b) { return a.mFraction < b.mFraction; });
+
+  const uint32_t count = std::min((uint32_t)scratch.size(), (uint32_t)hits.size());
+  for (uint32_t i = 0; i < count; i++) {
+    hits[i] = {};
+    fill_hit(scratch[i], scratch[i].mFraction, hits[i]);
+  }
+
+  return count;
+}
+
+bool PhysicsQuery::overlap_any(const ShapeQuery& query) {
+  OX_SCOPED_ZONE;
+  const LayerMaskFilter layer_filter(query.layer_mask);
+  const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(query.ignore_body));
+
+  return with_query_shape(query, [&](const JPH::Shape& shape) {
+    const auto transform = JPH::RMat44::sRotationTranslation(to_jolt_quat(query.rotation), convert_to_jolt_vec3(query.position));
+    JPH::AnyHitCollisionCollector<JPH::CollideShapeCollector> collector;
+    get_narrow_phase().CollideShape(&shape, JPH::Vec3::sReplicate(1.0f), transform, JPH::CollideShapeSettings(), JPH::RVec3::sZero(), collector, JPH::BroadPhaseLayerFilter(), layer_filter, body_filter);
+    return collector.HadHit();
+  });
+}
+
+uint32_t PhysicsQuery::overlap(const ShapeQuery& query, std::span<QueryHit> hits) {
+  OX_SCOPED_ZONE;
+  thread_local std::vector<JPH::CollideShapeResult> scratch = {};
+
+  const LayerMaskFilter layer_filter(query.layer_mask);
+  const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(query.ignore_body));
+
+  with_query_shape(query, [&](const JPH::Shape& shape) {
+    const auto transform = JPH::RMat44::sRotationTranslation(to_jolt_quat(query.rotation), convert_to_jolt_vec3(query.position));
+    ScratchCollector<JPH::CollideShapeCollector> collector(scratch);
+    get_narrow_phase().CollideShape(&shape, JPH::Vec3::sReplicate(1.0f), transform, JPH::CollideShapeSettings(), JPH::RVec3::sZero(), collector, JPH::BroadPhaseLayerFilter(), layer_filter, body_filter);
+    return true;
+  });
+
+  // Deepest penetrations first
+  std::sort(scratch.begin(), scratch.end(), [](const JPH::CollideShapeResult& a, const JPH::CollideShapeResult& b) { return a.mPenetrationDepth > b.mPenetrationDepth; });
+
+  const uint32_t count = std::min((uint32_t)scratch.size(), (uint32_t)hits.size());
+  for (uint32_t i = 0; i < count; i++) {
+    hits[i] = {};
+    fill_hit(scratch[i], 0.0f, hits[i]);
+  }
+
+  return count;
+}
+
+void PhysicsQuery::raycast_batch(std::span<const RayQuery> queries, std::span<QueryHit> hits, const QueryMode mode) {
+  OX_SCOPED_ZONE;
+  OX_CHECK_GE(hits.size(), queries.size());
+
+  App::get_system<TaskScheduler>()->parallel_for((uint32_t)queries.size(), BATCH_MIN_RANGE, [&](const uint32_t i, uint32_t) {
+    raycast(queries[i], hits[i], mode);
+  });
+}
+
+void PhysicsQuery::raycast_all_batch(std::span<const RayQuery> queries, std::span<QueryHit> hits, std::span<uint32_t> hit_counts, const uint32_t max_hits) {
+  OX_SCOPED_ZONE;
+  OX_CHECK_GE(hits.size(), queries.size() * max_hits);
+  OX_CHECK_GE(hit_counts.size(), queries.size());
+
+  App::get_system<TaskScheduler>()->parallel_for((uint32_t)queries.size(), BATCH_MIN_RANGE, [&](const uint32_t i, uint32_t) {
+    hit_counts[i] = raycast_all(queries[i], hits.subspan((size_t)i * max_hits, max_hits));
+  });
+}
+
+void PhysicsQuery::shape_cast_batch(std::span<const ShapeQuery> queries, std::span<QueryHit> hits, const QueryMode mode) {
+  OX_SCOPED_ZONE;
+  OX_CHECK_GE(hits.size(), queries.size());
+
+  App::get_system<TaskScheduler>()->parallel_for((uint32_t)queries.size(), BATCH_MIN_RANGE, [&](const uint32_t i, uint32_t) {
+    shape_cast(queries[i], hits[i], mode);
+  });
+}
+
+void PhysicsQuery::overlap_batch(std::span<const ShapeQuery> queries, std::span<QueryHit> hits, std::span<uint32_t> hit_counts, const uint32_t max_hits) {
+  OX_SCOPED_ZONE;
+  OX_CHECK_GE(hits.size(), queries.size() * max_hits);
+  OX_CHECK_GE(hit_counts.size(), queries.size());
+
+  App::get_system<TaskScheduler>()->parallel_for((uint32_t)queries.size(), BATCH_MIN_RANGE, [&](const uint32_t i, uint32_t) {
+    hit_counts[i] = overlap(queries[i], hits.subspan((size_t)i * max_hits, max_hits));
+  });
+}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <span>
+
+#include <entt/entity/entity.hpp>
+
+#include "Core/Types.hpp"
+
+namespace ox {
+enum class QueryMode {
+  Closest = 0, // Nearest hit along the ray/cast
+  Any,         // First hit found, cheapest. Good for line of sight checks.
+};
+
+struct RayQuery {
+  Vec3 origin = {};
+  Vec3 direction = {}; // Length of the direction is the max distance of the ray.
+  uint16_t layer_mask = 0xFFFF; // Physics::EntityLayer flags the ray can hit.
+  uint32_t ignore_body = UINT32_MAX;
+};
+
+struct ShapeQuery {
+  enum class Type { Sphere = 0, Box, Capsule };
+
+  Type type = Type::Sphere;
+  Vec3 size = Vec3(0.5f); // Sphere: x is radius. Box: half extents. Capsule: x is radius, y is half height.
+  Vec3 position = {};
+  Quat rotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+  Vec3 direction = {}; // Only used for shape casts, length is the cast distance.
+  uint16_t layer_mask = 0xFFFF;
+  uint32_t ignore_body = UINT32_MAX;
+};
+
+struct QueryHit {
+  entt::entity entity = entt::null;
+  uint32_t body_id = UINT32_MAX;
+  Vec3 position = {};
+  Vec3 normal = {};
+  float fraction = 1.0f;
+
+  bool has_hit() const { return body_id != UINT32_MAX; }
+};
+
+/// Narrowphase scene queries against the physics world.
+/// Batched variants run on the task scheduler and write into caller owned arrays, one slot (or max_hits slots) per query.
+class PhysicsQuery {
+public:
+  static bool raycast(const RayQuery& query, QueryHit& hit, QueryMode mode = QueryMode::Closest);
+  /// Writes up to hits.size() hits sorted by distance, returns the number written.
+  static uint32_t raycast_all(const RayQuery& query, std::span<QueryHit> hits);
+
+  static bool shape_cast(const ShapeQuery& query, QueryHit& hit, QueryMode mode = QueryMode::Closest);
+  static uint32_t shape_cast_all(const ShapeQuery& query, std::span<QueryHit> hits);
+
+  static bool overlap_any(const ShapeQuery& query);
+  static uint32_t overlap(const ShapeQuery& query, std::span<QueryHit> hits);
+
+  // Batched queries
+  static void raycast_batch(std::span<const RayQuery> queries, std::span<QueryHit> hits, QueryMode mode = QueryMode::Closest);
+  /// hits must have queries.size() * max_hits elements, hit_counts must have queries.size() elements.
+  static void raycast_all_batch(std::span<const RayQuery> queries, std::span<QueryHit> hits, std::span<uint32_t> hit_counts, uint32_t max_hits);
+  static void shape_cast_batch(std::span<const ShapeQuery> queries, std::span<QueryHit> hits, QueryMode mode = QueryMode::Closest);
+  static void overlap_batch(std::span<const ShapeQuery> queries, std::span<QueryHit> hits, std::span<uint32_t> hit_counts, uint32_t max_hits);
+
+  static constexpr uint32_t BATCH_MIN_RANGE = 16;
+};
+}
@@ -0,0 +1,158 @@
+#include "PhysicsRecording.hpp"
+
+#include "CharacterUpdater.hpp"
+#include "Physics.hpp"
+
+#include "Core/FileSystem.hpp"
+
+#include "Utils/Archive.hpp"
+#include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+#include "Utils/Timer.hpp"
+
+namespace ox {
+static void write_command(Archive& archive, const PhysicsCommand& command) {
+  archive << (uint8_t)command.type << command.activate << command.body_id;
+  archive << command.vector.x << command.vector.y << command.vector.z;
+  archive << command.rotation.w << command.rotation.x << command.rotation.y << command.rotation.z;
+  archive << static_cast<uint32_t>(command.entity);
+}
+
+static void read_command(Archive& archive, PhysicsCommand& command) {
+  uint8_t type = 0;
+  uint32_t entity = 0;
+  archive >> type >> command.activate >> command.body_id;
+  archive >> command.vector.x >> command.vector.y >> command.vector.z;
+  archive >> command.rotation.w >> command.rotation.x >> command.rotation.y >> command.rotation.z;
+  archive >> entity;
+  command.type = (PhysicsCommand::Type)type;
+  command.entity = static_cast<entt::entity>(entity);
+}
+
+void PhysicsRecording::begin(const uint64_t step, const float step_time, const CharacterUpdater& character_updater) {
+  OX_SCOPED_ZONE;
+
+  start_step = step;
+  this->step_time = step_time;
+  steps.clear();
+
+  Archive archive;
+  Physics::save_state(archive);
+  character_updater.save_state(archive);
+  archive.write_data(initial_state);
+}
+
+void PhysicsRecording::record_step(const uint64_t step, const std::span<const PhysicsCommand> commands) {
+  auto& recorded = steps.emplace_back(Step{.step = step});
+  for (const auto& command : commands) {
+    if (command.is_input())
+      recorded.commands.emplace_back(command);
+  }
+}
+
+bool PhysicsRecording::save(const std::string& path) const {
+  OX_SCOPED_ZONE;
+
+  Archive archive;
+  archive << FILE_MAGIC << start_step << step_time;
+  archive << initial_state.size();
+  archive.write_bytes(initial_state.data(), initial_state.size());
+
+  archive << steps.size();
+  for (const auto& step : steps) {
+    archive << step.step << step.commands.size();
+    for (const auto& command : step.commands)
+      write_command(archive, command);
+  }
+
+  std::vector<uint8_t> data = {};
+  archive.write_data(data);
+  return FileSystem::write_file_binary(path, data);
+}
+
+bool PhysicsRecording::load(const std::string& path) {
+  OX_SCOPED_ZONE;
+
+  Archive archive(path, true);
+  if (!archive.is_open()) {
+    OX_LOG_ERROR("Couldn't open physics recording {}", path);
+    return false;
+  }
+
+  uint32_t magic = 0;
+  archive >> magic;
+  if (magic != FILE_MAGIC) {
+    OX_LOG_ERROR("{} is not a physics recording", path);
+    return false;
+  }
+
+  archive >> start_step >> step_time;
+
+  size_t state_size = 0;
+  archive >> state_size;
+  if (!archive.can_read(state_size)) {
+    OX_LOG_ERROR("{} is truncated or corrupt", path);
+    return false;
+  }
+  initial_state.resize(state_size);
+  archive.read_bytes(initial_state.data(), state_size);
+
+  // Every step and command takes at least a byte, larger counts come from a corrupt file.
+  size_t step_count = 0;
+  archive >> step_count;
+  if (!archive.can_read(step_count)) {
+    OX_LOG_ERROR("{} is truncated or corrupt", path);
+    return false;
+  }
+  steps.resize(step_count);
+  for (auto& step : steps) {
+    size_t command_count = 0;
+    archive >> step.step >> command_count;
+    if (!archive.can_read(command_count)) {
+      OX_LOG_ERROR("{} is truncated or corrupt", path);
+      steps.clear();
+      return false;
+    }
+    step.commands.resize(command_count);
+    for (auto& command : step.commands)
+      read_command(archive, command);
+  }
+
+  return true;
+}
+
+bool PhysicsRecording::restore_initial_state(CharacterUpdater& character_updater) const {
+  OX_SCOPED_ZONE;
+
+  if (initial_state.empty())
+    return false;
+
+  Archive archive(initial_state.data(), initial_state.size());
+  return Physics::restore_state(archive) && character_updater.restore_state(archive);
+}
+
+bool PhysicsRecording::replay(CharacterUpdater& character_updater, std::vector<float>* step_times) const {
+  OX_SCOPED_ZONE;
+
+  if (!restore_initial_state(character_updater))
+    return false;
+
+  if (step_times)
+    step_times->reserve(step_times->size() + steps.size());
+
+  // Same order as Scene::update_physics: commands, characters, then the world step.
+  for (const auto& step : steps) {
+    const Timer timer = {};
+
+    for (auto command : step.commands)
+      execute_physics_command(command, character_updater);
+    character_updater.update(step_time);
+    Physics::step(step_time);
+
+    if (step_times)
+      step_times->emplace_back(timer.get_elapsed_ms());
+  }
+
+  return true;
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <span>
+#include <string>
+#include <vector>
+
+#include "PhysicsCommand.hpp"
+
+namespace ox {
+class CharacterUpdater;
+
+/// Initial physics state plus the input commands of every step after it.
+/// Replaying it against the same scene reproduces the simulation step by step, so a spike can be profiled offline
+/// or the exact same simulation can be benchmarked headlessly.
+/// Bodies and characters that are added or removed after the recording started aren't part of it.
+class PhysicsRecording {
+public:
+  struct Step {
+    uint64_t step = 0;
+    std::vector<PhysicsCommand> commands = {};
+  };
+
+  PhysicsRecording() = default;
+
+  void begin(uint64_t step, float step_time, const CharacterUpdater& character_updater);
+  /// Only input commands are kept, see PhysicsCommand::is_input.
+  void record_step(uint64_t step, std::span<const PhysicsCommand> commands);
+
+  bool save(const std::string& path) const;
+  bool load(const std::string& path);
+
+  /// Restores the initial state and runs every recorded step. The scene has to be running with the bodies it was recorded with.
+  /// If step_times is given it gets the time each step took in milliseconds.
+  bool replay(CharacterUpdater& character_updater, std::vector<float>* step_times = nullptr) const;
+
+  bool restore_initial_state(CharacterUpdater& character_updater) const;
+
+  uint64_t get_start_step() const { return start_step; }
+  float get_step_time() const { return step_time; }
+  const std::vector<Step>& get_steps() const { return steps; }
+
+private:
+  static constexpr uint32_t FILE_MAGIC = 0x5250584f; // "OXPR"
+
+  uint64_t start_step = 0;
+  float step_time = 0.0f;
+  std::vector<uint8_t> initial_state = {};
+  std::vector<Step> steps = {};
+};
+}
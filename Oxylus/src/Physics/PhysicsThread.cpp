@@ -0,0 +1,161 @@
+#include "PhysicsThread.hpp"
+
+#include <chrono>
+
+#include "Physics.hpp"
+
+#include "Core/App.hpp"
+
+#include "Jolt/Jolt.h"
+#include "Jolt/Physics/Body/BodyLock.h"
+
+#include "Thread/TaskScheduler.hpp"
+
+#include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+PhysicsThread::PhysicsThread(const float step_rate, Physics3DBodyActivationListener* activation_listener)
+  : step_time(1.0f / step_rate),
+    commands(COMMAND_QUEUE_SIZE),
+    character_contacts(CONTACT_QUEUE_SIZE),
+    sleeping_bodies(SLEEPING_QUEUE_SIZE),
+    activation_listener(activation_listener) {}
+
+PhysicsThread::~PhysicsThread() {
+  stop();
+}
+
+void PhysicsThread::start() {
+  if (is_running())
+    return;
+
+  running = true;
+  thread = std::thread([this] { run(); });
+}
+
+void PhysicsThread::stop() {
+  running = false;
+  if (thread.joinable())
+    thread.join();
+}
+
+double PhysicsThread::now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PhysicsThread::run() {
+  CpuProfiler::set_thread_name("Physics");
+
+  // Jolt jobs are queued from this thread, so enki needs to know about it.
+  const auto* task_scheduler = App::get_system<TaskScheduler>();
+  if (!task_scheduler->register_external_thread()) {
+    OX_LOG_ERROR("Couldn't register the physics thread with the task scheduler. Increase TaskScheduler::MAX_EXTERNAL_THREADS.");
+    running = false;
+    return;
+  }
+
+  // Don't try to catch up more than this many steps, drop them instead.
+  constexpr double max_lag_steps = 5.0;
+
+  double next_step = now();
+  while (running.load(std::memory_order_relaxed)) {
+    {
+      OX_SCOPED_ZONE_N("Physics Thread Step");
+      execute_commands();
+
+      character_updater.update(step_time);
+      for (const auto& contact : character_updater.get_contacts()) {
+        if (!character_contacts.try_push(contact))
+          break; // Game thread isn't keeping up, drop the rest
+      }
+
+      Physics::step(step_time);
+
+      step_count++;
+      publish_snapshot();
+    }
+
+    next_step += step_time;
+    const double current = now();
+    if (current - next_step > step_time * max_lag_steps)
+      next_step = current;
+    else if (next_step > current)
+      std::this_thread::sleep_for(std::chrono::duration<double>(next_step - current));
+  }
+
+  // Flush whatever is left so removals are done before the scene destroys the bodies.
+  execute_commands();
+
+  task_scheduler->deregister_external_thread();
+}
+
+void PhysicsThread::execute_commands() {
+  OX_SCOPED_ZONE;
+
+  PhysicsCommand command;
+  while (commands.try_pop(command))
+    execute_physics_command(command, character_updater);
+}
+
+void PhysicsThread::publish_snapshot() {
+  OX_SCOPED_ZONE;
+
+  const auto* physics_system = Physics::get_physics_system();
+
+  static thread_local JPH::BodyIDVector active_bodies = {};
+  physics_system->GetActiveBodies(JPH::EBodyType::RigidBody, active_bodies);
+
+  auto& snapshot = snapshots.get_write_buffer();
+  snapshot.step = step_count;
+  snapshot.transforms.clear();
+  snapshot.transforms.reserve(active_bodies.size() + character_updater.size());
+
+  // The game thread still runs queries and creates bodies while this runs, so the reads have to lock.
+  const auto& lock_interface = physics_system->GetBodyLockInterface();
+  for (const auto& id : active_bodies) {
+    JPH::BodyLockRead lock(lock_interface, id);
+    if (!lock.Succeeded())
+      continue;
+
+    const JPH::Body& body = lock.GetBody();
+    const JPH::Vec3 position = body.GetPosition();
+    const JPH::Quat rotation = body.GetRotation();
+    snapshot.transforms.emplace_back(PhysicsSnapshot::BodyTransform{
+      .entity = static_cast<entt::entity>(body.GetUserData()),
+      .position = {position.GetX(), position.GetY(), position.GetZ()},
+      .rotation = Quat(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ()),
+    });
+  }
+
+  // Published before the snapshot, so the game thread never sees one of these after a snapshot that's newer than it.
+  JPH::BodyID body_id;
+  while (activation_listener->PopDeactivatedBody(body_id)) {
+    JPH::BodyLockRead lock(lock_interface, body_id);
+    if (!lock.Succeeded() || lock.GetBody().IsActive())
+      continue;
+
+    const JPH::Body& body = lock.GetBody();
+    const JPH::Vec3 position = body.GetPosition();
+    const JPH::Quat rotation = body.GetRotation();
+    if (!sleeping_bodies.try_push(PhysicsSnapshot::BodyTransform{
+          .entity = static_cast<entt::entity>(body.GetUserData()),
+          .position = {position.GetX(), position.GetY(), position.GetZ()},
+          .rotation = Quat(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ()),
+        }))
+      break; // Game thread isn't keeping up, leave the rest for the next step
+  }
+
+  for (const auto& state : character_updater.get_states()) {
+    snapshot.transforms.emplace_back(PhysicsSnapshot::BodyTransform{
+      .entity = state.entity,
+      .position = state.position,
+      .rotation = state.rotation,
+      .grounded = state.grounded,
+    });
+  }
+
+  snapshot.time = now();
+  snapshots.publish();
+}
+}
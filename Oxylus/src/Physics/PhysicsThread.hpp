@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <entt/entity/entity.hpp>
+
+#include "CharacterUpdater.hpp"
+#include "PhysicsCommand.hpp"
+#include "PhysicsInterfaces.hpp"
+
+#include "Core/Types.hpp"
+
+#include "Thread/LockFreeQueue.hpp"
+#include "Thread/TripleBuffer.hpp"
+
+namespace ox {
+struct PhysicsSnapshot {
+  struct BodyTransform {
+    entt::entity entity = entt::null;
+    Vec3 position = {};
+    Quat rotation = {};
+    bool grounded = false; // Characters only
+  };
+
+  uint64_t step = 0;
+  double time = 0.0; // seconds, steady clock time the step finished
+  std::vector<BodyTransform> transforms = {};
+};
+
+/// Runs the fixed-step physics loop on its own thread.
+/// The game thread pushes commands and reads the latest published snapshot, neither side blocks the other.
+class PhysicsThread {
+public:
+  static constexpr uint32_t COMMAND_QUEUE_SIZE = 4096;
+  static constexpr uint32_t CONTACT_QUEUE_SIZE = 1024;
+  static constexpr uint32_t SLEEPING_QUEUE_SIZE = 4096;
+
+  PhysicsThread(float step_rate, Physics3DBodyActivationListener* activation_listener);
+  ~PhysicsThread();
+
+  void start();
+  void stop();
+  bool is_running() const { return running.load(std::memory_order_relaxed); }
+
+  void push_command(const PhysicsCommand& command) { commands.push(command); }
+
+  /// Swaps in the newest snapshot if there is one. Returns true if a new one was acquired.
+  bool acquire_snapshot() { return snapshots.acquire(); }
+  const PhysicsSnapshot& get_snapshot() const { return snapshots.get_read_buffer(); }
+
+  /// New character contacts, filled by the physics thread and drained by the game thread.
+  bool pop_character_contact(CharacterContact& contact) { return character_contacts.try_pop(contact); }
+
+  /// Final transforms of bodies that went to sleep, they aren't in the snapshots anymore until they wake up.
+  /// Drain these before acquiring the snapshot so a newer snapshot wins for bodies that woke up again.
+  bool pop_sleeping_body(PhysicsSnapshot::BodyTransform& body) { return sleeping_bodies.try_pop(body); }
+
+  float get_step_time() const { return step_time; }
+
+  static double now();
+
+private:
+  float step_time;
+  std::thread thread;
+  std::atomic<bool> running = false;
+
+  LockFreeQueue<PhysicsCommand> commands;
+  LockFreeQueue<CharacterContact> character_contacts;
+  LockFreeQueue<PhysicsSnapshot::BodyTransform> sleeping_bodies;
+  TripleBuffer<PhysicsSnapshot> snapshots = {};
+
+  // Only touched by the physics thread
+  Physics3DBodyActivationListener* activation_listener = nullptr;
+  CharacterUpdater character_updater = {};
+  uint64_t step_count = 0;
+
+  void run();
+  void execute_commands();
+  void publish_snapshot();
+};
+}
@@ -180,8 +180,9 @@ void DebugRenderer::draw_aabb(const AABB& aabb, const Vec4& color, bool corners_
   }
 }
 
-std::pair<std::vector<Vertex>, uint32_t> DebugRenderer::get_vertices_from_lines(const std::vector<LineInfo>& lines) {
-  std::vector<Vertex> vertices = {};
+std::pair<FrameVector<Vertex>, uint32_t> DebugRenderer::get_vertices_from_lines(const std::vector<LineInfo>& lines) {
+  auto vertices = make_frame_vector<Vertex>();
+  vertices.reserve(lines.size() * 2);
   uint32_t indices = 0;
 
   for (const auto& line : lines) {
@@ -192,6 +193,6 @@ std::pair<std::vector<Vertex>, uint32_t> DebugRenderer::get_vertices_from_lines(
     indices += 2;
   }
 
-  return {vertices, indices};
+  return {std::move(vertices), indices};
 }
 }
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "Core/FrameAllocator.hpp"
 #include "Core/Types.hpp"
 #include "Mesh.h"
 
@@ -68,7 +69,8 @@ public:
 
   const vuk::Unique<vuk::Buffer>& get_global_index_buffer() const { return debug_renderer_context.index_buffer; }
 
-  static std::pair<std::vector<Vertex>, uint32_t> get_vertices_from_lines(const std::vector<LineInfo>& lines);
+  /// The vertices are allocated from the frame allocator.
+  static std::pair<FrameVector<Vertex>, uint32_t> get_vertices_from_lines(const std::vector<LineInfo>& lines);
 
 private:
   static DebugRenderer* instance;
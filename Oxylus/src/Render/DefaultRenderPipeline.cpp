@@ -277,7 +277,7 @@ DefaultRenderPipeline::CameraData DefaultRenderPipeline::get_main_camera_data()
 
 void DefaultRenderPipeline::create_dir_light_cameras(const LightComponent& light,
                                                      Camera& camera,
-                                                     std::vector<CameraSH>& camera_data,
+                                                     std::span<CameraSH> camera_data,
                                                      uint32_t cascade_count) {
   OX_SCOPED_ZONE;
 
@@ -389,7 +389,7 @@ void DefaultRenderPipeline::update_frame_data(vuk::Allocator& allocator) {
   auto [scene_buff, scene_buff_fut] = create_cpu_buffer(allocator, std::span(&scene_data, 1));
   const auto& scene_buffer = *scene_buff;
 
-  std::vector<Material::Parameters> material_parameters = {};
+  auto material_parameters = make_frame_vector<Material::Parameters>();
   for (auto& mesh : mesh_component_list) {
     auto& materials = mesh.materials;
     for (auto& mat : materials) {
@@ -445,14 +445,14 @@ void DefaultRenderPipeline::update_frame_data(vuk::Allocator& allocator) {
     light.shadow_atlas_mul_add.w = lc.shadow_rect.y * atlas_dim_rcp.y;
   }
 
-  std::vector<ShaderEntity> shader_entities = {};
+  auto shader_entities = make_frame_vector<ShaderEntity>();
 
   for (uint32_t light_index = 0; light_index < light_datas.size(); ++light_index) {
     auto& light = light_datas[light_index];
     const auto& lc = scene_lights[light_index];
 
     if (lc.cast_shadows) {
-      auto sh_cameras = std::vector<CameraSH>(light.cascade_count);
+      auto sh_cameras = make_frame_vector<CameraSH>(light.cascade_count);
       create_dir_light_cameras(lc, *current_camera, sh_cameras, light.cascade_count);
 
       light.matrix_index = (uint32_t)shader_entities.size();
@@ -471,7 +471,7 @@ void DefaultRenderPipeline::update_frame_data(vuk::Allocator& allocator) {
   auto [lights_buff, lights_buff_fut] = create_cpu_buffer(allocator, std::span(light_datas));
   const auto& lights_buffer = *lights_buff;
 
-  std::vector<MeshInstance> mesh_instances = {};
+  auto mesh_instances = make_frame_vector<MeshInstance>();
   mesh_instances.reserve(mesh_component_list.size());
   for (const auto& mc : mesh_component_list) {
     mesh_instances.emplace_back(mc.transform);
@@ -1064,12 +1064,13 @@ void DefaultRenderPipeline::shadow_pass(const Shared<vuk::RenderGraph>& rg) {
       switch (light.type) {
         case LightComponent::Directional: {
           const uint32_t cascade_count = std::min((uint32_t)light.cascade_distances.size(), max_viewport_count);
-          auto viewports = std::vector<vuk::Viewport>(cascade_count);
-          auto cameras = std::vector<CameraData>(cascade_count);
-          auto sh_cameras = std::vector<CameraSH>(cascade_count);
+          auto viewports = make_frame_vector<vuk::Viewport>(cascade_count);
+          auto cameras = make_frame_vector<CameraData>(cascade_count);
+          auto sh_cameras = make_frame_vector<CameraSH>(cascade_count);
           create_dir_light_cameras(light, *current_camera, sh_cameras, cascade_count);
 
-          RenderQueue shadow_queue = {};
+          RenderQueue shadow_queue(FrameAllocator::get_resource());
+          shadow_queue.batches.reserve(render_queue.size());
           uint32_t batch_index = 0;
           for (auto& batch : render_queue.batches) {
             // Determine which cascades the object is contained in:
@@ -1707,7 +1708,7 @@ void DefaultRenderPipeline::debug_pass(const Shared<vuk::RenderGraph>& rg,
   };
 
   const auto* camera = current_camera;
-  std::vector<DebugPassData> buffers = {};
+  auto buffers = make_frame_vector<DebugPassData>();
 
   DebugPassData data = {.vp = camera->get_projection_matrix() * camera->get_view_matrix(), .model = glm::identity<Mat4>(), .color = Vec4(0, 1, 0, 1)};
 
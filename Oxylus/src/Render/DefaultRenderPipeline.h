@@ -1,8 +1,12 @@
 ﻿#pragma once
 
+#include <span>
+
 #include "RenderPipeline.h"
 #include "RendererConfig.h"
 
+#include "Core/FrameAllocator.hpp"
+
 #include "Passes/GTAO.hpp"
 #include "vuk/CommandBuffer.hpp"
 
@@ -28,6 +32,14 @@ public:
   void register_light(const LightComponent& light) override;
   void register_camera(Camera* camera) override;
 
+  struct CameraSH {
+    Mat4 projection_view;
+    Frustum frustum;
+  };
+
+  /// Fits one shadow camera per cascade of a directional light around the camera's frustum. CPU only.
+  static void create_dir_light_cameras(const LightComponent& light, Camera& camera, std::span<CameraSH> camera_data, uint32_t cascade_count);
+
 private:
   Camera* current_camera = nullptr;
 
@@ -92,11 +104,6 @@ private:
 
   std::vector<LightData> light_datas;
 
-  struct CameraSH {
-    Mat4 projection_view;
-    Frustum frustum;
-  };
-
   struct CameraData {
     Vec4 position = {};
 
@@ -310,8 +317,11 @@ private:
     }
   };
 
+  /// The scene's queue lives across update and render and keeps its capacity, temporary queues use the frame allocator.
   struct RenderQueue {
-    std::vector<RenderBatch> batches = {};
+    std::pmr::vector<RenderBatch> batches;
+
+    explicit RenderQueue(std::pmr::memory_resource* resource = Memory::get_resource(MemoryTag::Renderer)) : batches(resource) {}
 
     void clear() { batches.clear(); }
 
@@ -353,7 +363,6 @@ private:
   void clear();
   void bind_camera_buffer(vuk::CommandBuffer& command_buffer);
   CameraData get_main_camera_data() const;
-  void create_dir_light_cameras(const LightComponent& light, Camera& camera, std::vector<CameraSH>& camera_data, uint32_t cascade_count);
   void update_frame_data(vuk::Allocator& allocator);
   void create_static_resources(vuk::Allocator& allocator);
   void create_dynamic_textures(vuk::Allocator& allocator, const vuk::Dimension3D& dim);
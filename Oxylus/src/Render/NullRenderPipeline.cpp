@@ -0,0 +1,70 @@
+#include "NullRenderPipeline.h"
+
+#include "Camera.hpp"
+#include "DefaultRenderPipeline.h"
+
+#include "Core/FrameAllocator.hpp"
+
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+void NullRenderPipeline::on_render_headless() {
+  OX_SCOPED_ZONE;
+
+  FrameStats stats = {};
+  stats.registered_meshes = (uint32_t)mesh_component_list.size();
+  stats.lights = (uint32_t)scene_lights.size();
+
+  Frustum frustum = {};
+  if (current_camera) {
+    frustum = current_camera->get_frustum();
+    frustum.init();
+  }
+
+  // Same data DefaultRenderPipeline::update_frame_data builds before uploading it.
+  auto mesh_instances = make_frame_vector<Mat4>();
+  auto material_parameters = make_frame_vector<Material::Parameters>();
+  mesh_instances.reserve(mesh_component_list.size());
+  for (const auto& mc : mesh_component_list) {
+    if (current_camera && !mc.aabb.is_on_frustum(frustum))
+      continue;
+
+    mesh_instances.emplace_back(mc.transform);
+    for (const auto& material : mc.materials)
+      material_parameters.emplace_back(material->parameters);
+  }
+  stats.visible_meshes = (uint32_t)mesh_instances.size();
+  stats.materials = (uint32_t)material_parameters.size();
+
+  if (current_camera) {
+    for (const auto& lc : scene_lights) {
+      if (lc.type != LightComponent::Directional || !lc.cast_shadows)
+        continue;
+
+      const auto cascade_count = (uint32_t)lc.cascade_distances.size();
+      auto sh_cameras = make_frame_vector<DefaultRenderPipeline::CameraSH>(cascade_count);
+      DefaultRenderPipeline::create_dir_light_cameras(lc, *current_camera, sh_cameras, cascade_count);
+      stats.shadow_cascades += cascade_count;
+    }
+  }
+
+  last_frame_stats = stats;
+  mesh_component_list.clear();
+  scene_lights.clear();
+}
+
+void NullRenderPipeline::register_mesh_component(const MeshComponent& render_object) {
+  OX_SCOPED_ZONE;
+  mesh_component_list.emplace_back(render_object);
+}
+
+void NullRenderPipeline::register_light(const LightComponent& light) {
+  OX_SCOPED_ZONE;
+  scene_lights.emplace_back(light);
+}
+
+void NullRenderPipeline::register_camera(Camera* camera) {
+  OX_SCOPED_ZONE;
+  current_camera = camera;
+}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "RenderPipeline.h"
+
+namespace ox {
+/// Pipeline for headless apps. Collects what the scene registers like DefaultRenderPipeline and does the CPU side of a frame:
+/// frustum culling, mesh instance and material packing and directional shadow cascades. Nothing is recorded or uploaded.
+class NullRenderPipeline : public RenderPipeline {
+public:
+  struct FrameStats {
+    uint32_t registered_meshes = 0;
+    uint32_t visible_meshes = 0;
+    uint32_t materials = 0;
+    uint32_t lights = 0;
+    uint32_t shadow_cascades = 0;
+  };
+
+  explicit NullRenderPipeline(const std::string& name) : RenderPipeline(name) {}
+
+  ~NullRenderPipeline() override = default;
+
+  void init(vuk::Allocator& allocator) override {}
+  void shutdown() override {}
+
+  Unique<vuk::Future> on_render(vuk::Allocator& frame_allocator, const vuk::Future& target, vuk::Dimension3D dim) override { return nullptr; }
+  void on_render_headless() override;
+
+  void register_mesh_component(const MeshComponent& render_object) override;
+  void register_light(const LightComponent& light) override;
+  void register_camera(Camera* camera) override;
+
+  /// What the last on_render_headless would have drawn, for perf tests and servers that want to sanity check a scene.
+  const FrameStats& get_last_frame_stats() const { return last_frame_stats; }
+
+private:
+  Camera* current_camera = nullptr;
+  std::vector<MeshComponent> mesh_component_list = {};
+  std::vector<LightComponent> scene_lights = {};
+  FrameStats last_frame_stats = {};
+};
+}
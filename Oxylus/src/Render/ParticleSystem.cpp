@@ -3,9 +3,10 @@
 #include <glm/gtx/norm.hpp>
 
 #include "Utils/Profiler.hpp"
+#include "Utils/Random.hpp"
 
 namespace ox {
-ParticleSystem::ParticleSystem() : particles(10000) {
+ParticleSystem::ParticleSystem() : particles(10000), random(Random::create_generator()) {
   if (properties.play_on_awake)
     play();
 
@@ -118,11 +119,6 @@ void ParticleSystem::on_render() const {
   }
 }
 
-static float RandomFloat(float min, float max) {
-  const float r = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
-  return min + r * (max - min);
-}
-
 void ParticleSystem::emit(const glm::vec3& position, uint32_t count) {
   if (active_particle_count >= properties.max_particles)
     return;
@@ -134,9 +130,7 @@ void ParticleSystem::emit(const glm::vec3& position, uint32_t count) {
     auto& particle = particles[pool_index];
 
     particle.position = position;
-    particle.position.x += RandomFloat(properties.position_start.x, properties.position_end.x);
-    particle.position.y += RandomFloat(properties.position_start.y, properties.position_end.y);
-    particle.position.z += RandomFloat(properties.position_start.z, properties.position_end.z);
+    particle.position += random.get_vec3(properties.position_start, properties.position_end);
 
     particle.life_remaining = properties.start_lifetime;
   }
@@ -4,6 +4,7 @@
 #include <glm/gtx/compatibility.hpp>
 
 #include "Utils/OxMath.hpp"
+#include "Utils/Random.hpp"
 #include "Core/Base.hpp"
 
 namespace ox {
@@ -99,6 +100,7 @@ private:
   std::vector<Particle> particles;
   uint32_t pool_index = 0;
   ParticleProperties properties;
+  RandomGenerator random;
 
   float system_time = 0.0f;
   float burst_time = 0.0f;
@@ -25,6 +25,8 @@ public:
   virtual void shutdown() = 0;
 
   virtual Unique<vuk::Future> on_render(vuk::Allocator& frame_allocator, const vuk::Future& target, vuk::Dimension3D dim) = 0;
+  /// Called instead of on_render by headless apps. Does the frame's CPU work, then drops what was registered for it.
+  virtual void on_render_headless() {}
 
   virtual void on_dispatcher_events(EventDispatcher& dispatcher) {}
 
@@ -1,10 +1,12 @@
 #include "Renderer.hpp"
 
 #include <future>
+#include <optional>
 #include <vuk/Partials.hpp>
 
 #include "Thread/TaskScheduler.hpp"
 #include "UI/ImGuiLayer.hpp"
+#include "Utils/FrameStats.hpp"
 #include "Utils/Profiler.hpp"
 #include "Assets/AssetManager.hpp"
 #include "Core/LayerStack.hpp"
@@ -47,6 +49,8 @@ void Renderer::draw(VkContext* context, ImGuiLayer* imgui_layer, LayerStack& lay
     return;
   }
 
+  std::optional<FrameStats::PhaseScope> render_graph_phase(std::in_place, FramePhase::RenderGraph);
+
   imgui_layer->begin();
 
   auto frame_allocator = context->begin();
@@ -66,11 +70,14 @@ void Renderer::draw(VkContext* context, ImGuiLayer* imgui_layer, LayerStack& lay
     const auto cleared_image = vuk::Future{std::move(rg), "target_image"};
     fut = *rp->on_render(frame_allocator, cleared_image, dim);
 
-    for (const auto& layer : layer_stack)
-      layer->on_imgui_render();
-    for (auto& [_, system] : App::get_system_registry())
-      system->imgui_update();
-    imgui_layer->end();
+    {
+      FrameStats::PhaseScope ui_phase(FramePhase::UI);
+      for (const auto& layer : layer_stack)
+        layer->on_imgui_render();
+      for (auto* system : App::get_systems())
+        system->imgui_update();
+      imgui_layer->end();
+    }
 
     fut = imgui_layer->render_draw_data(frame_allocator, fut, ImGui::GetDrawData());
   }
@@ -119,17 +126,31 @@ void Renderer::draw(VkContext* context, ImGuiLayer* imgui_layer, LayerStack& lay
     rg->attach_in(rp->get_rg_futures());
     rp->get_rg_futures().clear();
 
-    for (const auto& layer : layer_stack)
-      layer->on_imgui_render();
+    {
+      FrameStats::PhaseScope ui_phase(FramePhase::UI);
+      for (const auto& layer : layer_stack)
+        layer->on_imgui_render();
 
-    for (auto& [_, system] : App::get_system_registry())
-      system->imgui_update();
+      for (auto* system : App::get_systems())
+        system->imgui_update();
 
-    imgui_layer->end();
+      imgui_layer->end();
+    }
 
     fut = imgui_layer->render_draw_data(frame_allocator, vuk::Future{std::move(rg), "target_image"}, ImGui::GetDrawData());
   }
 
+  render_graph_phase.reset();
+
+  FrameStats::PhaseScope submit_phase(FramePhase::Submit);
   context->end(fut, frame_allocator);
 }
+
+void Renderer::draw_headless() {
+  OX_SCOPED_ZONE;
+  FrameStats::PhaseScope phase(FramePhase::RenderGraph);
+
+  if (const auto rp = renderer_context.render_pipeline)
+    rp->on_render_headless();
+}
 } // namespace ox
@@ -26,6 +26,7 @@ public:
   static void deinit();
 
   static void draw(VkContext* context, ImGuiLayer* imgui_layer, LayerStack& layer_stack);
+  static void draw_headless();
 
   static UVec2 get_viewport_size() { return renderer_context.viewport_size; }
   static Vec2 get_viewport_offset() { return renderer_context.viewport_offset; }
@@ -3,7 +3,6 @@
 #include <fstream>
 #include <sstream>
 
-#include "Thread/TaskScheduler.hpp"
 #include "Core/App.hpp"
 #include "Core/FileSystem.hpp"
 
@@ -12,13 +11,9 @@
 
 namespace ox {
 void RendererConfig::init() {
-  auto* task_scheduler = App::get_system<TaskScheduler>();
-  task_scheduler->add_task([this]() {
-    if (!load_config("renderer_config.toml"))
-      save_config("renderer_config.toml");
-  });
-
-  task_scheduler->wait_for_all();
+  // Runs on a worker during the app's system init, where waiting for all tasks isn't allowed.
+  if (!load_config("renderer_config.toml"))
+    save_config("renderer_config.toml");
 }
 
 void RendererConfig::deinit() { save_config("renderer_config.toml"); }
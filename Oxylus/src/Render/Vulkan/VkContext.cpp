@@ -45,7 +45,7 @@ static VkBool32 DebugCallback(const VkDebugUtilsMessageSeverityFlagBitsEXT messa
     OX_LOG_INFO("{}", debug_message.str());
   }
   else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
-    OX_LOG_WARN(debug_message.str().c_str());
+    OX_LOG_WARN("{}", debug_message.str());
     OX_DEBUGBREAK();
   }
   else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
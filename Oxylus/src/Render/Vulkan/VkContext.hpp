@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Core/Base.hpp"
+#include "Core/FrameAllocator.hpp"
 
 #include <optional>
 
@@ -38,7 +39,7 @@ public:
   VkSurfaceKHR surface;
   vkb::Instance vkb_instance;
   vkb::Device vkb_device;
-  uint32_t num_inflight_frames = 3;
+  uint32_t num_inflight_frames = FrameAllocator::FRAMES_IN_FLIGHT;
   uint64_t num_frames = 0;
   uint32_t current_frame = 0;
   vuk::Unique<std::array<VkSemaphore, 3>> present_ready;
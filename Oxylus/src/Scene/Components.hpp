@@ -15,7 +15,7 @@
 #include "Scripting/LuaSystem.hpp"
 
 namespace JPH {
-class Character;
+class CharacterVirtual;
 }
 
 namespace ox {
@@ -232,7 +232,7 @@ struct MeshColliderComponent {
 };
 
 struct CharacterControllerComponent {
-  Shared<JPH::Character> character = nullptr;
+  Shared<JPH::CharacterVirtual> character = nullptr;
 
   // Size
   float character_height_standing = 1.35f;
@@ -262,6 +262,16 @@ struct CharacterControllerComponent {
   float friction = 6.0f;
   float gravity = 20;
   float collision_tolerance = 0.05f;
+  float max_slope_angle = 45.0f; // Degrees
+  float max_step_height = 0.4f;
+  float stick_to_floor_distance = 0.5f;
+  float mass = 70.0f;
+  float max_strength = 100.0f; // Max force the character pushes dynamic bodies with
+
+  // Runtime
+  Vec3 velocity = Vec3(0.0f); // Set by gameplay, horizontal movement and a positive y to jump once with jump_force
+  Vec3 applied_velocity = Vec3(0.0f);
+  bool grounded = false;
 
   // For interpolation/extrapolation
   Vec3 previous_translation = Vec3(0.0f);
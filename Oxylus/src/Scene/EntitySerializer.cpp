@@ -20,6 +20,10 @@ namespace ox {
 #define GET_STRING(node, component, name) component.name = node->as_table()->get(#name)->as_string()->get()
 #define GET_STRING2(node, name) node->as_table()->get(name)->as_string()->get()
 #define GET_FLOAT(node, component, name) component.name = (float)node->as_table()->get(#name)->as_floating_point()->get()
+// For fields added after scenes were already saved without them
+#define GET_FLOAT_OPT(node, component, name) \
+  if (const auto field_node = node->as_table()->get(#name)) \
+  component.name = (float)field_node->as_floating_point()->get()
 #define GET_FLOAT2(node, name) (float)node->as_table()->get(name)->as_floating_point()->get()
 #define GET_UINT32(node, component, name) component.name = (uint32_t)node->as_table()->get(#name)->as_integer()->get()
 #define GET_UINT322(node, name) (uint32_t) node->as_table()->get(name)->as_integer()->get()
@@ -243,6 +247,11 @@ void EntitySerializer::serialize_entity(toml::array* entities, Scene* scene, Ent
       TBL_FIELD(component, jump_force),
       TBL_FIELD(component, friction),
       TBL_FIELD(component, collision_tolerance),
+      TBL_FIELD(component, max_slope_angle),
+      TBL_FIELD(component, max_step_height),
+      TBL_FIELD(component, stick_to_floor_distance),
+      TBL_FIELD(component, mass),
+      TBL_FIELD(component, max_strength),
     };
 
     entities->push_back(toml::table{{"character_controller_component", table}});
@@ -402,6 +411,11 @@ UUID EntitySerializer::deserialize_entity(toml::array* entity_arr, Scene* scene,
       GET_FLOAT(chc_node, chc, jump_force);
       GET_FLOAT(chc_node, chc, friction);
       GET_FLOAT(chc_node, chc, collision_tolerance);
+      GET_FLOAT_OPT(chc_node, chc, max_slope_angle);
+      GET_FLOAT_OPT(chc_node, chc, max_step_height);
+      GET_FLOAT_OPT(chc_node, chc, stick_to_floor_distance);
+      GET_FLOAT_OPT(chc_node, chc, mass);
+      GET_FLOAT_OPT(chc_node, chc, max_strength);
     } else if (const auto lua_node = ent.as_table()->get("lua_script_component")) {
       auto& lsc = reg.emplace<LuaScriptComponent>(deserialized_entity);
       auto paths = GET_ARRAY(lua_node, "paths");
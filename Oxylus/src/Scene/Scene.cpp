@@ -1,6 +1,8 @@
 #include "Scene.hpp"
 
 #include "Utils/Profiler.hpp"
+#include "Utils/Archive.hpp"
+#include "Utils/FrameStats.hpp"
 #include "Utils/Timestep.hpp"
 #include "Entity.hpp"
 #include "Render/Camera.hpp"
@@ -21,7 +23,7 @@
 #include "Jolt/Jolt.h"
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
 
-#include "Jolt/Physics/Character/Character.h"
+#include "Jolt/Physics/Character/CharacterVirtual.h"
 #include "Jolt/Physics/Collision/Shape/BoxShape.h"
 #include "Jolt/Physics/Collision/Shape/CapsuleShape.h"
 #include "Jolt/Physics/Collision/Shape/CylinderShape.h"
@@ -33,6 +35,9 @@
 
 #include "Physics/Physics.hpp"
 #include "Physics/PhysicsMaterial.hpp"
+#include "Physics/CharacterUpdater.hpp"
+#include "Physics/PhysicsRecording.hpp"
+#include "Physics/PhysicsThread.hpp"
 
 #include "Render/RenderPipeline.h"
 
@@ -52,9 +57,12 @@ Scene::Scene(const Shared<RenderPipeline>& render_pipeline) {
 }
 
 Scene::~Scene() {
-  App::get_system<LuaManager>()->get_state()->collect_gc();
   if (running)
     on_runtime_stop();
+
+  // The only full collection a scene does. Script objects still referencing this scene's registry have to be
+  // finalized while it's alive, and unloading a scene is already a hitch. Runtime stops leave it to the budgeted steps.
+  App::get_system<LuaManager>()->get_state()->collect_gc();
 }
 
 Scene::Scene(const Scene& scene) {
@@ -69,6 +77,10 @@ void Scene::rigidbody_component_ctor(entt::registry& reg, entt::entity entity) {
   create_rigidbody(entity, reg.get<TransformComponent>(entity), component);
 }
 
+void Scene::rigidbody_component_dtor(entt::registry& reg, entt::entity entity) {
+  destroy_rigidbody(reg.get<RigidbodyComponent>(entity));
+}
+
 void Scene::collider_component_ctor(entt::registry& reg, entt::entity entity) {
   if (reg.all_of<RigidbodyComponent>(entity))
     create_rigidbody(entity, reg.get<TransformComponent>(entity), reg.get<RigidbodyComponent>(entity));
@@ -76,7 +88,14 @@ void Scene::collider_component_ctor(entt::registry& reg, entt::entity entity) {
 
 void Scene::character_controller_component_ctor(entt::registry& reg, entt::entity entity) const {
   auto& component = reg.get<CharacterControllerComponent>(entity);
-  create_character_controller(reg.get<TransformComponent>(entity), component);
+  create_character_controller(entity, reg.get<TransformComponent>(entity), component);
+}
+
+void Scene::character_controller_component_dtor(entt::registry& reg, entt::entity entity) const {
+  if (physics_thread)
+    physics_thread->push_command({.type = PhysicsCommand::Type::RemoveCharacter, .entity = entity});
+  else if (character_updater)
+    character_updater->remove(entity);
 }
 
 void Scene::init(const Shared<RenderPipeline>& render_pipeline) {
@@ -84,6 +103,7 @@ void Scene::init(const Shared<RenderPipeline>& render_pipeline) {
 
   // ctors
   registry.on_construct<RigidbodyComponent>().connect<&Scene::rigidbody_component_ctor>(this);
+  registry.on_destroy<RigidbodyComponent>().connect<&Scene::rigidbody_component_dtor>(this);
   registry.on_construct<BoxColliderComponent>().connect<&Scene::collider_component_ctor>(this);
   registry.on_construct<SphereColliderComponent>().connect<&Scene::collider_component_ctor>(this);
   registry.on_construct<CapsuleColliderComponent>().connect<&Scene::collider_component_ctor>(this);
@@ -91,6 +111,7 @@ void Scene::init(const Shared<RenderPipeline>& render_pipeline) {
   registry.on_construct<CylinderColliderComponent>().connect<&Scene::collider_component_ctor>(this);
   registry.on_construct<MeshColliderComponent>().connect<&Scene::collider_component_ctor>(this);
   registry.on_construct<CharacterControllerComponent>().connect<&Scene::character_controller_component_ctor>(this);
+  registry.on_destroy<CharacterControllerComponent>().connect<&Scene::character_controller_component_dtor>(this);
   
   // Renderer
   scene_renderer = create_shared<SceneRenderer>(this);
@@ -154,17 +175,57 @@ Entity Scene::load_mesh(const Shared<Mesh>& mesh) {
   return parent == entt::null ? node_entities.front() : parent;
 }
 
+static uint8_t get_object_layer(const TagComponent& tag) {
+  const auto collision_mask_it = Physics::layer_collision_mask.find(tag.layer);
+  return collision_mask_it != Physics::layer_collision_mask.end() ? collision_mask_it->second.index : 1; // Default Layer
+}
+
+template <typename T>
+static void store_body_transform(T& component, const Vec3& position, const Quat& rotation) {
+  component.previous_translation = component.translation;
+  component.previous_rotation = component.rotation;
+  component.translation = position;
+  component.rotation = rotation;
+}
+
+template <typename T>
+static void apply_body_transform(const T& component, TransformComponent& tc, const float interpolation_factor) {
+  if (component.interpolation) {
+    tc.position = glm::lerp(component.previous_translation, component.translation, interpolation_factor);
+    tc.rotation = glm::eulerAngles(glm::slerp(component.previous_rotation, component.rotation, interpolation_factor));
+  }
+  else {
+    tc.position = component.translation;
+    tc.rotation = glm::eulerAngles(component.rotation);
+  }
+}
+
 void Scene::update_physics(const Timestep& delta_time) {
   OX_SCOPED_ZONE;
-  // Minimum stable value is 16.0
-  constexpr float physics_step_rate = 50.0f;
-  constexpr float physics_ts = 1.0f / physics_step_rate;
+  if (physics_thread) {
+    update_physics_threaded(delta_time);
+    return;
+  }
+
+  constexpr float physics_ts = 1.0f / Physics::STEP_RATE;
+
+  sync_character_velocities();
 
   bool stepped = false;
   physics_frame_accumulator += (float)delta_time.get_seconds();
 
   while (physics_frame_accumulator >= physics_ts) {
+    // Commands are applied right before the step, in the same order a PhysicsRecording replays them.
+    if (physics_recording)
+      physics_recording->record_step(physics_step, physics_commands);
+    for (auto& command : physics_commands)
+      execute_physics_command(command, *character_updater);
+    physics_commands.clear();
+
+    update_characters(physics_ts);
     Physics::step(physics_ts);
+    physics_step++;
+    dispatch_body_contacts();
 
     {
       OX_SCOPED_ZONE_N("OnFixedUpdate Systems");
@@ -180,6 +241,19 @@ void Scene::update_physics(const Timestep& delta_time) {
   const float interpolation_factor = physics_frame_accumulator / physics_ts;
 
   const auto& body_interface = Physics::get_physics_system()->GetBodyInterface();
+
+  // Inactive bodies are skipped below, so bodies that just fell asleep get their final transform here.
+  JPH::BodyID sleeping_id;
+  while (body_activation_listener_3d->PopDeactivatedBody(sleeping_id)) {
+    if (!body_interface.IsAdded(sleeping_id) || body_interface.IsActive(sleeping_id))
+      continue;
+    const JPH::Vec3 position = body_interface.GetPosition(sleeping_id);
+    const JPH::Quat rotation = body_interface.GetRotation(sleeping_id);
+    write_back_sleeping_body(static_cast<entt::entity>(body_interface.GetUserData(sleeping_id)),
+                             {position.GetX(), position.GetY(), position.GetZ()},
+                             Quat(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ()));
+  }
+
   const auto view = registry.group<RigidbodyComponent>(entt::get<TransformComponent>);
   for (auto&& [e, rb, tc] : view.each()) {
     if (!rb.runtime_body)
@@ -219,36 +293,278 @@ void Scene::update_physics(const Timestep& delta_time) {
 
   // Character
   {
+    if (stepped) {
+      for (const auto& state : character_updater->get_states()) {
+        // Might have been removed by a fixed update system after the characters were updated
+        auto* ch = registry.try_get<CharacterControllerComponent>(state.entity);
+        if (!ch)
+          continue;
+        store_body_transform(*ch, state.position, state.rotation);
+        ch->grounded = state.grounded;
+      }
+    }
+
     const auto ch_view = registry.view<TransformComponent, CharacterControllerComponent>();
     for (auto&& [e, tc, ch] : ch_view.each()) {
-      ch.character->PostSimulation(ch.collision_tolerance);
-      if (ch.interpolation) {
-        if (stepped) {
-          JPH::Vec3 position = ch.character->GetPosition();
-          JPH::Vec3 rotation = ch.character->GetRotation().GetEulerAngles();
-
-          ch.previous_translation = ch.translation;
-          ch.previous_rotation = ch.rotation;
-          ch.translation = {position.GetX(), position.GetY(), position.GetZ()};
-          ch.rotation = Vec3(rotation.GetX(), rotation.GetY(), rotation.GetZ());
-        }
+      if (ch.character)
+        apply_body_transform(ch, tc, interpolation_factor);
+    }
+  }
+}
+
+void Scene::update_characters(const float delta_time) {
+  OX_SCOPED_ZONE;
+
+  character_updater->update(delta_time);
+
+  for (const auto& contact : character_updater->get_contacts())
+    dispatch_character_contact(contact);
+}
+
+void Scene::sync_character_velocities() {
+  // Only send velocities that changed, crowds of idle characters shouldn't flood the command queue
+  const auto ch_view = registry.view<CharacterControllerComponent>();
+  for (auto&& [e, ch] : ch_view.each()) {
+    if (ch.velocity != ch.applied_velocity) {
+      push_physics_command({.type = PhysicsCommand::Type::SetCharacterVelocity, .vector = ch.velocity, .entity = e});
+      // The jump is consumed by the physics step, gameplay sets y again to request the next one
+      ch.velocity.y = 0.0f;
+      ch.applied_velocity = ch.velocity;
+    }
+  }
+}
+
+void Scene::push_physics_command(const PhysicsCommand& command) {
+  if (physics_thread)
+    physics_thread->push_command(command);
+  else
+    physics_commands.emplace_back(command);
+}
+
+bool Scene::push_body_command(const entt::entity entity, PhysicsCommand command) {
+  const auto* rigidbody = registry.try_get<RigidbodyComponent>(entity);
+  if (!running || !rigidbody || !rigidbody->runtime_body)
+    return false;
+
+  command.body_id = static_cast<JPH::Body*>(rigidbody->runtime_body)->GetID().GetIndexAndSequenceNumber();
+  push_physics_command(command);
+  return true;
+}
+
+bool Scene::add_force(const entt::entity entity, const Vec3& force) {
+  return push_body_command(entity, {.type = PhysicsCommand::Type::AddForce, .vector = force});
+}
+
+bool Scene::add_impulse(const entt::entity entity, const Vec3& impulse) {
+  return push_body_command(entity, {.type = PhysicsCommand::Type::AddImpulse, .vector = impulse});
+}
+
+bool Scene::set_linear_velocity(const entt::entity entity, const Vec3& velocity) {
+  return push_body_command(entity, {.type = PhysicsCommand::Type::SetLinearVelocity, .vector = velocity});
+}
+
+bool Scene::set_angular_velocity(const entt::entity entity, const Vec3& velocity) {
+  return push_body_command(entity, {.type = PhysicsCommand::Type::SetAngularVelocity, .vector = velocity});
+}
+
+bool Scene::teleport(const entt::entity entity, const Vec3& position, const Quat& rotation) {
+  return push_body_command(entity, {.type = PhysicsCommand::Type::Teleport, .vector = position, .rotation = rotation});
+}
+
+bool Scene::save_physics_state(Archive& archive) const {
+  OX_SCOPED_ZONE;
+  if (!running || physics_thread) {
+    OX_LOG_ERROR("Physics state can only be saved while the runtime is running without physics.threaded");
+    return false;
+  }
+
+  archive << physics_step;
+  Physics::save_state(archive);
+  character_updater->save_state(archive);
+  return true;
+}
+
+bool Scene::restore_physics_state(Archive& archive) {
+  OX_SCOPED_ZONE;
+  if (!running || physics_thread) {
+    OX_LOG_ERROR("Physics state can only be restored while the runtime is running without physics.threaded");
+    return false;
+  }
+
+  archive >> physics_step;
+  if (!Physics::restore_state(archive) || !character_updater->restore_state(archive))
+    return false;
+
+  physics_commands.clear();
+  physics_frame_accumulator = 0.0f;
+  sync_transforms_from_physics();
+  return true;
+}
+
+bool Scene::begin_physics_recording() {
+  OX_SCOPED_ZONE;
+  if (!running || physics_thread) {
+    OX_LOG_ERROR("Physics can only be recorded while the runtime is running without physics.threaded");
+    return false;
+  }
+
+  physics_recording = create_unique<PhysicsRecording>();
+  physics_recording->begin(physics_step, 1.0f / Physics::STEP_RATE, *character_updater);
+  return true;
+}
+
+Unique<PhysicsRecording> Scene::end_physics_recording() {
+  return std::move(physics_recording);
+}
+
+bool Scene::replay_physics_recording(const PhysicsRecording& recording, std::vector<float>* step_times) {
+  OX_SCOPED_ZONE;
+  if (!running || physics_thread) {
+    OX_LOG_ERROR("Physics recordings can only be replayed while the runtime is running without physics.threaded");
+    return false;
+  }
+
+  physics_commands.clear();
+  if (!recording.replay(*character_updater, step_times))
+    return false;
+
+  physics_step = recording.get_start_step() + recording.get_steps().size();
+  physics_frame_accumulator = 0.0f;
+  sync_transforms_from_physics();
+  return true;
+}
+
+void Scene::sync_transforms_from_physics() {
+  OX_SCOPED_ZONE;
+  const auto& body_interface = Physics::get_body_interface();
+
+  const auto rb_view = registry.view<RigidbodyComponent, TransformComponent>();
+  for (auto&& [e, rb, tc] : rb_view.each()) {
+    if (!rb.runtime_body)
+      continue;
+    const JPH::BodyID body_id = static_cast<const JPH::Body*>(rb.runtime_body)->GetID();
+    const JPH::Vec3 position = body_interface.GetPosition(body_id);
+    const JPH::Quat rotation = body_interface.GetRotation(body_id);
+    rb.previous_translation = rb.translation = {position.GetX(), position.GetY(), position.GetZ()};
+    rb.previous_rotation = rb.rotation = Quat(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ());
+    apply_body_transform(rb, tc, 1.0f);
+  }
+
+  const auto ch_view = registry.view<CharacterControllerComponent, TransformComponent>();
+  for (auto&& [e, ch, tc] : ch_view.each()) {
+    if (!ch.character)
+      continue;
+    const JPH::Vec3 position = ch.character->GetPosition();
+    const JPH::Quat rotation = ch.character->GetRotation();
+    ch.previous_translation = ch.translation = {position.GetX(), position.GetY(), position.GetZ()};
+    ch.previous_rotation = ch.rotation = Quat(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ());
+    apply_body_transform(ch, tc, 1.0f);
+  }
+}
+
+void Scene::dispatch_character_contact(const CharacterContact& contact) {
+  OX_SCOPED_ZONE;
+  if (!registry.valid(contact.character))
+    return;
+
+  for (const auto& system : systems)
+    system->on_character_contact(this, contact.character, contact.other, contact.position, contact.normal);
+
+  if (const auto* script_component = registry.try_get<LuaScriptComponent>(contact.character)) {
+    for (const auto& script : script_component->lua_systems)
+      script->on_character_contact(this, contact.character, contact.other, contact.position, contact.normal);
+  }
+}
+
+void Scene::dispatch_body_contacts() {
+  OX_SCOPED_ZONE;
+  BodyContact contact;
+  while (contact_listener_3d->PopContact(contact)) {
+    // Either body might have been destroyed since the step that found the contact
+    if (!registry.valid(contact.body1) || !registry.valid(contact.body2))
+      continue;
+
+    for (const auto& system : systems) {
+      if (contact.persisted)
+        system->on_contact_persisted(this, contact.body1, contact.body2, contact.position, contact.normal);
+      else
+        system->on_contact_added(this, contact.body1, contact.body2, contact.position, contact.normal);
+    }
+  }
+}
+
+void Scene::write_back_sleeping_body(const entt::entity entity, const Vec3& position, const Quat& rotation) {
+  if (!registry.valid(entity))
+    return;
+  auto* rb = registry.try_get<RigidbodyComponent>(entity);
+  auto* tc = registry.try_get<TransformComponent>(entity);
+  if (!rb || !tc)
+    return;
+
+  // No interpolation towards a body that doesn't move anymore
+  rb->previous_translation = rb->translation = position;
+  rb->previous_rotation = rb->rotation = rotation;
+  apply_body_transform(*rb, *tc, 1.0f);
+}
+
+void Scene::update_physics_threaded(const Timestep& delta_time) {
+  OX_SCOPED_ZONE;
+  const float physics_ts = physics_thread->get_step_time();
+
+  sync_character_velocities();
 
-        tc.position = glm::lerp(ch.previous_translation, ch.translation, interpolation_factor);
-        tc.rotation = glm::eulerAngles(glm::slerp(ch.previous_rotation, ch.rotation, interpolation_factor));
+  CharacterContact contact;
+  while (physics_thread->pop_character_contact(contact))
+    dispatch_character_contact(contact);
+  dispatch_body_contacts();
+
+  PhysicsSnapshot::BodyTransform sleeping_body;
+  while (physics_thread->pop_sleeping_body(sleeping_body))
+    write_back_sleeping_body(sleeping_body.entity, sleeping_body.position, sleeping_body.rotation);
+
+  if (physics_thread->acquire_snapshot()) {
+    const auto& snapshot = physics_thread->get_snapshot();
+
+    // Fixed update systems still run on this thread, once for every step the simulation took since the last snapshot.
+    constexpr uint64_t max_fixed_updates = 5;
+    const uint64_t steps = std::min(snapshot.step - physics_step, max_fixed_updates);
+    physics_step = snapshot.step;
+    {
+      OX_SCOPED_ZONE_N("OnFixedUpdate Systems");
+      for (uint64_t i = 0; i < steps; i++) {
+        for (const auto& system : systems) {
+          system->on_fixed_update(this, physics_ts);
+        }
       }
-      else {
-        const JPH::Vec3 position = ch.character->GetPosition();
-        JPH::Vec3 rotation = ch.character->GetRotation().GetEulerAngles();
-
-        ch.previous_translation = ch.translation;
-        ch.previous_rotation = ch.rotation;
-        ch.translation = {position.GetX(), position.GetY(), position.GetZ()};
-        ch.rotation = Vec3(rotation.GetX(), rotation.GetY(), rotation.GetZ());
-        tc.position = ch.translation;
-        tc.rotation = glm::eulerAngles(ch.rotation);
+    }
+
+    for (const auto& body : snapshot.transforms) {
+      if (!registry.valid(body.entity))
+        continue;
+      if (auto* rb = registry.try_get<RigidbodyComponent>(body.entity))
+        store_body_transform(*rb, body.position, body.rotation);
+      else if (auto* ch = registry.try_get<CharacterControllerComponent>(body.entity)) {
+        store_body_transform(*ch, body.position, body.rotation);
+        ch->grounded = body.grounded;
       }
     }
   }
+
+  // Renders up to one step behind the simulation, same as the single threaded path.
+  const auto& snapshot = physics_thread->get_snapshot();
+  const float interpolation_factor = glm::clamp((float)((PhysicsThread::now() - snapshot.time) / physics_ts), 0.0f, 1.0f);
+
+  for (const auto& body : snapshot.transforms) {
+    if (!registry.valid(body.entity))
+      continue;
+    auto* tc = registry.try_get<TransformComponent>(body.entity);
+    if (!tc)
+      continue;
+    if (const auto* rb = registry.try_get<RigidbodyComponent>(body.entity))
+      apply_body_transform(*rb, *tc, interpolation_factor);
+    else if (const auto* ch = registry.try_get<CharacterControllerComponent>(body.entity))
+      apply_body_transform(*ch, *tc, interpolation_factor);
+  }
 }
 
 void Scene::destroy_entity(const Entity entity) {
@@ -348,7 +664,7 @@ void Scene::on_runtime_start() {
     OX_SCOPED_ZONE_N("Physics Start");
     Physics::init();
     body_activation_listener_3d = new Physics3DBodyActivationListener();
-    contact_listener_3d = new Physics3DContactListener(this);
+    contact_listener_3d = new Physics3DContactListener();
     const auto physics_system = Physics::get_physics_system();
     physics_system->SetBodyActivationListener(body_activation_listener_3d);
     physics_system->SetContactListener(contact_listener_3d);
@@ -363,15 +679,39 @@ void Scene::on_runtime_start() {
       }
     }
 
+    physics_system->OptimizeBroadPhase();
+
+    // Characters are created after the thread so they end up in its updater
+    physics_step = 0;
+    if (PhysicsCVar::cvar_threaded.get()) {
+      physics_thread = create_unique<PhysicsThread>(Physics::STEP_RATE, body_activation_listener_3d);
+      physics_thread->start();
+    }
+    else {
+      character_updater = create_unique<CharacterUpdater>();
+    }
+
     // Characters
     {
       const auto group = registry.group<CharacterControllerComponent>(entt::get<TransformComponent>);
       for (auto&& [e, ch, tc] : group.each()) {
-        create_character_controller(tc, ch);
+        ch.previous_translation = ch.translation = tc.position;
+        ch.previous_rotation = ch.rotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+        create_character_controller(e, tc, ch);
       }
     }
+  }
 
-    physics_system->OptimizeBroadPhase();
+  // Audio
+  {
+    const auto source_view = registry.view<AudioSourceComponent>();
+    for (auto&& [e, ac] : source_view.each()) {
+      if (ac.source) {
+        ac.source->set_config(ac.config);
+        if (ac.config.play_on_awake)
+          ac.source->play();
+      }
+    }
   }
 
   // Lua scripts
@@ -391,6 +731,12 @@ void Scene::on_runtime_stop() {
 
   // Physics
   {
+    // Stop the simulation first, everything after this touches the bodies directly.
+    if (physics_thread) {
+      physics_thread->stop();
+      physics_thread.reset();
+    }
+
     JPH::BodyInterface& body_interface = Physics::get_physics_system()->GetBodyInterface();
     const auto rb_view = registry.view<RigidbodyComponent>();
     for (auto&& [e, rb] : rb_view.each()) {
@@ -398,14 +744,17 @@ void Scene::on_runtime_stop() {
         const auto* body = static_cast<const JPH::Body*>(rb.runtime_body);
         body_interface.RemoveBody(body->GetID());
         body_interface.DestroyBody(body->GetID());
+        rb.runtime_body = nullptr;
       }
     }
+    physics_recording.reset();
+    physics_commands.clear();
+    character_updater.reset();
     const auto ch_view = registry.view<CharacterControllerComponent>();
     for (auto&& [e, ch] : ch_view.each()) {
-      if (ch.character) {
-        body_interface.RemoveBody(ch.character->GetBodyID());
-        ch.character = nullptr;
-      }
+      ch.character = nullptr;
+      ch.applied_velocity = {};
+      ch.grounded = false;
     }
 
     delete body_activation_listener_3d;
@@ -414,6 +763,15 @@ void Scene::on_runtime_stop() {
     contact_listener_3d = nullptr;
   }
 
+  // Audio
+  {
+    const auto source_view = registry.view<AudioSourceComponent>();
+    for (auto&& [e, ac] : source_view.each()) {
+      if (ac.source)
+        ac.source->stop();
+    }
+  }
+
   // Lua scripts
   const auto script_view = registry.view<LuaScriptComponent>();
   for (auto&& [e, script_component] : script_view.each()) {
@@ -477,18 +835,6 @@ Shared<Scene> Scene::copy(const Shared<Scene>& src_scene) {
   return new_scene;
 }
 
-void Scene::on_contact_added(const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold& manifold, const JPH::ContactSettings& settings) {
-  OX_SCOPED_ZONE;
-  for (const auto& system : systems)
-    system->on_contact_added(this, body1, body2, manifold, settings);
-}
-
-void Scene::on_contact_persisted(const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold& manifold, const JPH::ContactSettings& settings) {
-  OX_SCOPED_ZONE;
-  for (const auto& system : systems)
-    system->on_contact_persisted(this, body1, body2, manifold, settings);
-}
-
 void Scene::create_rigidbody(entt::entity entity, const TransformComponent& transform, RigidbodyComponent& component) {
   OX_SCOPED_ZONE;
   if (!running)
@@ -497,10 +843,7 @@ void Scene::create_rigidbody(entt::entity entity, const TransformComponent& tran
   // TODO: We should get rid of 'new' usages and use JPH::Ref<> instead.
 
   auto& body_interface = Physics::get_body_interface();
-  if (component.runtime_body) {
-    body_interface.DestroyBody(static_cast<JPH::Body*>(component.runtime_body)->GetID());
-    component.runtime_body = nullptr;
-  }
+  destroy_rigidbody(component);
 
   JPH::MutableCompoundShapeSettings compound_shape_settings;
   float max_scale_component = glm::max(glm::max(transform.scale.x, transform.scale.y), transform.scale.z);
@@ -611,12 +954,7 @@ void Scene::create_rigidbody(entt::entity entity, const TransformComponent& tran
   // Body
   auto rotation = glm::quat(transform.rotation);
 
-  auto layer = registry.get<TagComponent>(entity).layer;
-  uint8_t layer_index = 1; // Default Layer
-  auto collision_mask_it = Physics::layer_collision_mask.find(layer);
-  if (collision_mask_it != Physics::layer_collision_mask.end())
-    layer_index = collision_mask_it->second.index;
-
+  const uint8_t layer_index = get_object_layer(registry.get<TagComponent>(entity));
   JPH::BodyCreationSettings body_settings(compound_shape_settings.Create().Get(), {transform.position.x, transform.position.y, transform.position.z}, {rotation.x, rotation.y, rotation.z, rotation.w}, static_cast<JPH::EMotionType>(component.type), layer_index);
 
   JPH::MassProperties mass_properties;
@@ -630,16 +968,39 @@ void Scene::create_rigidbody(entt::entity entity, const TransformComponent& tran
   body_settings.mGravityFactor = component.gravity_scale;
 
   body_settings.mIsSensor = component.is_sensor;
+  body_settings.mUserData = static_cast<uint64_t>(entity);
 
   JPH::Body* body = body_interface.CreateBody(body_settings);
 
   JPH::EActivation activation = component.awake && component.type != RigidbodyComponent::BodyType::Static ? JPH::EActivation::Activate : JPH::EActivation::DontActivate;
-  body_interface.AddBody(body->GetID(), activation);
+  if (physics_thread)
+    physics_thread->push_command({.type = PhysicsCommand::Type::AddBody, .activate = activation == JPH::EActivation::Activate, .body_id = body->GetID().GetIndexAndSequenceNumber()});
+  else
+    body_interface.AddBody(body->GetID(), activation);
 
   component.runtime_body = body;
 }
 
-void Scene::create_character_controller(const TransformComponent& transform, CharacterControllerComponent& component) const {
+void Scene::destroy_rigidbody(RigidbodyComponent& component) {
+  if (!component.runtime_body)
+    return;
+
+  const JPH::BodyID body_id = static_cast<JPH::Body*>(component.runtime_body)->GetID();
+  component.runtime_body = nullptr;
+
+  // The simulation thread might be stepping, it removes the body between two steps.
+  if (physics_thread) {
+    physics_thread->push_command({.type = PhysicsCommand::Type::RemoveBody, .body_id = body_id.GetIndexAndSequenceNumber()});
+    return;
+  }
+
+  auto& body_interface = Physics::get_body_interface();
+  if (body_interface.IsAdded(body_id))
+    body_interface.RemoveBody(body_id);
+  body_interface.DestroyBody(body_id);
+}
+
+void Scene::create_character_controller(entt::entity entity, const TransformComponent& transform, CharacterControllerComponent& component) const {
   OX_SCOPED_ZONE;
   if (!running)
     return;
@@ -650,18 +1011,37 @@ void Scene::create_character_controller(const TransformComponent& transform, Cha
     new JPH::CapsuleShape(0.5f * component.character_height_standing, component.character_radius_standing)).Create().Get();
 
   // Create character
-  const Shared<JPH::CharacterSettings> settings = create_shared<JPH::CharacterSettings>();
-  settings->mMaxSlopeAngle = JPH::DegreesToRadians(45.0f);
-  settings->mLayer = PhysicsLayers::MOVING;
-  settings->mShape = capsule_shape;
-  settings->mFriction = 0.0f;                                                                          // For now this is not set. 
-  settings->mSupportingVolume = JPH::Plane(JPH::Vec3::sAxisY(), -component.character_radius_standing); // Accept contacts that touch the lower sphere of the capsule
-  component.character = create_shared<JPH::Character>(settings.get(), position, JPH::Quat::sIdentity(), 0, Physics::get_physics_system());
-  component.character->AddToPhysicsSystem(JPH::EActivation::Activate);
+  JPH::CharacterVirtualSettings settings = {};
+  settings.mMaxSlopeAngle = JPH::DegreesToRadians(component.max_slope_angle);
+  settings.mShape = capsule_shape;
+  settings.mMass = component.mass;
+  settings.mMaxStrength = component.max_strength;
+  settings.mCharacterPadding = component.collision_tolerance;
+  settings.mSupportingVolume = JPH::Plane(JPH::Vec3::sAxisY(), -component.character_radius_standing); // Accept contacts that touch the lower sphere of the capsule
+  component.character = create_shared<JPH::CharacterVirtual>(&settings, position, JPH::Quat::sIdentity(), Physics::get_physics_system());
+
+  const CharacterControllerSettings character_settings = {
+    .max_step_height = component.max_step_height,
+    .stick_to_floor_distance = component.stick_to_floor_distance,
+    .gravity = component.gravity,
+    .jump_force = component.jump_force,
+  };
+  // Velocity is sent by sync_character_velocities
+  component.applied_velocity = Vec3(0.0f);
+  if (physics_thread) {
+    physics_thread->push_command({.type = PhysicsCommand::Type::AddCharacter,
+                                  .entity = entity,
+                                  .character = component.character,
+                                  .character_settings = character_settings});
+  }
+  else {
+    character_updater->add(entity, component.character, character_settings);
+  }
 }
 
 void Scene::on_runtime_update(const Timestep& delta_time) {
   OX_SCOPED_ZONE;
+  FrameStats::PhaseScope phase(FramePhase::SceneUpdate);
 
   // Camera
   {
@@ -693,13 +1073,40 @@ void Scene::on_runtime_update(const Timestep& delta_time) {
   // Scripting
   {
     OX_SCOPED_ZONE_N("LuaScripting/on_update");
+    // Scripts get scene/owner/this in on_init and keep them, only the time changes per frame and it's shared by every environment.
+    App::get_system<LuaManager>()->get_state()->set("current_time", delta_time.get_elapsed_seconds());
+
+    for (auto& [hash, batch] : lua_batches)
+      batch.entities.clear();
+    lua_jobs.clear();
+
     const auto script_view = registry.view<LuaScriptComponent>();
     for (auto&& [e, script_component] : script_view.each()) {
       for (const auto& script : script_component.lua_systems) {
-        script->bind_globals(this, e, delta_time);
-        script->on_update(delta_time);
+        // Scripts attached while the scene runs skip on_init.
+        script->bind_globals_if_needed(this, e);
+        if (script->is_job_safe()) {
+          lua_jobs.emplace_back(LuaJobPool::Job{.script = script.get(), .entity = e});
+        }
+        else if (script->is_batched()) {
+          auto& batch = lua_batches[script->get_path_hash()];
+          if (batch.entities.empty())
+            batch.system = script.get();
+          batch.entities.emplace_back(e);
+        }
+        else {
+          script->on_update(delta_time);
+        }
       }
     }
+
+    for (auto& [hash, batch] : lua_batches) {
+      if (!batch.entities.empty())
+        batch.system->on_update_all(batch.entities, delta_time);
+    }
+
+    // Job-safe scripts run last, their deferred spawns and destroys are applied before anything else sees the registry.
+    App::get_system<LuaManager>()->get_job_pool().run(this, lua_jobs, (float)delta_time.get_millis());
   }
 
   // Audio
@@ -707,8 +1114,9 @@ void Scene::on_runtime_update(const Timestep& delta_time) {
     OX_SCOPED_ZONE_N("Audio Systems");
     const auto listener_view = registry.group<AudioListenerComponent>(entt::get<TransformComponent>);
     for (auto&& [e, ac, tc] : listener_view.each()) {
-      ac.listener = create_shared<AudioListener>();
       if (ac.active) {
+        if (!ac.listener)
+          ac.listener = create_shared<AudioListener>();
         const Mat4 inverted = inverse(EUtil::get_world_transform(this, e));
         const Vec3 forward = normalize(Vec3(inverted[2]));
         ac.listener->set_config(ac.config);
@@ -726,8 +1134,6 @@ void Scene::on_runtime_update(const Timestep& delta_time) {
         ac.source->set_config(ac.config);
         ac.source->set_position(tc.position);
         ac.source->set_direction(forward);
-        if (ac.config.play_on_awake)
-          ac.source->play();
       }
     }
   }
@@ -751,6 +1157,7 @@ void Scene::on_imgui_render(const Timestep& delta_time) {
 
 void Scene::on_editor_update(const Timestep& delta_time, Camera& camera) {
   OX_SCOPED_ZONE;
+  FrameStats::PhaseScope phase(FramePhase::SceneUpdate);
   scene_renderer->get_render_pipeline()->register_camera(&camera);
   scene_renderer->update();
 }
@@ -10,10 +10,17 @@
 #include "Core/UUID.hpp"
 #include "Physics/PhysicsInterfaces.hpp"
 #include "Render/Mesh.h"
+#include "Scripting/LuaJobPool.hpp"
 
 namespace ox {
 class RenderPipeline;
 class SceneRenderer;
+class PhysicsThread;
+class CharacterUpdater;
+struct CharacterContact;
+struct PhysicsCommand;
+class PhysicsRecording;
+class Archive;
 
 class Scene {
 public:
@@ -60,11 +67,6 @@ public:
   bool has_entity(UUID uuid) const;
   static Shared<Scene> copy(const Shared<Scene>& src_scene);
 
-  // Physics interfaces
-  void on_contact_added(const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold& manifold, const JPH::ContactSettings& settings);
-  void
-  on_contact_persisted(const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold& manifold, const JPH::ContactSettings& settings);
-
   Entity get_entity_by_uuid(UUID uuid);
 
   // Renderer
@@ -72,6 +74,28 @@ public:
 
   entt::registry& get_registry() { return registry; }
 
+  /// Null unless the runtime is running with physics.threaded. Body changes have to go through its commands while it exists.
+  PhysicsThread* get_physics_thread() const { return physics_thread.get(); }
+
+  /// Queued until the next physics step, or sent to the physics thread.
+  void push_physics_command(const PhysicsCommand& command);
+
+  /// Rigidbody inputs, applied as physics commands before the next step. False if the entity has no body.
+  bool add_force(entt::entity entity, const Vec3& force);
+  bool add_impulse(entt::entity entity, const Vec3& impulse);
+  bool set_linear_velocity(entt::entity entity, const Vec3& velocity);
+  bool set_angular_velocity(entt::entity entity, const Vec3& velocity);
+  bool teleport(entt::entity entity, const Vec3& position, const Quat& rotation);
+
+  /// Rollback and replays. These need the runtime running without physics.threaded.
+  bool save_physics_state(Archive& archive) const;
+  bool restore_physics_state(Archive& archive);
+  bool begin_physics_recording();
+  Unique<PhysicsRecording> end_physics_recording();
+  /// Restores the recording's initial state and runs all of its steps right away.
+  bool replay_physics_recording(const PhysicsRecording& recording, std::vector<float>* step_times = nullptr);
+  uint64_t get_physics_step() const { return physics_step; }
+
 private:
   bool running = false;
 
@@ -85,17 +109,42 @@ private:
   Physics3DContactListener* contact_listener_3d = nullptr;
   Physics3DBodyActivationListener* body_activation_listener_3d = nullptr;
   float physics_frame_accumulator = 0.0f;
+  Unique<PhysicsThread> physics_thread = nullptr;
+  Unique<CharacterUpdater> character_updater = nullptr; // Only used when physics isn't threaded, the thread has its own
+  uint64_t physics_step = 0;
+  std::vector<PhysicsCommand> physics_commands = {};
+  Unique<PhysicsRecording> physics_recording = nullptr;
+
+  // Scripting
+  struct LuaBatch {
+    LuaSystem* system = nullptr; // Any instance of the script, on_update_all runs in its environment
+    std::vector<entt::entity> entities = {};
+  };
+  ankerl::unordered_dense::map<uint64_t, LuaBatch> lua_batches = {}; // Keyed by script path hash, kept to reuse the arrays
+  std::vector<LuaJobPool::Job> lua_jobs = {};
 
   void init(const Shared<RenderPipeline>& render_pipeline = nullptr);
 
+  bool push_body_command(entt::entity entity, PhysicsCommand command);
+
   void rigidbody_component_ctor(entt::registry& reg, Entity entity);
+  void rigidbody_component_dtor(entt::registry& reg, Entity entity);
   void collider_component_ctor(entt::registry& reg, Entity entity);
   void character_controller_component_ctor(entt::registry& reg, Entity entity) const;
+  void character_controller_component_dtor(entt::registry& reg, Entity entity) const;
 
   // Physics
   void update_physics(const Timestep& delta_time);
+  void update_physics_threaded(const Timestep& delta_time);
+  void update_characters(float delta_time);
+  void sync_character_velocities();
+  void sync_transforms_from_physics();
+  void dispatch_character_contact(const CharacterContact& contact);
+  void dispatch_body_contacts();
+  void write_back_sleeping_body(entt::entity entity, const Vec3& position, const Quat& rotation);
   void create_rigidbody(Entity ent, const TransformComponent& transform, RigidbodyComponent& component);
-  void create_character_controller(const TransformComponent& transform, CharacterControllerComponent& component) const;
+  void destroy_rigidbody(RigidbodyComponent& component);
+  void create_character_controller(entt::entity entity, const TransformComponent& transform, CharacterControllerComponent& component) const;
 
   friend class SceneSerializer;
   friend class SceneHPanel;
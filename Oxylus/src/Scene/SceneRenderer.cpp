@@ -9,21 +9,31 @@
 
 #include "Physics/JoltHelpers.hpp"
 #include "Jolt/Physics/Body/Body.h"
+#include "Jolt/Physics/Body/BodyLock.h"
+
+#include "Physics/Physics.hpp"
 
 #include "Entity.hpp"
 
 #include "Render/DebugRenderer.hpp"
 #include "Render/DefaultRenderPipeline.h"
+#include "Render/NullRenderPipeline.h"
 #include "Render/Renderer.hpp"
 #include "Render/Vulkan/VkContext.hpp"
 
 namespace ox {
 void SceneRenderer::init() {
   OX_SCOPED_ZONE;
-  if (!m_render_pipeline)
-    m_render_pipeline = create_shared<DefaultRenderPipeline>("DefaultRenderPipeline");
+  if (!m_render_pipeline) {
+    if (App::get()->get_specification().headless)
+      m_render_pipeline = create_shared<NullRenderPipeline>("NullRenderPipeline");
+    else
+      m_render_pipeline = create_shared<DefaultRenderPipeline>("DefaultRenderPipeline");
+  }
   Renderer::renderer_context.render_pipeline = m_render_pipeline;
-  m_render_pipeline->init(*VkContext::get()->superframe_allocator);
+  // Headless apps have no device, their pipeline stays CPU-only.
+  if (VkContext::get())
+    m_render_pipeline->init(*VkContext::get()->superframe_allocator);
   m_render_pipeline->on_dispatcher_events(dispatcher);
 }
 
@@ -58,8 +68,12 @@ void SceneRenderer::update() const {
 
         const auto* body = static_cast<const JPH::Body*>(rb.runtime_body);
         if (body) {
+          // With physics.threaded the simulation might be moving the body right now
+          JPH::BodyLockRead lock(Physics::get_physics_system()->GetBodyLockInterface(), body->GetID());
+          if (!lock.Succeeded())
+            continue;
           const auto scale = JPH::Vec3{1, 1, 1}; // convert_to_jolt_vec3(transform.scale);
-          auto aabb = convert_jolt_aabb(body->GetShape()->GetWorldSpaceBounds(body->GetCenterOfMassTransform(), scale));
+          auto aabb = convert_jolt_aabb(lock.GetBody().GetShape()->GetWorldSpaceBounds(lock.GetBody().GetCenterOfMassTransform(), scale));
           DebugRenderer::draw_aabb(aabb, Vec4(0, 1, 0, 1.0f));
         }
       }
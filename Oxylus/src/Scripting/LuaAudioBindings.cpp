@@ -16,6 +16,7 @@ void bind_audio(const Shared<sol::state>& state) {
   auto audio_source = state->new_usertype<AudioSource>("AudioSource");
   SET_TYPE_FUNCTION(audio_source, AudioSource, get_path);
   SET_TYPE_FUNCTION(audio_source, AudioSource, play);
+  SET_TYPE_FUNCTION(audio_source, AudioSource, play_delayed);
   SET_TYPE_FUNCTION(audio_source, AudioSource, pause);
   SET_TYPE_FUNCTION(audio_source, AudioSource, un_pause);
   SET_TYPE_FUNCTION(audio_source, AudioSource, stop);
@@ -33,6 +34,8 @@ void bind_audio(const Shared<sol::state>& state) {
   SET_TYPE_FUNCTION(audio_source, AudioSource, set_max_distance);
   SET_TYPE_FUNCTION(audio_source, AudioSource, set_cone);
   SET_TYPE_FUNCTION(audio_source, AudioSource, set_doppler_factor);
+  SET_TYPE_FUNCTION(audio_source, AudioSource, set_priority);
+  SET_TYPE_FUNCTION(audio_source, AudioSource, is_virtual);
   SET_TYPE_FUNCTION(audio_source, AudioSource, set_position);
   SET_TYPE_FUNCTION(audio_source, AudioSource, set_direction);
   SET_TYPE_FUNCTION(audio_source, AudioSource, set_velocity);
@@ -63,6 +66,7 @@ void bind_audio(const Shared<sol::state>& state) {
   SET_TYPE_FIELD(audio_source_config_type, AudioSourceConfig, cone_outer_angle);
   SET_TYPE_FIELD(audio_source_config_type, AudioSourceConfig, cone_outer_gain);
   SET_TYPE_FIELD(audio_source_config_type, AudioSourceConfig, doppler_factor);
+  SET_TYPE_FIELD(audio_source_config_type, AudioSourceConfig, priority);
 
 #define ALC AudioListenerComponent
   REGISTER_COMPONENT(state, ALC, FIELD(ALC, active), FIELD(ALC, config), FIELD(ALC, listener));
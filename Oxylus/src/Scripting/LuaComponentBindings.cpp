@@ -15,6 +15,112 @@ void LuaBindings::bind_components(const Shared<sol::state>& state) {
   REGISTER_COMPONENT(state, TC, FIELD(TC, position), FIELD(TC, rotation), FIELD(TC, scale));
   bind_mesh_component(state);
   bind_camera_component(state);
+  bind_light_component(state);
+  bind_typed_accessors(state);
+}
+
+// Flat arrays, {x1, y1, z1, x2, y2, z2, ...}. Entities without a transform read as zero and are skipped when writing.
+template <Vec3 TransformComponent::*Field>
+static std::vector<float> get_transform_array(const entt::registry& registry, const std::vector<entt::entity>& entities) {
+  std::vector<float> result(entities.size() * 3, 0.0f);
+  for (size_t i = 0; i < entities.size(); i++) {
+    if (const auto* tc = registry.try_get<TransformComponent>(entities[i])) {
+      const Vec3& value = tc->*Field;
+      result[i * 3 + 0] = value.x;
+      result[i * 3 + 1] = value.y;
+      result[i * 3 + 2] = value.z;
+    }
+  }
+  return result;
+}
+
+template <Vec3 TransformComponent::*Field>
+static void set_transform_array(entt::registry& registry, const std::vector<entt::entity>& entities, const std::vector<float>& values) {
+  const size_t count = glm::min(entities.size(), values.size() / 3);
+  for (size_t i = 0; i < count; i++) {
+    if (auto* tc = registry.try_get<TransformComponent>(entities[i]))
+      tc->*Field = Vec3(values[i * 3 + 0], values[i * 3 + 1], values[i * 3 + 2]);
+  }
+}
+
+// A Vec3 field of a list of entities, gathered into a buffer the view owns. data() returns it as a light userdata,
+// with LuaJIT scripts cast it with ffi.cast("ox_vec3*", view:data()) and loop over it in JIT compiled code.
+// Every map call returns its own view, unmap writes it back and releases the buffer, the pointer is invalid after that.
+struct Vec3FieldView {
+  static_assert(sizeof(Vec3) == sizeof(float) * 3, "ox_vec3 in the ffi cdef has to match Vec3");
+
+  std::vector<entt::entity> entities = {};
+  std::vector<Vec3> values = {};
+  void (*write_back)(entt::registry& registry, const Vec3FieldView& view) = nullptr; // null once unmapped
+
+  void* data() { return values.empty() ? nullptr : values.data(); }
+  size_t size() const { return values.size(); }
+};
+
+template <typename Component, Vec3 Component::*Field>
+struct FieldView {
+  static Vec3FieldView map(const entt::registry& registry, std::vector<entt::entity> entities) {
+    Vec3FieldView view = {.entities = std::move(entities), .write_back = &unmap};
+    view.values.resize(view.entities.size());
+    for (size_t i = 0; i < view.entities.size(); i++) {
+      const auto* component = registry.try_get<Component>(view.entities[i]);
+      view.values[i] = component ? component->*Field : Vec3(0.0f);
+    }
+    return view;
+  }
+
+  static void unmap(entt::registry& registry, const Vec3FieldView& view) {
+    for (size_t i = 0; i < view.entities.size(); i++) {
+      if (auto* component = registry.try_get<Component>(view.entities[i]))
+        component->*Field = view.values[i];
+    }
+  }
+};
+
+static void unmap_field_view(entt::registry& registry, Vec3FieldView& view) {
+  if (!view.write_back) {
+    OX_LOG_WARN("Field view was already unmapped");
+    return;
+  }
+
+  view.write_back(registry, view);
+  view.write_back = nullptr;
+  view.entities = {};
+  view.values = {};
+}
+
+#define REGISTER_FIELD_VIEW(registry_type, name, component, field)                                                                   \
+  registry_type.set_function("map_" name, [](const entt::registry& self, EntityArray entities) {                                   \
+    return FieldView<component, &component::field>::map(self, std::move(entities.value()));                                         \
+  });                                                                                                                                \
+  registry_type.set_function("unmap_" name, &unmap_field_view)
+
+void LuaBindings::bind_typed_accessors(const Shared<sol::state>& state) {
+  sol::usertype<entt::registry> registry_type = (*state)["entt"]["registry"];
+  REGISTER_TYPED_ACCESSORS(registry_type, "transform", TransformComponent);
+  REGISTER_TYPED_ACCESSORS(registry_type, "rigidbody", RigidbodyComponent);
+  REGISTER_TYPED_ACCESSORS(registry_type, "light", LightComponent);
+  REGISTER_TYPED_ACCESSORS(registry_type, "mesh", MeshComponent);
+
+  using EntityArray = sol::as_table_t<std::vector<entt::entity>>;
+  using FloatArray = sol::as_table_t<std::vector<float>>;
+  registry_type.set_function("get_positions", [](const entt::registry& self, const EntityArray& entities) {
+    return sol::as_table(get_transform_array<&TransformComponent::position>(self, entities.value()));
+  });
+  registry_type.set_function("set_positions", [](entt::registry& self, const EntityArray& entities, const FloatArray& values) {
+    set_transform_array<&TransformComponent::position>(self, entities.value(), values.value());
+  });
+  registry_type.set_function("get_rotations", [](const entt::registry& self, const EntityArray& entities) {
+    return sol::as_table(get_transform_array<&TransformComponent::rotation>(self, entities.value()));
+  });
+  registry_type.set_function("set_rotations", [](entt::registry& self, const EntityArray& entities, const FloatArray& values) {
+    set_transform_array<&TransformComponent::rotation>(self, entities.value(), values.value());
+  });
+
+  state->new_usertype<Vec3FieldView>("Vec3FieldView", sol::no_constructor, "data", &Vec3FieldView::data, "size", &Vec3FieldView::size);
+  REGISTER_FIELD_VIEW(registry_type, "positions", TransformComponent, position);
+  REGISTER_FIELD_VIEW(registry_type, "rotations", TransformComponent, rotation);
+  REGISTER_FIELD_VIEW(registry_type, "character_velocities", CharacterControllerComponent, velocity);
 }
 
 void LuaBindings::bind_light_component(const Shared<sol::state>& state) {
@@ -11,4 +11,6 @@ void bind_components(const Shared<sol::state>& state);
 void bind_light_component(const Shared<sol::state>& state);
 void bind_mesh_component(const Shared<sol::state>& state);
 void bind_camera_component(const Shared<sol::state>& state);
+/// Typed registry accessors and bulk transform access, has to run after bind_scene created entt.registry.
+void bind_typed_accessors(const Shared<sol::state>& state);
 }
@@ -2,11 +2,14 @@
 
 #include <sol/state.hpp>
 #include "LuaHelpers.hpp"
+#include "LuaProfiler.hpp"
 
 #include "Physics/RayCast.hpp"
 
 #include "Render/DebugRenderer.hpp"
 
+#include "Utils/FrameStats.hpp"
+
 namespace ox::LuaBindings {
 void bind_debug_renderer(const Shared<sol::state>& state) {
   auto debug_table = state->create_table("Debug");
@@ -20,5 +23,78 @@ void bind_debug_renderer(const Shared<sol::state>& state) {
   debug_table.set_function("draw_aabb", [](const AABB& aabb, const Vec3& color, const bool depth_tested) -> void {
     DebugRenderer::draw_aabb(aabb, Vec4(color, 1.0f), false, 1.0f, depth_tested);
   });
+
+  auto profiler_table = state->create_table("Profiler");
+  profiler_table.set_function("reset", &LuaProfiler::reset);
+  profiler_table.set_function("export_csv", &LuaProfiler::export_csv);
+  profiler_table.set_function("get_callback_stats", [](sol::this_state s) {
+    sol::state_view lua(s);
+    auto result = lua.create_table();
+    for (const auto& stats : LuaProfiler::get_callback_stats()) {
+      result.add(lua.create_table_with("script", stats.script, "callback", stats.callback, "calls", stats.calls,
+                                       "total_ms", stats.total_ms, "max_ms", stats.max_ms));
+    }
+    return result;
+  });
+  profiler_table.set_function("get_entity_stats", [](sol::this_state s) {
+    sol::state_view lua(s);
+    auto result = lua.create_table();
+    for (const auto& stats : LuaProfiler::get_entity_stats())
+      result.add(lua.create_table_with("entity", stats.entity, "script", stats.script, "calls", stats.calls, "total_ms", stats.total_ms));
+    return result;
+  });
+  profiler_table.set_function("get_sample_stats", [](sol::this_state s) {
+    sol::state_view lua(s);
+    auto result = lua.create_table();
+    for (const auto& stats : LuaProfiler::get_sample_stats())
+      result.add(lua.create_table_with("source", stats.source, "function", stats.function, "line", stats.line, "samples", stats.samples));
+    return result;
+  });
+
+  // Phases are indexed by FramePhase, named like FrameStats::get_phase_name.
+  const auto create_phase_table = [](sol::state_view& lua, const auto& get_value) {
+    auto phases = lua.create_table();
+    for (uint32_t i = 0; i < FrameStats::PHASE_COUNT; i++)
+      phases[FrameStats::get_phase_name((FramePhase)i)] = get_value((FramePhase)i);
+    return phases;
+  };
+  const auto create_summary_table = [](sol::state_view& lua, const FrameStats::Summary& summary) {
+    return lua.create_table_with("p50", summary.p50, "p95", summary.p95, "p99", summary.p99, "max", summary.max, "mean", summary.mean);
+  };
+  const auto create_frame_table = [create_phase_table](sol::state_view& lua, const FrameStats::FrameRecord& frame) {
+    auto result = lua.create_table_with("index", frame.index, "total_ms", frame.total_ms);
+    result["phases"] = create_phase_table(lua, [&frame](const FramePhase phase) { return frame.phase_ms[(uint32_t)phase]; });
+    return result;
+  };
+
+  auto frame_stats_table = state->create_table("FrameStats");
+  frame_stats_table.set_function("reset", &FrameStats::reset);
+  frame_stats_table.set_function("export_csv", [](const sol::optional<std::string>& path) {
+    return FrameStats::export_csv(path.value_or(FrameStatsCVar::cvar_export_path.get()));
+  });
+  frame_stats_table.set_function("get_hitch_count", &FrameStats::get_hitch_count);
+  frame_stats_table.set_function("get_hitch_threshold", &FrameStats::get_hitch_threshold);
+  frame_stats_table.set_function("get_summary", [create_phase_table, create_summary_table](sol::this_state s) {
+    sol::state_view lua(s);
+    auto result = create_summary_table(lua, FrameStats::get_frame_summary());
+    result["phases"] = create_phase_table(lua, [&lua, &create_summary_table](const FramePhase phase) {
+      return create_summary_table(lua, FrameStats::get_summary(phase));
+    });
+    return result;
+  });
+  frame_stats_table.set_function("get_last_frame", [create_frame_table](sol::this_state s) {
+    sol::state_view lua(s);
+    return create_frame_table(lua, FrameStats::get_last_frame());
+  });
+  frame_stats_table.set_function("get_hitches", [create_frame_table](sol::this_state s) {
+    sol::state_view lua(s);
+    auto result = lua.create_table();
+    for (const auto& hitch : FrameStats::get_hitches()) {
+      auto frame = create_frame_table(lua, hitch.frame);
+      frame["threshold_ms"] = hitch.threshold_ms;
+      result.add(frame);
+    }
+    return result;
+  });
 }
 } // namespace ox::LuaBindings
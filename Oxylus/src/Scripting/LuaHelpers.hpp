@@ -150,6 +150,12 @@ void register_meta_event() {
   __VA_ARGS__; \
   register_meta_component<type>()
 
+// Statically typed accessors for hot components, registry:get_<name>(entity) returns a reference without going through entt::meta.
+#define REGISTER_TYPED_ACCESSORS(registry_type, name, type)                                                                                 \
+  registry_type.set_function("get_" name, [](entt::registry& self, const entt::entity entity) -> type& { return self.get_or_emplace<type>(entity); }); \
+  registry_type.set_function("try_get_" name, [](entt::registry& self, const entt::entity entity) -> type* { return self.try_get<type>(entity); });     \
+  registry_type.set_function("has_" name, [](const entt::registry& self, const entt::entity entity) { return self.all_of<type>(entity); })
+
 #define REGISTER_COMPONENT(state, type, ...) \
   state->new_usertype<type>(C_NAME(type), "type_id", &entt::type_hash<type>::value, __VA_ARGS__); \
   register_meta_component<type>()
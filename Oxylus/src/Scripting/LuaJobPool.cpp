@@ -0,0 +1,169 @@
+#include "LuaJobPool.hpp"
+
+#include <sol/sol.hpp>
+
+#include "LuaManager.hpp"
+#include "LuaMathBindings.hpp"
+#include "LuaSystem.hpp"
+
+#include "Core/App.hpp"
+#include "Scene/Scene.hpp"
+#include "Thread/TaskScheduler.hpp"
+
+#include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+
+namespace ox {
+struct LuaJobPool::Worker {
+  struct Function {
+    uint64_t chunk_hash = 0; // Reloaded when the script's source changed
+    sol::protected_function on_job_update = {};
+  };
+
+  Shared<sol::state> state = nullptr;
+  ankerl::unordered_dense::map<uint64_t, Function> functions = {}; // Keyed by script path hash
+  std::vector<LuaDeferredCommand> deferred = {};
+};
+
+static void bind_job_context(const Shared<sol::state>& state) {
+  auto job = state->new_usertype<LuaJobContext>("LuaJobContext");
+  job.set_function("get_entity", [](const LuaJobContext& ctx) { return ctx.entity; });
+
+  job.set_function("get_position", [](const LuaJobContext& ctx) { return ctx.scene->registry.get<TransformComponent>(ctx.entity).position; });
+  job.set_function("set_position", [](const LuaJobContext& ctx, const Vec3& v) { ctx.scene->registry.get<TransformComponent>(ctx.entity).position = v; });
+  job.set_function("get_rotation", [](const LuaJobContext& ctx) { return ctx.scene->registry.get<TransformComponent>(ctx.entity).rotation; });
+  job.set_function("set_rotation", [](const LuaJobContext& ctx, const Vec3& v) { ctx.scene->registry.get<TransformComponent>(ctx.entity).rotation = v; });
+  job.set_function("get_scale", [](const LuaJobContext& ctx) { return ctx.scene->registry.get<TransformComponent>(ctx.entity).scale; });
+  job.set_function("set_scale", [](const LuaJobContext& ctx, const Vec3& v) { ctx.scene->registry.get<TransformComponent>(ctx.entity).scale = v; });
+
+  job.set_function("get_velocity", [](const LuaJobContext& ctx) {
+    const auto* cc = ctx.scene->registry.try_get<CharacterControllerComponent>(ctx.entity);
+    return cc ? cc->velocity : Vec3(0.0f);
+  });
+  job.set_function("set_velocity", [](const LuaJobContext& ctx, const Vec3& v) {
+    if (auto* cc = ctx.scene->registry.try_get<CharacterControllerComponent>(ctx.entity))
+      cc->velocity = v;
+  });
+
+  job.set_function("destroy", [](const LuaJobContext& ctx, const sol::optional<entt::entity> entity) {
+    ctx.deferred->emplace_back(LuaDeferredCommand{.type = LuaDeferredCommand::Type::Destroy, .entity = entity.value_or(ctx.entity)});
+  });
+  job.set_function("spawn", [](const LuaJobContext& ctx, const std::string& name, const sol::optional<Vec3> position) {
+    ctx.deferred->emplace_back(LuaDeferredCommand{.type = LuaDeferredCommand::Type::Spawn, .name = name, .position = position.value_or(Vec3(0.0f))});
+  });
+}
+
+LuaJobPool::~LuaJobPool() { clear(); }
+
+void LuaJobPool::create_workers() {
+  OX_SCOPED_ZONE;
+  const uint32_t thread_count = App::get_system<TaskScheduler>()->get()->GetNumTaskThreads();
+  workers.reserve(thread_count);
+  for (uint32_t i = 0; i < thread_count; i++) {
+    auto& worker = workers.emplace_back(create_unique<Worker>());
+    // Only libraries without shared process state, jobs can't reach the scene bindings.
+    worker->state = LuaManager::create_state();
+    worker->state->open_libraries(sol::lib::base, sol::lib::math, sol::lib::table, sol::lib::string);
+    LuaBindings::bind_math(worker->state);
+    bind_job_context(worker->state);
+  }
+}
+
+void LuaJobPool::clear() {
+  workers.clear();
+  entity_ranges.clear();
+}
+
+static sol::protected_function load_job_function(sol::state& state, const std::string& path, const std::string& bytecode) {
+  sol::protected_function chunk = {};
+  {
+    sol::load_result loaded = state.load_buffer(bytecode.data(), bytecode.size(), "@" + path, sol::load_mode::binary);
+    if (!loaded.valid()) {
+      const sol::error err = loaded;
+      OX_LOG_ERROR("Failed to load job script {}: {}", path, err.what());
+      return {};
+    }
+    chunk = loaded;
+  }
+
+  // Own environment per script, two job-safe files may define the same globals.
+  const sol::environment environment(state, sol::create, state.globals());
+  sol::set_environment(environment, chunk);
+  const auto result = chunk.call();
+  if (!result.valid()) {
+    const sol::error err = result;
+    OX_LOG_ERROR("Failed to execute job script {}: {}", path, err.what());
+    return {};
+  }
+
+  return environment["on_job_update"];
+}
+
+void LuaJobPool::run(Scene* scene, const std::span<const Job> jobs, const float delta_time) {
+  OX_SCOPED_ZONE;
+  if (jobs.empty())
+    return;
+
+  if (workers.empty())
+    create_workers();
+
+  entity_ranges.clear();
+  for (uint32_t i = 0; i < (uint32_t)jobs.size(); i++) {
+    if (i == 0 || jobs[i].entity != jobs[i - 1].entity)
+      entity_ranges.emplace_back(i);
+  }
+  entity_ranges.emplace_back((uint32_t)jobs.size());
+
+  // Workers only read the bytecode cache, nothing compiles scripts while the jobs run.
+  const auto* lua_manager = App::get_system<LuaManager>();
+  const auto range_count = (uint32_t)entity_ranges.size() - 1;
+  App::get_system<TaskScheduler>()->parallel_for(range_count, MIN_RANGE, [this, scene, jobs, delta_time, lua_manager](const uint32_t i, const uint32_t thread_num) {
+    OX_SCOPED_ZONE_N("LuaJob");
+    auto& worker = *workers[thread_num];
+
+    for (uint32_t j = entity_ranges[i]; j < entity_ranges[i + 1]; j++) {
+      const auto& job = jobs[j];
+      const auto* chunk = lua_manager->get_script_chunk(job.script->get_path());
+      if (!chunk)
+        continue;
+
+      auto& function = worker.functions[job.script->get_path_hash()];
+      if (function.chunk_hash != chunk->hash) {
+        function.chunk_hash = chunk->hash;
+        function.on_job_update = load_job_function(*worker.state, job.script->get_path(), chunk->bytecode);
+      }
+      if (!function.on_job_update.valid())
+        continue;
+
+      const LuaJobContext context = {.scene = scene, .entity = job.entity, .deferred = &worker.deferred};
+      const auto result = function.on_job_update.call(context, delta_time);
+      if (!result.valid()) {
+        const sol::error err = result;
+        OX_LOG_ERROR("Error: {0}", err.what());
+      }
+    }
+  });
+
+  for (auto& worker : workers)
+    apply_deferred(scene, worker->deferred);
+}
+
+void LuaJobPool::apply_deferred(Scene* scene, std::vector<LuaDeferredCommand>& commands) {
+  OX_SCOPED_ZONE;
+  for (const auto& command : commands) {
+    switch (command.type) {
+      case LuaDeferredCommand::Type::Destroy: {
+        if (scene->registry.valid(command.entity))
+          scene->destroy_entity(command.entity);
+        break;
+      }
+      case LuaDeferredCommand::Type::Spawn: {
+        const auto entity = scene->create_entity(command.name);
+        scene->registry.get<TransformComponent>(entity).position = command.position;
+        break;
+      }
+    }
+  }
+  commands.clear();
+}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <span>
+#include <string>
+#include <vector>
+
+#include <entt/entity/entity.hpp>
+
+#include "Core/Base.hpp"
+#include "Core/Types.hpp"
+
+namespace ox {
+class LuaSystem;
+class Scene;
+
+/// Structural change requested by a job, applied on the main thread after all jobs finished.
+struct LuaDeferredCommand {
+  enum class Type { Destroy, Spawn };
+
+  Type type = Type::Destroy;
+  entt::entity entity = entt::null;
+  std::string name = {};
+  Vec3 position = {};
+};
+
+/// What a job-safe script gets instead of scene/owner. Reads and writes only reach the entity being updated,
+/// anything structural goes into the worker's deferred command buffer.
+struct LuaJobContext {
+  Scene* scene = nullptr;
+  entt::entity entity = entt::null;
+  std::vector<LuaDeferredCommand>* deferred = nullptr;
+};
+
+/// Runs job-safe scripts on the task scheduler, each worker thread owns its own Lua state.
+/// A script opts in by setting `job_safe = true` and defining `on_job_update(job, dt)`.
+/// Worker states don't keep per-entity globals: the script is loaded once per worker from the cached bytecode
+/// and entities are spread over the workers differently every frame, so per-entity state has to live in components.
+class LuaJobPool {
+public:
+  static constexpr uint32_t MIN_RANGE = 16;
+
+  struct Job {
+    LuaSystem* script = nullptr;
+    entt::entity entity = entt::null;
+  };
+
+  LuaJobPool() = default;
+  ~LuaJobPool();
+
+  /// Jobs of the same entity have to be next to each other, they run on the same worker in order.
+  /// Blocks until every job ran, then applies the deferred commands in worker order.
+  void run(Scene* scene, std::span<const Job> jobs, float delta_time);
+  void clear();
+
+private:
+  struct Worker;
+  std::vector<Unique<Worker>> workers = {};
+  std::vector<uint32_t> entity_ranges = {}; // First job of every entity, plus the end
+
+  void create_workers();
+  static void apply_deferred(Scene* scene, std::vector<LuaDeferredCommand>& commands);
+};
+}
@@ -1,5 +1,6 @@
 ﻿#include "LuaManager.hpp"
 
+#include <filesystem>
 #include <sol/sol.hpp>
 
 #include "LuaApplicationBindings.hpp"
@@ -10,20 +11,54 @@
 #include "LuaInputBindings.hpp"
 #include "LuaMathBindings.hpp"
 #include "LuaPhysicsBindings.hpp"
+#include "LuaProfiler.hpp"
 #include "LuaRendererBindings.hpp"
 #include "LuaSceneBindings.hpp"
 #include "LuaUIBindings.hpp"
 
+#include "Core/FileSystem.hpp"
+#include "Core/Memory.hpp"
 #include "Core/Input.hpp"
 #include "Scene/Scene.hpp"
 
 #include "Utils/Log.hpp"
+#include "Utils/Profiler.hpp"
+#include "Utils/Timer.hpp"
 
 namespace ox {
+#ifdef OX_LUAJIT
+// LuaJIT 2.1 only has the incremental collector
+static constexpr bool GENERATIONAL_GC_SUPPORTED = false;
+#else
+static constexpr bool GENERATIONAL_GC_SUPPORTED = true;
+#endif
+
+void* LuaManager::allocate(void*, void* ptr, size_t, const size_t new_size) {
+  if (new_size == 0) {
+    Memory::free(ptr);
+    return nullptr;
+  }
+  return Memory::reallocate(ptr, new_size, MemoryTag::Scripting);
+}
+
+Shared<sol::state> LuaManager::create_state() {
+#ifdef OX_LUAJIT
+  // 64-bit LuaJIT without GC64 refuses custom allocators.
+  return create_shared<sol::state>();
+#else
+  return create_shared<sol::state>(sol::default_at_panic, &LuaManager::allocate);
+#endif
+}
+
 void LuaManager::init() {
   OX_SCOPED_ZONE;
-  m_state = create_shared<sol::state>();
+  m_state = create_state();
   m_state->open_libraries(sol::lib::base, sol::lib::package, sol::lib::math, sol::lib::table, sol::lib::os, sol::lib::string);
+#ifdef OX_LUAJIT
+  m_state->open_libraries(sol::lib::ffi, sol::lib::jit, sol::lib::bit32);
+  // Layout of Vec3, for the registry:map_* views
+  m_state->script("local ffi = require('ffi') ffi.cdef[[ typedef struct { float x, y, z; } ox_vec3; ]]");
+#endif
 
   bind_log();
   LuaBindings::bind_application(m_state);
@@ -37,27 +72,183 @@ void LuaManager::init() {
   LuaBindings::bind_audio(m_state);
   LuaBindings::bind_physics(m_state);
   LuaBindings::bind_ui(m_state);
+
+  apply_gc_policy(LuaCVar::cvar_gc_generational.get(), LuaCVar::cvar_gc_step_budget.get());
+  m_gc_subscriptions[0] = LuaCVar::cvar_gc_generational.subscribe([this](const int32_t generational) {
+    apply_gc_policy(generational, LuaCVar::cvar_gc_step_budget.get());
+  });
+  m_gc_subscriptions[1] = LuaCVar::cvar_gc_step_budget.subscribe([this](const int32_t budget) {
+    apply_gc_policy(LuaCVar::cvar_gc_generational.get(), budget);
+  });
 }
 
 void LuaManager::deinit() {
+  LuaCVar::cvar_gc_generational.unsubscribe(m_gc_subscriptions[0]);
+  LuaCVar::cvar_gc_step_budget.unsubscribe(m_gc_subscriptions[1]);
+  m_job_pool.clear();
+  m_script_chunks.clear();
   m_state->collect_gc();
   m_state.reset();
+  m_gc_policy_applied = false;
+}
+
+void LuaManager::update() {
+  OX_SCOPED_ZONE;
+  LuaProfiler::update(m_state->lua_state());
+
+  m_gc_stats.steps = 0;
+  m_gc_stats.step_time_us = 0.0f;
+  if (m_gc_manual)
+    step_gc(LuaCVar::cvar_gc_step_budget.get());
+
+  lua_State* L = m_state->lua_state();
+  m_gc_stats.heap_kb = (float)lua_gc(L, LUA_GCCOUNT, 0) + (float)lua_gc(L, LUA_GCCOUNTB, 0) / 1024.0f;
+}
+
+void LuaManager::apply_gc_policy(const int32_t generational_cvar, const int32_t budget_us) {
+  // The budget steps the incremental collector, a generational step is a whole young collection and can't be split up.
+  const bool manual = budget_us > 0;
+  const bool generational = GENERATIONAL_GC_SUPPORTED && generational_cvar != 0 && !manual;
+  if (generational == m_gc_generational && manual == m_gc_manual && m_gc_policy_applied)
+    return;
+
+  lua_State* L = m_state->lua_state();
+#ifndef OX_LUAJIT
+  if (generational)
+    lua_gc(L, LUA_GCGEN, 0, 0); // 0 keeps Lua's default multipliers
+  else
+    lua_gc(L, LUA_GCINC, 0, 0, 0);
+#endif
+
+  if (manual)
+    lua_gc(L, LUA_GCSTOP, 0);
+  else
+    lua_gc(L, LUA_GCRESTART, 0);
+
+  m_gc_generational = generational;
+  m_gc_manual = manual;
+  m_gc_policy_applied = true;
+#ifdef OX_DEBUG
+  m_gc_heap_after_step_kb = 0.0f;
+#endif
+}
+
+void LuaManager::step_gc(const int32_t budget_us) {
+  OX_SCOPED_ZONE;
+  lua_State* L = m_state->lua_state();
+  const Timer timer = {};
+
+  // If scripts allocate faster than the budget collects, finish the cycle anyway rather than growing without bound.
+  const float heap_kb = (float)lua_gc(L, LUA_GCCOUNT, 0);
+  const bool over_budget = m_gc_stats.heap_after_cycle_kb > 0.0f && heap_kb > m_gc_stats.heap_after_cycle_kb * 2.0f;
+
+#ifdef OX_DEBUG
+  if (m_gc_manual && !m_gc_auto_collect_reported && heap_kb < m_gc_heap_after_step_kb) {
+    OX_LOG_WARN("Lua heap shrank between budgeted GC steps ({} KB -> {} KB), the automatic collector is running.", m_gc_heap_after_step_kb, heap_kb);
+    m_gc_auto_collect_reported = true;
+  }
+#endif
+
+  while (true) {
+    m_gc_stats.steps++;
+    if (lua_gc(L, LUA_GCSTEP, 0)) {
+      m_gc_stats.cycles++;
+      m_gc_stats.heap_after_cycle_kb = (float)lua_gc(L, LUA_GCCOUNT, 0);
+      break;
+    }
+    if (!over_budget && timer.get_elapsed_ms() * 1000.0f >= (float)budget_us)
+      break;
+  }
+
+#ifdef OX_LUAJIT
+  // LuaJIT's LUA_GCSTEP resets the GC threshold, which hands collection back to the allocator until it's stopped again.
+  if (m_gc_manual)
+    lua_gc(L, LUA_GCSTOP, 0);
+#endif
+
+#ifdef OX_DEBUG
+  m_gc_heap_after_step_kb = (float)lua_gc(L, LUA_GCCOUNT, 0);
+#endif
+
+  m_gc_stats.step_time_us = timer.get_elapsed_ms() * 1000.0f;
+}
+
+static std::string get_bytecode_cache_path(const uint64_t hash) {
+  return FileSystem::append_paths(LuaManager::BYTECODE_CACHE_DIRECTORY, fmt::format("{:016x}.luac", hash));
+}
+
+bool LuaManager::compile_script(const std::string& path, const std::string& source, ScriptChunk& chunk) const {
+  OX_SCOPED_ZONE;
+  sol::load_result loaded = m_state->load(source, "@" + path, sol::load_mode::text);
+  if (!loaded.valid())
+    return false;
+
+  const sol::protected_function function = loaded;
+  const sol::bytecode bytecode = function.dump();
+  chunk.bytecode = std::string(bytecode.as_string_view());
+
+  std::error_code error;
+  std::filesystem::create_directories(BYTECODE_CACHE_DIRECTORY, error);
+  const std::vector<uint8_t> data(chunk.bytecode.begin(), chunk.bytecode.end());
+  if (!FileSystem::write_file_binary(get_bytecode_cache_path(chunk.hash), data))
+    OX_LOG_WARN("Couldn't write the bytecode cache for {}", path);
+
+  return true;
+}
+
+sol::load_result LuaManager::load_script(const std::string& path) {
+  OX_SCOPED_ZONE;
+
+  std::error_code error;
+  const int64_t write_time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+
+  auto& chunk = m_script_chunks[path];
+  if (chunk.bytecode.empty() || chunk.write_time != write_time) {
+    // Only hash the source when the file changed, a touched but identical file keeps its bytecode.
+    const std::string source = FileSystem::read_file(path);
+    const uint64_t hash = ankerl::unordered_dense::hash<std::string>{}(source);
+    chunk.write_time = write_time;
+
+    if (chunk.bytecode.empty() || chunk.hash != hash) {
+      chunk.hash = hash;
+      chunk.bytecode.clear();
+
+      const auto cached = FileSystem::read_file_binary(get_bytecode_cache_path(hash));
+      chunk.bytecode.assign(cached.begin(), cached.end());
+
+      // Compile if there's no cached bytecode or it's from another Lua version.
+      const bool cache_valid = !chunk.bytecode.empty() &&
+                               m_state->load_buffer(chunk.bytecode.data(), chunk.bytecode.size(), "@" + path, sol::load_mode::binary).valid();
+      if (!cache_valid && !compile_script(path, source, chunk)) {
+        m_script_chunks.erase(path);
+        return m_state->load(source, "@" + path, sol::load_mode::text); // Carries the syntax error
+      }
+    }
+  }
+
+  return m_state->load_buffer(chunk.bytecode.data(), chunk.bytecode.size(), "@" + path, sol::load_mode::binary);
+}
+
+const LuaManager::ScriptChunk* LuaManager::get_script_chunk(const std::string& path) const {
+  const auto it = m_script_chunks.find(path);
+  return it != m_script_chunks.end() && !it->second.bytecode.empty() ? &it->second : nullptr;
 }
 
-#define SET_LOG_FUNCTIONS(table, name, log_func) \
-  table.set_function(name, sol::overload([](const std::string_view message) { log_func("{}", message);}, \
-                                         [](const Vec4& vec4) { log_func("x: {} y: {} z: {} w: {}", vec4.x, vec4.y, vec4.z, vec4.w); }, \
-                                         [](const Vec3& vec3) { log_func("x: {} y: {} z: {}", vec3.x, vec3.y, vec3.z); }, \
-                                         [](const Vec2& vec2) { log_func("x: {} y: {}", vec2.x, vec2.y); }, \
-                                         [](const UVec2& vec2) { log_func("x: {} y: {}", vec2.x, vec2.y); } \
+// Every script logs through the same few call sites here, so they aren't rate limited.
+#define SET_LOG_FUNCTIONS(table, name, verbosity) \
+  table.set_function(name, sol::overload([](const std::string_view message) { OX_LOG_IMPL_UNLIMITED(verbosity, "{}", message);}, \
+                                         [](const Vec4& vec4) { OX_LOG_IMPL_UNLIMITED(verbosity, "x: {} y: {} z: {} w: {}", vec4.x, vec4.y, vec4.z, vec4.w); }, \
+                                         [](const Vec3& vec3) { OX_LOG_IMPL_UNLIMITED(verbosity, "x: {} y: {} z: {}", vec3.x, vec3.y, vec3.z); }, \
+                                         [](const Vec2& vec2) { OX_LOG_IMPL_UNLIMITED(verbosity, "x: {} y: {}", vec2.x, vec2.y); }, \
+                                         [](const UVec2& vec2) { OX_LOG_IMPL_UNLIMITED(verbosity, "x: {} y: {}", vec2.x, vec2.y); } \
 ));
 
 void LuaManager::bind_log() const {
   OX_SCOPED_ZONE;
   auto log = m_state->create_table("Log");
 
-  SET_LOG_FUNCTIONS(log, "info", OX_LOG_INFO)
-  SET_LOG_FUNCTIONS(log, "warn", OX_LOG_WARN)
-  SET_LOG_FUNCTIONS(log, "error", OX_LOG_ERROR)
+  SET_LOG_FUNCTIONS(log, "info", loguru::Verbosity_INFO)
+  SET_LOG_FUNCTIONS(log, "warn", loguru::Verbosity_WARNING)
+  SET_LOG_FUNCTIONS(log, "error", loguru::Verbosity_ERROR)
 }
 }
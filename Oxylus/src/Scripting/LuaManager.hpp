@@ -1,21 +1,94 @@
 #pragma once
+#include <ankerl/unordered_dense.h>
+
+#include "LuaJobPool.hpp"
+
 #include "Core/Base.hpp"
 #include "Core/ESystem.hpp"
 
+#include "Utils/CVars.hpp"
+
 namespace sol {
 class state;
+struct load_result;
 }
 
 namespace ox {
+class ModuleRegistry;
+
+namespace LuaCVar {
+inline AutoCVar_Int cvar_gc_generational("lua.gc_generational", "use Lua's generational collector when lua.gc_step_budget is 0, ignored with LuaJIT", 1);
+inline AutoCVar_Int cvar_gc_step_budget("lua.gc_step_budget", "microseconds the incremental Lua GC may run each frame, 0 leaves the pacing to Lua", 500);
+inline AutoCVar_Int cvar_profiler("lua.profiler", "0 off, 1 time every script callback, 2 also sample Lua functions", 0);
+}
+
+struct LuaGCStats {
+  float heap_kb = 0.0f;
+  float heap_after_cycle_kb = 0.0f; // Heap size when the last incremental cycle finished
+  float step_time_us = 0.0f;        // Spent in the GC last frame
+  uint32_t steps = 0;               // Last frame
+  uint64_t cycles = 0;              // Finished incremental cycles
+};
+
 class LuaManager : public ESystem {
 public:
+  /// Modules bind their types into the state, so it has to go away before their libraries are unloaded.
+  using Dependencies = SystemDependencies<ModuleRegistry>;
+
+  struct ScriptChunk {
+    int64_t write_time = 0;
+    uint64_t hash = 0;
+    std::string bytecode = {};
+  };
+
   void init() override;
   void deinit() override;
-    
+  /// Runs the frame's GC steps, see LuaCVar. Policy changes are applied by cvar callbacks.
+  void update() override;
+
+  /// lua_Alloc accounting every Lua allocation to MemoryTag::Scripting. LuaJIT states keep their own allocator.
+  static void* allocate(void* user_data, void* ptr, size_t old_size, size_t new_size);
+  static Shared<sol::state> create_state();
+
   sol::state* get_state() const { return m_state.get(); }
+  const LuaGCStats& get_gc_stats() const { return m_gc_stats; }
+  bool is_gc_generational() const { return m_gc_generational; }
+
+  /// Returns a fresh closure of the script's top level chunk, call it after setting its environment.
+  /// Each file is compiled once per content hash. The bytecode is kept in memory for the next instances
+  /// and dumped to BYTECODE_CACHE_DIRECTORY so later runs don't compile it at all.
+  sol::load_result load_script(const std::string& path);
+  /// Bytecode load_script cached for the path, nullptr if it wasn't loaded or failed to compile.
+  const ScriptChunk* get_script_chunk(const std::string& path) const;
+
+  LuaJobPool& get_job_pool() { return m_job_pool; }
+
+#ifdef OX_LUAJIT
+  static constexpr auto BYTECODE_CACHE_DIRECTORY = ".cache/luajit"; // LuaJIT bytecode isn't compatible with Lua 5.4's
+#else
+  static constexpr auto BYTECODE_CACHE_DIRECTORY = ".cache/lua";
+#endif
 
 private:
   Shared<sol::state> m_state = nullptr;
+  ankerl::unordered_dense::map<std::string, ScriptChunk> m_script_chunks = {};
+  LuaJobPool m_job_pool = {};
+
+  // The collector only runs in update() while a step budget is set, Lua's own pacing is stopped.
+  bool m_gc_generational = false;
+  bool m_gc_manual = false;
+  bool m_gc_policy_applied = false;
+  uint32_t m_gc_subscriptions[2] = {}; // Switching the policy follows the cvars
+  LuaGCStats m_gc_stats = {};
+#ifdef OX_DEBUG
+  float m_gc_heap_after_step_kb = 0.0f; // The heap only grows between budgeted steps while the collector is stopped
+  bool m_gc_auto_collect_reported = false;
+#endif
+
+  void apply_gc_policy(int32_t generational_cvar, int32_t budget_us);
+  void step_gc(int32_t budget_us);
+
+  bool compile_script(const std::string& path, const std::string& source, ScriptChunk& chunk) const;
 
   void bind_log() const;
 };
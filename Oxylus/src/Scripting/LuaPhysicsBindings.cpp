@@ -1,5 +1,8 @@
 ﻿#include "LuaPhysicsBindings.hpp"
 
+#include <algorithm>
+
+#include <glm/gtc/quaternion.hpp>
 #include <sol/state.hpp>
 
 #include "LuaHelpers.hpp"
@@ -9,12 +12,16 @@
 #include "Jolt/Physics/Collision/CastResult.h"
 
 #include "Physics/Physics.hpp"
+#include "Physics/PhysicsQuery.hpp"
 #include "Physics/RayCast.hpp"
 
 #include "Scene/Components.hpp"
 #include "Scene/Entity.hpp"
 
 namespace ox {
+// Bounds the hit arrays sized from script arguments.
+static constexpr uint32_t MAX_LUA_QUERY_HITS = 256;
+
 void LuaBindings::bind_physics(const Shared<sol::state>& state) {
   auto raycast_type = state->new_usertype<RayCast>("RayCast", sol::constructors<RayCast(Vec3, Vec3)>());
   SET_TYPE_FUNCTION(raycast_type, RayCast, get_point_on_ray);
@@ -35,6 +42,86 @@ void LuaBindings::bind_physics(const Shared<sol::state>& state) {
                                return {collector.mHits.begin(), collector.mHits.end()};
                              });
 
+  // --- Narrowphase queries ---
+  const std::initializer_list<std::pair<sol::string_view, QueryMode>> query_mode = {
+    ENUM_FIELD(QueryMode, Closest),
+    ENUM_FIELD(QueryMode, Any),
+  };
+  state->new_enum<QueryMode, true>("QueryMode", query_mode);
+
+  const std::initializer_list<std::pair<sol::string_view, ShapeQuery::Type>> shape_query_type = {
+    ENUM_FIELD(ShapeQuery::Type, Sphere),
+    ENUM_FIELD(ShapeQuery::Type, Box),
+    ENUM_FIELD(ShapeQuery::Type, Capsule),
+  };
+  state->new_enum<ShapeQuery::Type, true>("ShapeQueryType", shape_query_type);
+
+  auto hit_type = state->new_usertype<QueryHit>("QueryHit");
+  SET_TYPE_FIELD(hit_type, QueryHit, entity);
+  SET_TYPE_FIELD(hit_type, QueryHit, body_id);
+  SET_TYPE_FIELD(hit_type, QueryHit, position);
+  SET_TYPE_FIELD(hit_type, QueryHit, normal);
+  SET_TYPE_FIELD(hit_type, QueryHit, fraction);
+  SET_TYPE_FUNCTION(hit_type, QueryHit, has_hit);
+
+  auto shape_query_ut = state->new_usertype<ShapeQuery>("ShapeQuery", sol::constructors<ShapeQuery()>());
+  SET_TYPE_FIELD(shape_query_ut, ShapeQuery, type);
+  SET_TYPE_FIELD(shape_query_ut, ShapeQuery, size);
+  SET_TYPE_FIELD(shape_query_ut, ShapeQuery, position);
+  // Euler angles, like TransformComponent::rotation.
+  shape_query_ut["rotation"] = sol::property([](const ShapeQuery& query) -> Vec3 { return glm::eulerAngles(query.rotation); },
+                                             [](ShapeQuery& query, const Vec3& rotation) { query.rotation = Quat(rotation); });
+  SET_TYPE_FIELD(shape_query_ut, ShapeQuery, direction);
+  SET_TYPE_FIELD(shape_query_ut, ShapeQuery, layer_mask);
+  SET_TYPE_FIELD(shape_query_ut, ShapeQuery, ignore_body);
+
+  const auto to_ray_query = [](const RayCast& ray, const sol::optional<uint16_t> layer_mask) -> RayQuery {
+    return {ray.get_origin(), ray.get_direction(), layer_mask.value_or(0xFFFF)};
+  };
+
+  physics_table.set_function("raycast", [to_ray_query](const RayCast& ray, const sol::optional<uint16_t> layer_mask, const sol::optional<QueryMode> mode) {
+    QueryHit hit = {};
+    PhysicsQuery::raycast(to_ray_query(ray, layer_mask), hit, mode.value_or(QueryMode::Closest));
+    return hit;
+  });
+  physics_table.set_function("raycast_all", [to_ray_query](const RayCast& ray, const uint32_t max_hits, const sol::optional<uint16_t> layer_mask) {
+    std::vector<QueryHit> hits(std::min(max_hits, MAX_LUA_QUERY_HITS));
+    hits.resize(PhysicsQuery::raycast_all(to_ray_query(ray, layer_mask), hits));
+    return hits;
+  });
+  // Takes a table of RayCast's and returns one QueryHit per ray, the rays are processed in parallel.
+  physics_table.set_function("raycast_batch", [to_ray_query](const sol::table& rays, const sol::optional<uint16_t> layer_mask, const sol::optional<QueryMode> mode) {
+    std::vector<RayQuery> queries = {};
+    queries.reserve(rays.size());
+    for (const auto& [_, ray] : rays)
+      queries.emplace_back(to_ray_query(ray.as<RayCast>(), layer_mask));
+
+    std::vector<QueryHit> hits(queries.size());
+    PhysicsQuery::raycast_batch(queries, hits, mode.value_or(QueryMode::Closest));
+    return hits;
+  });
+  physics_table.set_function("shape_cast", [](const ShapeQuery& query, const sol::optional<QueryMode> mode) {
+    QueryHit hit = {};
+    PhysicsQuery::shape_cast(query, hit, mode.value_or(QueryMode::Closest));
+    return hit;
+  });
+  physics_table.set_function("shape_cast_batch", [](const sol::table& shape_queries, const sol::optional<QueryMode> mode) {
+    std::vector<ShapeQuery> queries = {};
+    queries.reserve(shape_queries.size());
+    for (const auto& [_, query] : shape_queries)
+      queries.emplace_back(query.as<ShapeQuery>());
+
+    std::vector<QueryHit> hits(queries.size());
+    PhysicsQuery::shape_cast_batch(queries, hits, mode.value_or(QueryMode::Closest));
+    return hits;
+  });
+  physics_table.set_function("overlap", [](const ShapeQuery& query, const uint32_t max_hits) {
+    std::vector<QueryHit> hits(std::min(max_hits, MAX_LUA_QUERY_HITS));
+    hits.resize(PhysicsQuery::overlap(query, hits));
+    return hits;
+  });
+  physics_table.set_function("overlap_any", [](const ShapeQuery& query) { return PhysicsQuery::overlap_any(query); });
+
   // -- Components ---
   const std::initializer_list<std::pair<sol::string_view, RigidbodyComponent::BodyType>> rigidbody_body_type = {
     ENUM_FIELD(RigidbodyComponent::BodyType, Static),
@@ -67,5 +154,9 @@ void LuaBindings::bind_physics(const Shared<sol::state>& state) {
 
 #define MCC MeshColliderComponent
   REGISTER_COMPONENT(state, MCC, FIELD(MCC, offset), FIELD(MCC, friction), FIELD(MCC, restitution));
+
+#define CHC CharacterControllerComponent
+  REGISTER_COMPONENT(state, CHC, FIELD(CHC, velocity), FIELD(CHC, grounded), FIELD(CHC, jump_force), FIELD(CHC, interpolation), FIELD(CHC, max_step_height),
+                     FIELD(CHC, stick_to_floor_distance));
 }
 }
@@ -0,0 +1,134 @@
+#include "LuaProfiler.hpp"
+
+#include <algorithm>
+#include <sol/sol.hpp>
+
+#include "LuaManager.hpp"
+
+#include "Core/FileSystem.hpp"
+
+#include "Utils/Log.hpp"
+
+namespace ox {
+static uint64_t combine_keys(const uint64_t a, const uint64_t b) {
+  return a ^ (b * 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+}
+
+LuaProfiler::Scope::Scope(const std::string& script, const uint64_t script_hash, const entt::entity entity, const char* callback) {
+  if (mode == Mode::Off)
+    return;
+
+  this->script = &script;
+  this->script_hash = script_hash;
+  this->entity = entity;
+  this->callback = callback;
+  start = Timer::now();
+}
+
+LuaProfiler::Scope::~Scope() {
+  if (!script)
+    return;
+
+  record(*script, script_hash, entity, callback, Timer::duration(start, Timer::now(), 1000.0));
+}
+
+void LuaProfiler::update(lua_State* state) {
+  const auto new_mode = (Mode)glm::clamp(LuaCVar::cvar_profiler.get(), 0, (int32_t)Mode::Sampling);
+  if (new_mode == mode)
+    return;
+
+  if (new_mode == Mode::Sampling)
+    lua_sethook(state, sample_hook, LUA_MASKCOUNT, SAMPLE_INSTRUCTIONS);
+  else if (mode == Mode::Sampling)
+    lua_sethook(state, nullptr, 0, 0);
+
+  mode = new_mode;
+}
+
+void LuaProfiler::reset() {
+  callback_stats.clear();
+  entity_stats.clear();
+  sample_stats.clear();
+}
+
+void LuaProfiler::record(const std::string& script, const uint64_t script_hash, const entt::entity entity, const char* callback, const double ms) {
+  auto& stats = callback_stats[combine_keys(script_hash, (uint64_t)(uintptr_t)callback)];
+  if (stats.calls == 0) {
+    stats.script = script;
+    stats.callback = callback;
+  }
+  stats.calls++;
+  stats.total_ms += ms;
+  stats.max_ms = glm::max(stats.max_ms, ms);
+
+  if (entity == entt::null)
+    return;
+
+  auto& entity_stat = entity_stats[combine_keys(script_hash, (uint64_t)entt::to_integral(entity))];
+  if (entity_stat.calls == 0) {
+    entity_stat.entity = entity;
+    entity_stat.script = script;
+  }
+  entity_stat.calls++;
+  entity_stat.total_ms += ms;
+}
+
+void LuaProfiler::sample_hook(lua_State* state, lua_Debug* debug) {
+  if (!lua_getinfo(state, "Sln", debug))
+    return;
+
+  const std::string key = fmt::format("{}:{}", debug->short_src, debug->currentline);
+  auto& stats = sample_stats[key];
+  if (stats.samples == 0) {
+    stats.source = debug->short_src;
+    stats.function = debug->name ? debug->name : "?";
+    stats.line = debug->currentline;
+  }
+  stats.samples++;
+}
+
+std::vector<LuaProfiler::CallbackStats> LuaProfiler::get_callback_stats() {
+  std::vector<CallbackStats> result = {};
+  result.reserve(callback_stats.size());
+  for (const auto& [key, stats] : callback_stats)
+    result.emplace_back(stats);
+  std::ranges::sort(result, [](const CallbackStats& a, const CallbackStats& b) { return a.total_ms > b.total_ms; });
+  return result;
+}
+
+std::vector<LuaProfiler::EntityStats> LuaProfiler::get_entity_stats() {
+  std::vector<EntityStats> result = {};
+  result.reserve(entity_stats.size());
+  for (const auto& [key, stats] : entity_stats)
+    result.emplace_back(stats);
+  std::ranges::sort(result, [](const EntityStats& a, const EntityStats& b) { return a.total_ms > b.total_ms; });
+  return result;
+}
+
+std::vector<LuaProfiler::SampleStats> LuaProfiler::get_sample_stats() {
+  std::vector<SampleStats> result = {};
+  result.reserve(sample_stats.size());
+  for (const auto& [key, stats] : sample_stats)
+    result.emplace_back(stats);
+  std::ranges::sort(result, [](const SampleStats& a, const SampleStats& b) { return a.samples > b.samples; });
+  return result;
+}
+
+bool LuaProfiler::export_csv(const std::string& path) {
+  std::string csv = {};
+  for (const auto& stats : get_callback_stats())
+    csv += fmt::format("callback,{},{},{},{:.4f},{:.4f}\n", stats.script, stats.callback, stats.calls, stats.total_ms, stats.max_ms);
+  for (const auto& stats : get_entity_stats())
+    csv += fmt::format("entity,{},{},{},{:.4f},\n", stats.script, entt::to_integral(stats.entity), stats.calls, stats.total_ms);
+  for (const auto& stats : get_sample_stats())
+    csv += fmt::format("sample,{}:{},{},{},,\n", stats.source, stats.line, stats.function, stats.samples);
+
+  if (!FileSystem::write_file(path, csv, "kind,script,name,calls_or_samples,total_ms,max_ms")) {
+    OX_LOG_ERROR("Couldn't export the Lua profile to {}", path);
+    return false;
+  }
+
+  OX_LOG_INFO("Exported the Lua profile to {}", path);
+  return true;
+}
+}
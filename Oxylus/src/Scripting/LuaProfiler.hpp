@@ -0,0 +1,90 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include <ankerl/unordered_dense.h>
+
+#include <entt/entity/entity.hpp>
+
+#include "Utils/Timer.hpp"
+
+struct lua_State;
+struct lua_Debug;
+
+namespace ox {
+/// Built-in script profiler, driven by the lua.profiler CVar.
+/// Timers mode times every LuaSystem callback and aggregates the results per script/callback and per entity.
+/// Sampling mode additionally installs an instruction count hook that attributes samples to Lua functions and lines.
+/// With LuaJIT the hook only sees interpreted code, traces compiled by the JIT don't run hooks.
+/// Results accumulate until reset(), they can be read from Lua (the Profiler table) or the editor and exported as CSV.
+class LuaProfiler {
+public:
+  enum class Mode {
+    Off = 0,
+    Timers,
+    Sampling,
+  };
+
+  /// The sampling hook fires every this many VM instructions.
+  static constexpr int SAMPLE_INSTRUCTIONS = 1000;
+
+  struct CallbackStats {
+    std::string script = {};
+    const char* callback = nullptr;
+    uint64_t calls = 0;
+    double total_ms = 0.0;
+    double max_ms = 0.0;
+  };
+
+  struct EntityStats {
+    entt::entity entity = entt::null;
+    std::string script = {};
+    uint64_t calls = 0;
+    double total_ms = 0.0;
+  };
+
+  struct SampleStats {
+    std::string source = {};
+    std::string function = {};
+    int line = 0;
+    uint64_t samples = 0;
+  };
+
+  /// Times one callback while the profiler is on, does nothing otherwise.
+  class Scope {
+  public:
+    Scope(const std::string& script, uint64_t script_hash, entt::entity entity, const char* callback);
+    ~Scope();
+
+  private:
+    const std::string* script = nullptr;
+    uint64_t script_hash = 0;
+    entt::entity entity = entt::null;
+    const char* callback = nullptr;
+    TimeStamp start = {};
+  };
+
+  /// Applies the CVar, installs or removes the sampling hook. LuaManager calls it every frame.
+  static void update(lua_State* state);
+  static Mode get_mode() { return mode; }
+  static void reset();
+
+  /// Sorted by total time, slowest first.
+  static std::vector<CallbackStats> get_callback_stats();
+  static std::vector<EntityStats> get_entity_stats();
+  /// Sorted by sample count.
+  static std::vector<SampleStats> get_sample_stats();
+
+  static bool export_csv(const std::string& path);
+
+private:
+  static inline Mode mode = Mode::Off;
+
+  static inline ankerl::unordered_dense::map<uint64_t, CallbackStats> callback_stats = {};
+  static inline ankerl::unordered_dense::map<uint64_t, EntityStats> entity_stats = {};
+  static inline ankerl::unordered_dense::map<std::string, SampleStats> sample_stats = {};
+
+  static void record(const std::string& script, uint64_t script_hash, entt::entity entity, const char* callback, double ms);
+  static void sample_hook(lua_State* state, lua_Debug* debug);
+};
+}
@@ -305,6 +305,14 @@ void bind_scene(const Shared<sol::state>& state) {
   scene_type.set_function("get_registry", &Scene::get_registry);
   scene_type.set_function("create_entity", [](Scene& self, const std::string& name) { return self.create_entity(name); });
   scene_type.set_function("load_mesh", &Scene::load_mesh);
+  scene_type.set_function("add_force", &Scene::add_force);
+  scene_type.set_function("add_impulse", &Scene::add_impulse);
+  scene_type.set_function("set_linear_velocity", &Scene::set_linear_velocity);
+  scene_type.set_function("set_angular_velocity", &Scene::set_angular_velocity);
+  // Euler angles, like TransformComponent::rotation.
+  scene_type.set_function("teleport", [](Scene& self, const entt::entity entity, const Vec3& position, const Vec3& rotation) {
+    return self.teleport(entity, position, Quat(rotation));
+  });
 
   auto entt_module = (*state)["entt"].get_or_create<sol::table>();
 
@@ -5,6 +5,7 @@
 #include <sol/state.hpp>
 
 #include "LuaManager.hpp"
+#include "LuaProfiler.hpp"
 
 #include "Core/App.hpp"
 
@@ -15,6 +16,7 @@
 
 namespace ox {
 LuaSystem::LuaSystem(std::string path) : file_path(std::move(path)) {
+  path_hash = ankerl::unordered_dense::hash<std::string>{}(file_path);
   init_script(file_path);
 }
 
@@ -32,16 +34,34 @@ void LuaSystem::init_script(const std::string& path) {
     return;
   }
 
-  const auto state = App::get_system<LuaManager>()->get_state();
+  auto* lua_manager = App::get_system<LuaManager>();
+  const auto state = lua_manager->get_state();
   environment = create_unique<sol::environment>(*state, sol::create, state->globals());
 
-  const auto load_file_result = state->script_file(file_path, *environment, sol::script_pass_on_error);
+  // The chunk comes from the manager's bytecode cache, instances of the same file don't compile it again.
+  std::string load_error = {};
+  sol::protected_function chunk = {};
+  {
+    sol::load_result loaded = lua_manager->load_script(file_path);
+    if (loaded.valid())
+      chunk = loaded;
+    else
+      load_error = loaded.get<sol::error>().what();
+  }
+
+  if (chunk.valid()) {
+    sol::set_environment(*environment, chunk);
+    const auto result = chunk.call();
+    if (!result.valid()) {
+      const sol::error err = result;
+      load_error = err.what();
+    }
+  }
 
-  if (!load_file_result.valid()) {
-    const sol::error err = load_file_result;
+  if (!load_error.empty()) {
     OX_LOG_ERROR("Failed to Execute Lua script {0}", file_path);
-    OX_LOG_ERROR("Error : {0}", err.what());
-    std::string error = std::string(err.what());
+    OX_LOG_ERROR("Error : {0}", load_error);
+    std::string error = load_error;
 
     const auto linepos = error.find(".lua:");
     std::string error_line = error.substr(linepos + 5); //+4 .lua: + 1
@@ -65,6 +85,10 @@ void LuaSystem::init_script(const std::string& path) {
   if (!on_update_func->valid())
     on_update_func.reset();
 
+  on_update_all_func = create_unique<sol::protected_function>((*environment)["on_update_all"]);
+  if (!on_update_all_func->valid())
+    on_update_all_func.reset();
+
   on_imgui_render_func = create_unique<sol::protected_function>((*environment)["on_imgui_render"]);
   if (!on_imgui_render_func->valid())
     on_imgui_render_func.reset();
@@ -73,15 +97,26 @@ void LuaSystem::init_script(const std::string& path) {
   if (!on_release_func->valid())
     on_release_func.reset();
 
-  state->collect_gc();
+  on_character_contact_func = create_unique<sol::protected_function>((*environment)["on_character_contact"]);
+  if (!on_character_contact_func->valid())
+    on_character_contact_func.reset();
+
+  const sol::object on_job_update = (*environment)["on_job_update"];
+  job_safe = environment->get_or("job_safe", false) && on_job_update.get_type() == sol::type::function;
+
+  // Reloads get a new environment, it keeps the globals of the old one.
+  if (bound_scene)
+    bind_globals(bound_scene, entity);
 }
 
 void LuaSystem::on_init(Scene* scene, entt::entity entity) {
   OX_SCOPED_ZONE;
+  if (!environment)
+    return;
+
+  bind_globals(scene, entity);
   if (on_init_func) {
-    (*environment)["scene"] = scene;
-    (*environment)["owner"] = std::ref(scene->registry);
-    (*environment)["this"] = entity;
+    const LuaProfiler::Scope profile(file_path, path_hash, entity, "on_init");
     const auto result = on_init_func->call();
     check_result(result, "on_init");
   }
@@ -90,32 +125,54 @@ void LuaSystem::on_init(Scene* scene, entt::entity entity) {
 void LuaSystem::on_update(const Timestep& delta_time) {
   OX_SCOPED_ZONE;
   if (on_update_func) {
+    const LuaProfiler::Scope profile(file_path, path_hash, entity, "on_update");
     const auto result = on_update_func->call(delta_time.get_millis());
     check_result(result, "on_update");
   }
 }
 
+void LuaSystem::on_update_all(const std::vector<entt::entity>& entities, const Timestep& delta_time) {
+  OX_SCOPED_ZONE;
+  if (on_update_all_func) {
+    const LuaProfiler::Scope profile(file_path, path_hash, entt::null, "on_update_all");
+    const auto result = on_update_all_func->call(sol::as_table(std::ref(entities)), delta_time.get_millis());
+    check_result(result, "on_update_all");
+  }
+}
+
 void LuaSystem::on_release(Scene* scene, entt::entity entity) {
   OX_SCOPED_ZONE;
   if (on_release_func) {
+    const LuaProfiler::Scope profile(file_path, path_hash, entity, "on_release");
     const auto result = on_release_func->call();
     (*environment)["scene"] = scene;
     (*environment)["owner"] = std::ref(scene->registry);
     (*environment)["this"] = entity;
     check_result(result, "on_release");
   }
-
-  App::get_system<LuaManager>()->get_state()->collect_gc();
 }
 
 void LuaSystem::on_imgui_render(const Timestep& delta_time) {
   OX_SCOPED_ZONE;
   if (on_imgui_render_func) {
+    const LuaProfiler::Scope profile(file_path, path_hash, entity, "on_imgui_render");
     const auto result = on_imgui_render_func->call(delta_time.get_millis());
     check_result(result, "on_imgui_render");
   }
 }
 
+void LuaSystem::on_character_contact(Scene* scene, entt::entity entity, entt::entity other, const Vec3& position, const Vec3& normal) {
+  OX_SCOPED_ZONE;
+  if (on_character_contact_func) {
+    (*environment)["scene"] = scene;
+    (*environment)["owner"] = std::ref(scene->registry);
+    (*environment)["this"] = entity;
+    const LuaProfiler::Scope profile(file_path, path_hash, entity, "on_character_contact");
+    const auto result = on_character_contact_func->call(other, position, normal);
+    check_result(result, "on_character_contact");
+  }
+}
+
 void LuaSystem::load(const std::string& path) {
   OX_SCOPED_ZONE;
   init_script(path);
@@ -134,10 +191,13 @@ void LuaSystem::reload() {
   init_script(file_path);
 }
 
-void LuaSystem::bind_globals(Scene* scene, entt::entity entity, const Timestep& timestep) {
+void LuaSystem::bind_globals(Scene* scene, const entt::entity entity) {
+  if (!environment)
+    return;
+  bound_scene = scene;
+  this->entity = entity;
   (*environment)["scene"] = scene;
   (*environment)["owner"] = std::ref(scene->registry);
   (*environment)["this"] = entity;
-  (*environment)["current_time"] = timestep.get_elapsed_seconds();
 }
 }
@@ -9,6 +9,12 @@
 #include "Core/Systems/System.hpp"
 
 namespace ox {
+/// A Lua script attached to an entity through a LuaScriptComponent, every attachment gets its own environment.
+/// Scripts that define `on_update_all(entities, dt)` are batched: the scene calls it once per frame for every script file,
+/// with all entities running that file in an array, instead of calling `on_update` per entity.
+/// The call runs in the environment of one of the instances, so batched scripts should keep per-entity state in components.
+/// Scripts that set `job_safe = true` and define `on_job_update(job, dt)` run in parallel on LuaJobPool's worker states
+/// instead, `on_update` isn't called for them.
 class LuaSystem {
 public:
   LuaSystem(std::string path);
@@ -17,25 +23,42 @@ public:
   void load(const std::string& path);
   void reload();
 
-  void bind_globals(Scene* scene, entt::entity entity, const Timestep& timestep);
+  /// Sets `scene`, `owner` and `this`. on_init does it and reloads keep them, scripts attached while the scene runs get them
+  /// from the scene's update through bind_globals_if_needed.
+  void bind_globals(Scene* scene, entt::entity entity);
+  void bind_globals_if_needed(Scene* scene, const entt::entity entity) {
+    if (bound_scene != scene || this->entity != entity)
+      bind_globals(scene, entity);
+  }
 
   void on_init(Scene* scene, entt::entity entity);
   void on_update(const Timestep& delta_time);
+  void on_update_all(const std::vector<entt::entity>& entities, const Timestep& delta_time);
   void on_release(Scene* scene, entt::entity entity);
   void on_imgui_render(const Timestep& delta_time);
+  void on_character_contact(Scene* scene, entt::entity entity, entt::entity other, const Vec3& position, const Vec3& normal);
 
   const std::string& get_path() const { return file_path; }
+  uint64_t get_path_hash() const { return path_hash; }
+  bool is_batched() const { return on_update_all_func != nullptr; }
+  bool is_job_safe() const { return job_safe; }
 
 private:
   std::string file_path;
+  uint64_t path_hash = 0;
+  Scene* bound_scene = nullptr;
+  entt::entity entity = entt::null; // Bound in on_init, used to attribute profiler timings
+  bool job_safe = false;
   ankerl::unordered_dense::map<int, std::string> errors = {};
 
   Unique<sol::environment> environment = nullptr;
   Unique<sol::protected_function> on_init_func = nullptr;
   Unique<sol::protected_function> on_release_func = nullptr;
   Unique<sol::protected_function> on_update_func = nullptr;
+  Unique<sol::protected_function> on_update_all_func = nullptr;
   Unique<sol::protected_function> on_imgui_render_func = nullptr;
   Unique<sol::protected_function> on_fixed_update_func = nullptr;
+  Unique<sol::protected_function> on_character_contact_func = nullptr;
 
   void init_script(const std::string& path);
   void check_result(const sol::protected_function_result& result, const char* func_name);
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "Core/Base.hpp"
+
+#include "Utils/Log.hpp"
+
+namespace ox {
+/// Bounded multi producer multi consumer queue (Dmitry Vyukov's design).
+/// Capacity has to be a power of two, pushing into a full queue fails instead of allocating.
+template <typename T>
+class LockFreeQueue {
+public:
+  explicit LockFreeQueue(const uint32_t capacity) : cells(create_unique<Cell[]>(capacity)), mask(capacity - 1) {
+    OX_ASSERT(capacity >= 2 && (capacity & (capacity - 1)) == 0, "LockFreeQueue capacity must be a power of two");
+    for (uint32_t i = 0; i < capacity; i++)
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  ~LockFreeQueue() = default;
+  DELETE_DEFAULT_CONSTRUCTORS(LockFreeQueue)
+
+  template <typename U>
+  bool try_push(U&& value) {
+    Cell* cell;
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells[pos & mask];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false; // full
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->data = std::forward<U>(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Spins until there is room in the queue.
+  template <typename U>
+  void push(U&& value) {
+    while (!try_push(std::forward<U>(value)))
+      std::this_thread::yield();
+  }
+
+  bool try_pop(T& value) {
+    Cell* cell;
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells[pos & mask];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false; // empty
+      } else {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    value = std::move(cell->data);
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t get_capacity() const { return mask + 1; }
+  size_t size_approx() const { return enqueue_pos.load(std::memory_order_relaxed) - dequeue_pos.load(std::memory_order_relaxed); }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  Unique<Cell[]> cells;
+  size_t mask;
+
+  alignas(64) std::atomic<size_t> enqueue_pos = 0;
+  alignas(64) std::atomic<size_t> dequeue_pos = 0;
+};
+}
@@ -9,7 +9,10 @@ namespace ox {
 void TaskScheduler::init() {
   OX_SCOPED_ZONE;
   task_scheduler = create_unique<enki::TaskScheduler>();
-  task_scheduler->Initialize();
+  enki::TaskSchedulerConfig config = {};
+  config.numExternalTaskThreads = MAX_EXTERNAL_THREADS;
+  config.profilerCallbacks.threadStart = [](const uint32_t thread_num) { CpuProfiler::set_thread_name(fmt::format("Worker {}", thread_num)); };
+  task_scheduler->Initialize(config);
   task_sets.reserve(100);
 
   OX_LOG_INFO("TaskScheduler initalized.");
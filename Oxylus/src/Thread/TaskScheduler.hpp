@@ -6,6 +6,9 @@
 namespace ox {
 class TaskScheduler : public ESystem {
 public:
+  /// Non-worker threads (e.g. the physics thread) that are allowed to add and wait for tasks.
+  static constexpr uint32_t MAX_EXTERNAL_THREADS = 2;
+
   TaskScheduler() = default;
 
   void init() override;
@@ -18,8 +21,25 @@ public:
     task_scheduler->AddTaskSetToPipe(task_sets.emplace_back(create_unique<enki::TaskSet>(f)).get());
   }
 
+  /// Splits [0, count) into ranges of at least min_range and runs them on the workers, blocks until all are done.
+  template <typename func> void parallel_for(uint32_t count, uint32_t min_range, func function) {
+    if (count == 0)
+      return;
+    enki::TaskSet task(count, [&function](enki::TaskSetPartition range, uint32_t thread_num) {
+      for (uint32_t i = range.start; i < range.end; ++i)
+        function(i, thread_num);
+    });
+    task.m_MinRange = min_range;
+    task_scheduler->AddTaskSetToPipe(&task);
+    task_scheduler->WaitforTask(&task);
+  }
+
   void wait_for_all();
 
+  /// Has to be called from a thread not created by the scheduler before it can queue tasks.
+  bool register_external_thread() const { return task_scheduler->RegisterExternalTaskThread(); }
+  void deregister_external_thread() const { task_scheduler->DeRegisterExternalTaskThread(); }
+
 private:
   Unique<enki::TaskScheduler> task_scheduler;
   std::vector<Unique<enki::TaskSet>> task_sets = {};
@@ -0,0 +1,42 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ox {
+/// Lock-free triple buffer for handing the latest state from one writer thread to one reader thread.
+/// The writer never waits for the reader and the reader always sees a complete buffer.
+template <typename T>
+class TripleBuffer {
+public:
+  TripleBuffer() = default;
+
+  /// Writer: buffer to fill before calling publish().
+  T& get_write_buffer() { return buffers[back]; }
+
+  /// Writer: makes the write buffer visible to the reader.
+  void publish() {
+    back = middle.exchange((uint8_t)(back | DIRTY_BIT), std::memory_order_acq_rel) & INDEX_MASK;
+  }
+
+  /// Reader: swaps in the newest published buffer. Returns false if nothing new was published.
+  bool acquire() {
+    if ((middle.load(std::memory_order_relaxed) & DIRTY_BIT) == 0)
+      return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+
+  /// Reader: latest acquired buffer.
+  const T& get_read_buffer() const { return buffers[front]; }
+
+private:
+  static constexpr uint8_t DIRTY_BIT = 0x4;
+  static constexpr uint8_t INDEX_MASK = 0x3;
+
+  std::array<T, 3> buffers = {};
+  uint8_t front = 0;
+  uint8_t back = 1;
+  std::atomic<uint8_t> middle = 2;
+};
+}
@@ -31,11 +31,6 @@ static const char8_t* get_level_icon(const loguru::Verbosity level) {
 }
 
 RuntimeConsole::RuntimeConsole() {
-  Log::add_callback("runtime_console", [](void* user_data, const loguru::Message& message) {
-    const auto console = reinterpret_cast<RuntimeConsole*>(user_data);
-    console->add_log(message.message, message.verbosity);
-  }, this, loguru::Verbosity_INFO);
-
   // Default commands
   register_command("quit", "", [] { App::get()->close(); });
   register_command("clear", "", [this] { clear_log(); });
@@ -44,9 +39,7 @@ RuntimeConsole::RuntimeConsole() {
   request_scroll_to_bottom = true;
 }
 
-RuntimeConsole::~RuntimeConsole() {
-  Log::remove_callback("runtime_console");
-}
+RuntimeConsole::~RuntimeConsole() = default;
 
 void RuntimeConsole::register_command(const std::string& command, const std::string& on_succes_log, const std::function<void()>& action) {
   command_map.emplace(command, ConsoleCommand{nullptr, nullptr, nullptr, action, on_succes_log});
@@ -74,6 +67,12 @@ void RuntimeConsole::add_log(const char* fmt, loguru::Verbosity verb) {
 void RuntimeConsole::clear_log() { text_buffer.clear(); }
 
 void RuntimeConsole::on_imgui_render() {
+  // Messages are written on the log thread, the console picks them up from its ring here.
+  log_messages.clear();
+  Log::get_console_messages(log_sequence, log_messages);
+  for (const auto& message : log_messages)
+    add_log(message.text.c_str(), message.verbosity);
+
   if (ImGui::IsKeyPressed(ImGuiKey_GraveAccent, false)) {
     visible = !visible;
   }
@@ -76,6 +76,8 @@ private:
   static constexpr uint32_t MAX_TEXT_BUFFER_SIZE = 32;
   int32_t history_position = 0;
   std::vector<ConsoleText> text_buffer = {};
+  uint64_t log_sequence = 0;
+  std::vector<Log::ConsoleMessage> log_messages = {};
   std::vector<char*> input_log = {};
   bool request_scroll_to_bottom = true;
   int input_text_callback(ImGuiInputTextCallbackData* data);
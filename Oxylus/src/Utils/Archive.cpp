@@ -1,5 +1,7 @@
 ﻿#include "Archive.hpp"
 
+#include <cstring>
+
 #include "Core/FileSystem.hpp"
 #include "Log.hpp"
 
@@ -12,8 +14,10 @@ Archive::Archive(const std::string& file_name, bool read_mode) : read_mode(read_
   if (!file_name.empty()) {
     directory = FileSystem::get_directory(file_name);
     if (read_mode) {
-      if (const auto content = FileSystem::read_file_binary(file_name); !content.empty()) {
-        data_ptr = content.data();
+      _data = FileSystem::read_file_binary(file_name);
+      if (!_data.empty()) {
+        data_ptr = _data.data();
+        data_size = _data.size();
         (*this) >> version;
       }
     } else {
@@ -27,11 +31,42 @@ Archive::Archive(const uint8_t* data) {
   set_read_mode_and_reset_pos(true);
 }
 
+Archive::Archive(const uint8_t* data, const size_t size) {
+  data_ptr = data;
+  data_size = size;
+  set_read_mode_and_reset_pos(true);
+}
+
 void Archive::write_data(std::vector<uint8_t>& dest) const {
   dest.resize(pos);
   std::memcpy(dest.data(), data_ptr, pos);
 }
 
+void Archive::write_bytes(const void* data, const size_t size) {
+  OX_ASSERT(!read_mode);
+  OX_ASSERT(!_data.empty());
+  const size_t _right = pos + size;
+  if (_right > _data.size()) {
+    _data.resize(_right * 2);
+    data_ptr = _data.data();
+  }
+  std::memcpy(_data.data() + pos, data, size);
+  pos = _right;
+}
+
+bool Archive::read_bytes(void* data, const size_t size) {
+  OX_ASSERT(read_mode);
+  OX_ASSERT(data_ptr != nullptr);
+  if (!can_read(size)) {
+    std::memset(data, 0, size);
+    pos = data_size;
+    return false;
+  }
+  std::memcpy(data, data_ptr + pos, size);
+  pos += size;
+  return true;
+}
+
 void Archive::create_empty() {
   version = ARCHIVE_VERSION;
   _data.resize(128); // starting size
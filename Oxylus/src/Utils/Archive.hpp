@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -10,12 +11,18 @@ public:
   Archive();
   Archive(const std::string& file_name, bool read_mode = true);
   Archive(const uint8_t* data);
+  /// Reads stop at size, see can_read.
+  Archive(const uint8_t* data, size_t size);
   ~Archive() { close(); }
 
   void write_data(std::vector<uint8_t>& dest) const;
 
   const uint8_t* get_data() const { return data_ptr; }
   size_t get_pos() const { return pos; }
+  /// Readable bytes, SIZE_MAX when the archive was made from a pointer without a size.
+  size_t get_size() const { return data_size; }
+  /// True if size more bytes can be read. Reads past the end read zeros and leave the position at the end.
+  bool can_read(const size_t size) const { return pos <= data_size && size <= data_size - pos; }
   constexpr uint64_t get_version() const { return version; }
   constexpr bool is_read_mode() const { return read_mode; }
 
@@ -59,6 +66,11 @@ public:
   //	It can be used in conjunction with WriteUnknownJumpPosition() and PatchUnknownJumpPosition()
   void jump(uint64_t jump_pos) { pos = jump_pos; }
 
+  /// @brief Raw byte copy for data that is already serialized (e.g. Jolt state streams). The size isn't stored.
+  void write_bytes(const void* data, size_t size);
+  /// False if there weren't size bytes left, data is zeroed then.
+  bool read_bytes(void* data, size_t size);
+
   // It could be templated but we have to be extremely careful of different datasizes on different platforms
   // because serialized data should be interchangeable!
   // So providing exact copy operations for exact types enforces platform agnosticism
@@ -206,6 +218,7 @@ private:
   uint32_t version = 0;
   bool read_mode = false;
   size_t pos = 0;
+  size_t data_size = SIZE_MAX;
   std::vector<uint8_t> _data = {};
   const uint8_t* data_ptr = nullptr;
 
@@ -233,6 +246,11 @@ private:
   template <typename T> void _read(T& data) {
     OX_ASSERT(read_mode);
     OX_ASSERT(data_ptr != nullptr);
+    if (!can_read(sizeof(data))) {
+      data = {};
+      pos = data_size;
+      return;
+    }
     data = *(const T*)(data_ptr + pos);
     pos += (size_t)(sizeof(data));
   }
@@ -11,6 +11,31 @@
 #include "Profiler.hpp"
 
 namespace ox {
+static_assert(std::atomic_ref<int32_t>::required_alignment == alignof(int32_t));
+static_assert(std::atomic_ref<float>::required_alignment == alignof(float));
+
+template <typename T> static void store_cvar(CVarStorage<T>& storage, const T value) {
+  std::atomic_ref(storage.current).store(value, std::memory_order_relaxed);
+  storage.version.fetch_add(1, std::memory_order_release);
+}
+
+template <typename T> static void dispatch_cvar(CVarStorage<T>& storage, const T& value) {
+  const uint32_t version = storage.version.load(std::memory_order_acquire);
+  if (value == storage.last_dispatched) {
+    storage.dispatched_version = version; // Set back to the old value before anyone saw it
+    return;
+  }
+
+  // Changed without set(), through get_ptr()
+  if (version == storage.dispatched_version)
+    storage.version.fetch_add(1, std::memory_order_release);
+
+  storage.last_dispatched = value;
+  storage.dispatched_version = storage.version.load(std::memory_order_acquire);
+  for (const auto& [id, callback] : storage.callbacks)
+    callback(value);
+}
+
 float* CVarSystem::get_float_cvar(const uint32_t hash) {
   OX_SCOPED_ZONE;
   const CVarParameter* par = get_cvar(hash);
@@ -47,28 +72,44 @@ CVarSystem* CVarSystem::get() {
 CVarParameter* CVarSystem::get_cvar(const uint32_t hash) {
   std::shared_lock lock(mutex_);
 
-  if (saved_cvars.contains(hash))
-    return saved_cvars[hash].get();
-
-  return nullptr;
+  const auto it = saved_cvars.find(hash);
+  return it != saved_cvars.end() ? it->second.get() : nullptr;
 }
 
 void CVarSystem::set_float_cvar(const uint32_t hash, const float value) {
   const CVarParameter* cvar = get_cvar(hash);
   if (cvar)
-    float_cvars[cvar->array_index].current = value;
+    store_cvar(float_cvars[cvar->array_index], value);
 }
 
 void CVarSystem::set_int_cvar(const uint32_t hash, const int32_t value) {
   const CVarParameter* cvar = get_cvar(hash);
   if (cvar)
-    int_cvars[cvar->array_index].current = value;
+    store_cvar(int_cvars[cvar->array_index], value);
 }
 
 void CVarSystem::set_string_cvar(const uint32_t hash, const char* value) {
   const CVarParameter* cvar = get_cvar(hash);
-  if (cvar)
-    string_cvars[cvar->array_index].current = value;
+  if (!cvar)
+    return;
+
+  std::unique_lock lock(mutex_);
+  auto& storage = string_cvars[cvar->array_index];
+  storage.current = value;
+  storage.version.fetch_add(1, std::memory_order_release);
+}
+
+void CVarSystem::dispatch_changes() {
+  OX_SCOPED_ZONE;
+  // Callbacks run with the lock held shared: they can get and set int and float cvars,
+  // but not create cvars, subscribe or touch string cvars.
+  std::shared_lock lock(mutex_);
+  for (auto& storage : int_cvars)
+    dispatch_cvar(storage, std::atomic_ref(storage.current).load(std::memory_order_relaxed));
+  for (auto& storage : float_cvars)
+    dispatch_cvar(storage, std::atomic_ref(storage.current).load(std::memory_order_relaxed));
+  for (auto& storage : string_cvars)
+    dispatch_cvar(storage, storage.current);
 }
 
 CVarParameter* CVarSystem::create_float_cvar(const char* name, const char* description, const float default_value, const float current_value) {
@@ -77,7 +118,7 @@ CVarParameter* CVarSystem::create_float_cvar(const char* name, const char* descr
 
   param->type = CVarType::FLOAT;
   param->array_index = (uint32_t)float_cvars.size();
-  float_cvars.emplace_back(default_value, current_value, param);
+  float_cvars.emplace_back(default_value, current_value, param).last_dispatched = current_value;
 
   return param;
 }
@@ -88,7 +129,7 @@ CVarParameter* CVarSystem::create_int_cvar(const char* name, const char* descrip
 
   param->type = CVarType::INT;
   param->array_index = (uint32_t)int_cvars.size();
-  int_cvars.emplace_back(default_value, current_value, param);
+  int_cvars.emplace_back(default_value, current_value, param).last_dispatched = current_value;
 
   return param;
 }
@@ -99,7 +140,7 @@ CVarParameter* CVarSystem::create_string_cvar(const char* name, const char* desc
 
   param->type = CVarType::STRING;
   param->array_index = (uint32_t)string_cvars.size();
-  string_cvars.emplace_back(default_value, current_value, param);
+  string_cvars.emplace_back(default_value, current_value, param).last_dispatched = current_value;
 
   return param;
 }
@@ -112,37 +153,21 @@ CVarParameter* CVarSystem::init_cvar(const char* name, const char* description)
 AutoCVar_Float::AutoCVar_Float(const char* name, const char* description, const float default_value, const CVarFlags flags) {
   CVarParameter* cvar = CVarSystem::get()->create_float_cvar(name, description, default_value, default_value);
   cvar->flags = flags;
-  index = cvar->array_index;
-}
-
-float AutoCVar_Float::get() const {
-  return CVarSystem::get()->float_cvars.at(index).current;
-}
-
-float* AutoCVar_Float::get_ptr() const {
-  return &CVarSystem::get()->float_cvars[index].current;
+  storage = &CVarSystem::get()->float_cvars[cvar->array_index];
 }
 
 void AutoCVar_Float::set(const float val) const {
-  CVarSystem::get()->float_cvars.at(index).current = val;
+  store_cvar(*storage, val);
 }
 
 AutoCVar_Int::AutoCVar_Int(const char* name, const char* description, const int32_t default_value, const CVarFlags flags) {
   CVarParameter* cvar = CVarSystem::get()->create_int_cvar(name, description, default_value, default_value);
   cvar->flags = flags;
-  index = cvar->array_index;
-}
-
-int32_t AutoCVar_Int::get() const {
-  return CVarSystem::get()->int_cvars.at(index).current;
-}
-
-int32_t* AutoCVar_Int::get_ptr() const {
-  return &CVarSystem::get()->int_cvars.at(index).current;
+  storage = &CVarSystem::get()->int_cvars[cvar->array_index];
 }
 
 void AutoCVar_Int::set(const int32_t val) const {
-  CVarSystem::get()->int_cvars.at(index).current = val;
+  store_cvar(*storage, val);
 }
 
 void AutoCVar_Int::toggle() const {
@@ -154,14 +179,17 @@ void AutoCVar_Int::toggle() const {
 AutoCVar_String::AutoCVar_String(const char* name, const char* description, const char* default_value, const CVarFlags flags) {
   CVarParameter* cvar = CVarSystem::get()->create_string_cvar(name, description, default_value, default_value);
   cvar->flags = flags;
-  index = cvar->array_index;
+  storage = &CVarSystem::get()->string_cvars[cvar->array_index];
 }
 
 std::string AutoCVar_String::get() const {
-  return CVarSystem::get()->string_cvars.at(index).current;
+  std::shared_lock lock(CVarSystem::get()->get_mutex());
+  return storage->current;
 };
 
 void AutoCVar_String::set(std::string&& val) const {
-  CVarSystem::get()->string_cvars.at(index).current = val;
+  std::unique_lock lock(CVarSystem::get()->get_mutex());
+  storage->current = std::move(val);
+  storage->version.fetch_add(1, std::memory_order_release);
 }
 }
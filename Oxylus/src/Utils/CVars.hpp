@@ -1,5 +1,8 @@
 ﻿#pragma once
 
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <shared_mutex>
 
 #include <ankerl/unordered_dense.h>
@@ -37,11 +40,20 @@ public:
   std::string description;
 };
 
+/// `current` is read and written through std::atomic_ref for ints and floats, UI widgets edit it directly through get_ptr().
+/// The storage never moves once created, AutoCVars keep a pointer to it.
 template <typename T>
 struct CVarStorage {
+  using Callback = std::function<void(const T&)>;
+
   T initial;
   T current;
   CVarParameter* parameter;
+
+  std::atomic<uint32_t> version = 0; // Bumped on every change
+  T last_dispatched = {};
+  uint32_t dispatched_version = 0;
+  std::vector<std::pair<uint32_t, Callback>> callbacks = {};
 };
 
 class CVarSystem {
@@ -50,9 +62,9 @@ public:
   constexpr static int MAX_FLOAT_CVARS = 1000;
   constexpr static int MAX_STRING_CVARS = 200;
 
-  std::vector<CVarStorage<int32_t>> int_cvars = {};
-  std::vector<CVarStorage<float>> float_cvars = {};
-  std::vector<CVarStorage<std::string>> string_cvars = {};
+  std::deque<CVarStorage<int32_t>> int_cvars = {};
+  std::deque<CVarStorage<float>> float_cvars = {};
+  std::deque<CVarStorage<std::string>> string_cvars = {};
 
   CVarSystem() = default;
 
@@ -71,33 +83,65 @@ public:
   void set_int_cvar(uint32_t hash, int32_t value);
   void set_string_cvar(uint32_t hash, const char* value);
 
+  /// Runs the change callbacks of every cvar that changed since the last call, on the calling thread.
+  /// App calls it at the start of every frame, so callbacks always run on the main thread.
+  /// Also picks up edits made through get_ptr().
+  void dispatch_changes();
+
+  template <typename T> uint32_t subscribe(CVarStorage<T>& storage, typename CVarStorage<T>::Callback callback) {
+    std::unique_lock lock(mutex_);
+    const uint32_t id = ++last_callback_id;
+    storage.callbacks.emplace_back(id, std::move(callback));
+    return id;
+  }
+
+  template <typename T> void unsubscribe(CVarStorage<T>& storage, const uint32_t id) {
+    std::unique_lock lock(mutex_);
+    std::erase_if(storage.callbacks, [id](const auto& callback) { return callback.first == id; });
+  }
+
+  std::shared_mutex& get_mutex() { return mutex_; }
+
 private:
   std::shared_mutex mutex_;
+  uint32_t last_callback_id = 0;
   ankerl::unordered_dense::map<uint32_t, Unique<CVarParameter>> saved_cvars;
   std::vector<CVarParameter*> cached_edit_parameters;
 
   CVarParameter* init_cvar(const char* name, const char* description);
 };
 
+/// Resolves to its storage once, get() and set() are a relaxed atomic load and store without any lookup or lock.
 template <typename T>
 struct AutoCVar {
+  using Callback = typename CVarStorage<T>::Callback;
+
+  /// Bumped on every change, cheap to compare against a cached value.
+  uint32_t get_version() const { return storage->version.load(std::memory_order_acquire); }
+
+  /// The callback runs on the main thread at the start of the frame after the change, see CVarSystem::dispatch_changes.
+  uint32_t subscribe(Callback callback) const { return CVarSystem::get()->subscribe(*storage, std::move(callback)); }
+  void unsubscribe(const uint32_t id) const { CVarSystem::get()->unsubscribe(*storage, id); }
+
 protected:
-  uint32_t index;
+  CVarStorage<T>* storage = nullptr;
   using CVarType = T;
 };
 
 struct AutoCVar_Float : AutoCVar<float> {
   AutoCVar_Float(const char* name, const char* description, float default_value, CVarFlags flags = CVarFlags::None);
 
-  float get() const;
-  float* get_ptr() const;
+  float get() const { return std::atomic_ref(storage->current).load(std::memory_order_relaxed); }
+  /// For UI widgets only, edits through it are seen by dispatch_changes.
+  float* get_ptr() const { return &storage->current; }
   void set(float val) const;
 };
 
 struct AutoCVar_Int : AutoCVar<int32_t> {
   AutoCVar_Int(const char* name, const char* description, int32_t default_value, CVarFlags flags = CVarFlags::None);
-  int32_t get() const;
-  int32_t* get_ptr() const;
+  int32_t get() const { return std::atomic_ref(storage->current).load(std::memory_order_relaxed); }
+  /// For UI widgets only, edits through it are seen by dispatch_changes.
+  int32_t* get_ptr() const { return &storage->current; }
   void set(int32_t val) const;
 
   void toggle() const;
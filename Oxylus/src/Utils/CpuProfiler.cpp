@@ -0,0 +1,183 @@
+#include "CpuProfiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "Core/Base.hpp"
+#include "Core/FileSystem.hpp"
+
+#include "Log.hpp"
+
+namespace ox {
+namespace {
+struct ThreadRing {
+  std::array<CpuProfiler::Event, CpuProfiler::RING_CAPACITY> events = {};
+  std::atomic<uint64_t> head = 0; // Written by the owning thread
+  uint64_t tail = 0;              // Read by the main thread
+  uint32_t index = 0;
+  std::string name = {};
+};
+
+// Owned here so rings of exited threads can still be drained.
+std::mutex rings_mutex;
+std::vector<Unique<ThreadRing>> rings = {};
+thread_local ThreadRing* thread_ring = nullptr;
+
+ThreadRing* get_thread_ring() {
+  if (!thread_ring) {
+    std::lock_guard lock(rings_mutex);
+    thread_ring = rings.emplace_back(create_unique<ThreadRing>()).get();
+    thread_ring->index = (uint32_t)rings.size() - 1;
+  }
+  return thread_ring;
+}
+
+std::string escape_json(const std::string_view text) {
+  std::string escaped = {};
+  escaped.reserve(text.size());
+  for (const char c : text) {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+}
+
+std::atomic<bool> CpuProfiler::recording = false;
+std::atomic<uint32_t> CpuProfiler::pending_frames = 0;
+CpuProfiler::Capture CpuProfiler::current_capture = {};
+CpuProfiler::Capture CpuProfiler::last_capture = {};
+uint32_t CpuProfiler::frames_left = 0;
+bool CpuProfiler::export_when_done = false;
+
+void CpuProfiler::record(const char* name, const uint64_t start_ns, const uint32_t depth) {
+  auto* ring = get_thread_ring();
+  const uint64_t head = ring->head.load(std::memory_order_relaxed);
+  // Orders the slot write after the previous head store, so drain() sees the head move before a slot it copied changes.
+  std::atomic_thread_fence(std::memory_order_release);
+  ring->events[head % RING_CAPACITY] = {.name = name, .start_ns = start_ns, .end_ns = now(), .depth = depth, .thread = ring->index};
+  ring->head.store(head + 1, std::memory_order_release);
+}
+
+void CpuProfiler::drain() {
+  std::lock_guard lock(rings_mutex);
+  for (const auto& ring : rings) {
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    if (head - ring->tail > RING_CAPACITY) {
+      current_capture.dropped_events += head - ring->tail - RING_CAPACITY;
+      ring->tail = head - RING_CAPACITY;
+    }
+
+    auto& events = current_capture.events;
+    const size_t first = events.size();
+    for (uint64_t i = ring->tail; i < head; i++)
+      events.emplace_back(ring->events[i % RING_CAPACITY]);
+
+    // The producer keeps going while we copy. Event i's slot is rewritten once the producer reaches i + RING_CAPACITY,
+    // so any copied event that far behind the current head may be torn and is dropped.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t head_after = ring->head.load(std::memory_order_relaxed);
+    if (head_after - ring->tail >= RING_CAPACITY) {
+      const uint64_t torn = std::min(head_after - RING_CAPACITY + 1 - ring->tail, head - ring->tail);
+      events.erase(events.begin() + (ptrdiff_t)first, events.begin() + (ptrdiff_t)(first + torn));
+      current_capture.dropped_events += torn;
+    }
+    ring->tail = head;
+  }
+}
+
+void CpuProfiler::begin_frame() {
+  const uint64_t frame_start = now();
+
+  // Lets CI and console users capture without the editor.
+  if (const int32_t frames = ProfilerCVar::cvar_capture_frames.get(); frames > 0 && !recording.load(std::memory_order_relaxed)) {
+    ProfilerCVar::cvar_capture_frames.set(0);
+    capture((uint32_t)frames);
+    export_when_done = true;
+  }
+
+  if (recording.load(std::memory_order_relaxed)) {
+    drain();
+    current_capture.frames.back().end_ns = frame_start;
+
+    if (--frames_left == 0) {
+      recording.store(false, std::memory_order_relaxed);
+      {
+        std::lock_guard lock(rings_mutex);
+        for (const auto& ring : rings)
+          current_capture.thread_names.emplace_back(ring->name.empty() ? fmt::format("Thread {}", ring->index) : ring->name);
+      }
+      last_capture = std::move(current_capture);
+      current_capture = {};
+      OX_LOG_INFO("Captured {} CPU profiler frames, {} zones", last_capture.frames.size(), last_capture.events.size());
+      if (std::exchange(export_when_done, false))
+        export_chrome_trace(ProfilerCVar::cvar_trace_path.get());
+      return;
+    }
+  }
+  else if (const uint32_t frames = pending_frames.exchange(0, std::memory_order_relaxed); frames > 0) {
+    // Throw away whatever was recorded by scopes still open when the last capture ended.
+    {
+      std::lock_guard lock(rings_mutex);
+      for (const auto& ring : rings)
+        ring->tail = ring->head.load(std::memory_order_acquire);
+    }
+    frames_left = std::min(frames, MAX_CAPTURE_FRAMES);
+    recording.store(true, std::memory_order_relaxed);
+  }
+  else {
+    return;
+  }
+
+  current_capture.frames.emplace_back(Frame{.start_ns = frame_start});
+}
+
+void CpuProfiler::capture(const uint32_t frame_count) {
+  if (frame_count > 0 && !recording.load(std::memory_order_relaxed))
+    pending_frames.store(frame_count, std::memory_order_relaxed);
+}
+
+void CpuProfiler::set_thread_name(const std::string& name) {
+  auto* ring = get_thread_ring();
+  std::lock_guard lock(rings_mutex);
+  ring->name = name;
+}
+
+bool CpuProfiler::export_chrome_trace(const std::string& path) {
+  const auto& capture = last_capture;
+  if (capture.frames.empty()) {
+    OX_LOG_WARN("No CPU profiler capture to export");
+    return false;
+  }
+
+  const uint64_t origin = capture.frames.front().start_ns;
+  const auto to_us = [origin](const uint64_t ns) { return (double)(ns - std::min(ns, origin)) / 1000.0; };
+
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  for (uint32_t i = 0; i < (uint32_t)capture.thread_names.size(); i++)
+    json += fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}},)" "\n", i, escape_json(capture.thread_names[i]));
+  for (uint32_t i = 0; i < (uint32_t)capture.frames.size(); i++) {
+    const auto& frame = capture.frames[i];
+    json += fmt::format(R"({{"name":"Frame {}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}},)" "\n",
+                        i, capture.thread_names.size(), to_us(frame.start_ns), to_us(frame.end_ns) - to_us(frame.start_ns));
+  }
+  for (const auto& event : capture.events) {
+    json += fmt::format(R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}},)" "\n",
+                        escape_json(event.name), event.thread, to_us(event.start_ns), to_us(event.end_ns) - to_us(event.start_ns));
+  }
+  json += fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"Frames"}}}})" "\n]}}\n", capture.thread_names.size());
+
+  if (!FileSystem::write_file(path, json)) {
+    OX_LOG_ERROR("Couldn't export the CPU profile to {}", path);
+    return false;
+  }
+
+  OX_LOG_INFO("Exported the CPU profile to {}", path);
+  return true;
+}
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CVars.hpp"
+
+namespace ox {
+namespace ProfilerCVar {
+inline AutoCVar_Int cvar_capture_frames("profiler.capture_frames", "capture the next n frames and export them to profiler.trace_path", 0);
+inline AutoCVar_String cvar_trace_path("profiler.trace_path", "where captures started from profiler.capture_frames are exported", "cpu_profile.json");
+}
+
+/// Native CPU profiler behind OX_SCOPED_ZONE, works without a Tracy connection and in distribution builds.
+/// Zones are only timed while a capture runs, otherwise a scope costs one relaxed load.
+/// Every thread writes finished zones into its own single-producer ring, the main thread drains them at frame boundaries.
+class CpuProfiler {
+public:
+  static constexpr uint32_t RING_CAPACITY = 1 << 14; // Zones per thread and frame before the oldest are dropped
+  static constexpr uint32_t MAX_CAPTURE_FRAMES = 600;
+
+  struct Event {
+    const char* name = nullptr; // String literal or function name, never freed
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;
+    uint32_t depth = 0;
+    uint32_t thread = 0;
+  };
+
+  struct Frame {
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;
+  };
+
+  struct Capture {
+    std::vector<Event> events = {};
+    std::vector<Frame> frames = {};
+    std::vector<std::string> thread_names = {};
+    uint64_t dropped_events = 0;
+  };
+
+  class Scope {
+  public:
+    explicit Scope(const char* name) : name(name) {
+      if (recording.load(std::memory_order_relaxed)) {
+        start_ns = now();
+        depth++;
+      }
+    }
+
+    ~Scope() {
+      if (start_ns != 0) {
+        depth--;
+        record(name, start_ns, depth);
+      }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    const char* name = nullptr;
+    uint64_t start_ns = 0;
+  };
+
+  /// Called by App at the start of every frame on the main thread.
+  static void begin_frame();
+
+  /// Records the next `frame_count` frames, the result replaces get_last_capture() once done.
+  static void capture(uint32_t frame_count);
+  static bool is_capturing() { return recording.load(std::memory_order_relaxed) || pending_frames.load(std::memory_order_relaxed) > 0; }
+  static const Capture& get_last_capture() { return last_capture; }
+
+  /// Chrome trace_event JSON of the last capture, opens in chrome://tracing, Perfetto or Speedscope.
+  static bool export_chrome_trace(const std::string& path);
+
+  /// Shown in exported traces, threads without a name are numbered.
+  static void set_thread_name(const std::string& name);
+
+  static uint64_t now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+private:
+  static std::atomic<bool> recording;
+  static std::atomic<uint32_t> pending_frames;
+  static inline thread_local uint32_t depth = 0;
+
+  static Capture current_capture;
+  static Capture last_capture;
+  static uint32_t frames_left;
+  static bool export_when_done;
+
+  static void record(const char* name, uint64_t start_ns, uint32_t depth);
+  static void drain();
+};
+}
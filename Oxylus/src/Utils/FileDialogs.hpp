@@ -9,6 +9,9 @@
 namespace ox {
 class FileDialogs : public ESystem {
 public:
+  /// NFD's state (COM on Windows) belongs to the thread that initialized it.
+  static constexpr bool INIT_ON_MAIN_THREAD = true;
+
   void init() override;
   void deinit() override;
 
@@ -0,0 +1,223 @@
+#include "FrameStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include "CpuProfiler.hpp"
+#include "Log.hpp"
+
+#include "Core/FileSystem.hpp"
+
+namespace ox {
+FrameStats::Histogram FrameStats::frame_histogram = {};
+std::array<FrameStats::Histogram, FrameStats::PHASE_COUNT> FrameStats::phase_histograms = {};
+FrameStats::FrameRecord FrameStats::current_frame = {};
+FrameStats::FrameRecord FrameStats::last_frame = {};
+std::array<FrameStats::FrameRecord, FrameStats::WINDOW_SIZE> FrameStats::frames = {};
+std::deque<FrameStats::Hitch> FrameStats::hitches = {};
+uint64_t FrameStats::hitch_count = 0;
+uint64_t FrameStats::frame_start_ns = 0;
+uint64_t FrameStats::child_ns = 0;
+float FrameStats::last_threshold_ms = 0.0f;
+
+// Startup frames load everything and would all be hitches against an empty window.
+static constexpr uint32_t MIN_FRAMES_FOR_AUTO_THRESHOLD = 60;
+
+uint32_t FrameStats::Histogram::get_bucket(const float ms) {
+  if (ms <= 0.0f)
+    return 0;
+  const float position = (std::log2(ms) - (float)MIN_EXPONENT) * (float)BUCKETS_PER_OCTAVE;
+  return (uint32_t)std::clamp(position, 0.0f, (float)(BUCKET_COUNT - 1));
+}
+
+float FrameStats::Histogram::get_bucket_start(const uint32_t bucket) {
+  return std::exp2((float)MIN_EXPONENT + (float)bucket / (float)BUCKETS_PER_OCTAVE);
+}
+
+void FrameStats::Histogram::add(const float ms) {
+  if (count == WINDOW_SIZE) {
+    const float oldest = samples[next];
+    buckets[get_bucket(oldest)]--;
+    sum -= oldest;
+  } else {
+    count++;
+  }
+
+  samples[next] = ms;
+  next = (next + 1) % WINDOW_SIZE;
+  buckets[get_bucket(ms)]++;
+  sum += ms;
+}
+
+void FrameStats::Histogram::reset() { *this = {}; }
+
+float FrameStats::Histogram::get_percentile(const float percentile) const {
+  if (count == 0)
+    return 0.0f;
+
+  // Nearest rank, then geometric interpolation inside the bucket.
+  const auto rank = (uint32_t)std::clamp(std::ceil(percentile / 100.0f * (float)count), 1.0f, (float)count);
+  uint32_t below = 0;
+  for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+    if (below + buckets[i] < rank) {
+      below += buckets[i];
+      continue;
+    }
+
+    const float fraction = (float)(rank - below) / (float)buckets[i];
+    const float value = get_bucket_start(i) * std::exp2(fraction / (float)BUCKETS_PER_OCTAVE);
+    return std::min(value, get_max());
+  }
+
+  return get_max();
+}
+
+float FrameStats::Histogram::get_max() const {
+  float max = 0.0f;
+  for (uint32_t i = 0; i < count; i++)
+    max = std::max(max, get_sample(i));
+  return max;
+}
+
+float FrameStats::Histogram::get_mean() const { return count > 0 ? (float)(sum / count) : 0.0f; }
+
+FrameStats::PhaseScope::PhaseScope(const FramePhase phase) : phase(phase) {
+  if (!is_frame_thread)
+    return;
+  start_ns = CpuProfiler::now();
+  parent_child_ns = child_ns;
+  child_ns = 0;
+}
+
+FrameStats::PhaseScope::~PhaseScope() {
+  if (start_ns == 0)
+    return;
+  const uint64_t elapsed = CpuProfiler::now() - start_ns;
+  const uint64_t exclusive = elapsed - std::min(elapsed, child_ns);
+  current_frame.phase_ms[(uint32_t)phase] += (float)((double)exclusive / 1e6);
+  child_ns = parent_child_ns + elapsed;
+}
+
+void FrameStats::begin_frame() {
+  const uint64_t now = CpuProfiler::now();
+  is_frame_thread = true;
+  if (frame_start_ns == 0) {
+    frame_start_ns = now;
+    return;
+  }
+
+  auto& frame = current_frame;
+  frame.total_ms = (float)((double)(now - frame_start_ns) / 1e6);
+  float covered_ms = 0.0f;
+  for (uint32_t i = 0; i < PHASE_COUNT; i++)
+    covered_ms += frame.phase_ms[i];
+  frame.phase_ms[(uint32_t)FramePhase::Other] += std::max(frame.total_ms - covered_ms, 0.0f);
+
+  const float hitch_ms = FrameStatsCVar::cvar_hitch_ms.get();
+  if (hitch_ms > 0.0f)
+    last_threshold_ms = hitch_ms;
+  else if (frame_histogram.get_count() >= MIN_FRAMES_FOR_AUTO_THRESHOLD)
+    last_threshold_ms = 2.0f * frame_histogram.get_percentile(50.0f);
+  else
+    last_threshold_ms = 0.0f;
+
+  if (last_threshold_ms > 0.0f && frame.total_ms > last_threshold_ms) {
+    if (hitches.size() == MAX_HITCHES)
+      hitches.pop_front();
+    hitches.emplace_back(Hitch{frame, last_threshold_ms});
+    hitch_count++;
+
+    const auto slowest = (uint32_t)(std::max_element(frame.phase_ms.begin(), frame.phase_ms.end()) - frame.phase_ms.begin());
+    OX_LOG_WARN("Frame {} took {:.2f} ms (hitch threshold {:.2f} ms), {} took {:.2f} ms of it",
+                frame.index,
+                frame.total_ms,
+                last_threshold_ms,
+                get_phase_name((FramePhase)slowest),
+                frame.phase_ms[slowest]);
+  }
+
+  frame_histogram.add(frame.total_ms);
+  for (uint32_t i = 0; i < PHASE_COUNT; i++)
+    phase_histograms[i].add(frame.phase_ms[i]);
+  frames[frame.index % WINDOW_SIZE] = frame;
+  last_frame = frame;
+
+  current_frame = FrameRecord{.index = frame.index + 1};
+  frame_start_ns = now;
+  child_ns = 0;
+}
+
+void FrameStats::reset() {
+  frame_histogram.reset();
+  for (auto& histogram : phase_histograms)
+    histogram.reset();
+  hitches.clear();
+  hitch_count = 0;
+  last_threshold_ms = 0.0f;
+}
+
+FrameStats::Summary FrameStats::summarize(const Histogram& histogram) {
+  return {
+    .p50 = histogram.get_percentile(50.0f),
+    .p95 = histogram.get_percentile(95.0f),
+    .p99 = histogram.get_percentile(99.0f),
+    .max = histogram.get_max(),
+    .mean = histogram.get_mean(),
+  };
+}
+
+const char* FrameStats::get_phase_name(const FramePhase phase) {
+  switch (phase) {
+    case FramePhase::Layers     : return "Layers";
+    case FramePhase::Systems    : return "Systems";
+    case FramePhase::SceneUpdate: return "SceneUpdate";
+    case FramePhase::UI         : return "UI";
+    case FramePhase::RenderGraph: return "RenderGraph";
+    case FramePhase::Submit     : return "Submit";
+    case FramePhase::Other      : return "Other";
+    default                     : return "Unknown";
+  }
+}
+
+bool FrameStats::export_csv(const std::string& path) {
+  std::string header = "kind,frame,total_ms";
+  for (uint32_t i = 0; i < PHASE_COUNT; i++)
+    header += fmt::format(",{}_ms", get_phase_name((FramePhase)i));
+
+  std::string csv = {};
+  const auto add_summary = [&csv](const char* kind, float (*get)(const Summary&)) {
+    csv += fmt::format("{},,{:.4f}", kind, get(get_frame_summary()));
+    for (uint32_t i = 0; i < PHASE_COUNT; i++)
+      csv += fmt::format(",{:.4f}", get(get_summary((FramePhase)i)));
+    csv += "\n";
+  };
+  add_summary("p50", [](const Summary& summary) { return summary.p50; });
+  add_summary("p95", [](const Summary& summary) { return summary.p95; });
+  add_summary("p99", [](const Summary& summary) { return summary.p99; });
+  add_summary("max", [](const Summary& summary) { return summary.max; });
+  add_summary("mean", [](const Summary& summary) { return summary.mean; });
+
+  const auto add_frame = [&csv](const char* kind, const FrameRecord& frame) {
+    csv += fmt::format("{},{},{:.4f}", kind, frame.index, frame.total_ms);
+    for (const float ms : frame.phase_ms)
+      csv += fmt::format(",{:.4f}", ms);
+    csv += "\n";
+  };
+  for (const auto& hitch : hitches)
+    add_frame("hitch", hitch.frame);
+
+  const uint32_t frame_count = frame_histogram.get_count();
+  for (uint32_t i = 0; i < frame_count; i++)
+    add_frame("frame", frames[(last_frame.index + 1 + WINDOW_SIZE - frame_count + i) % WINDOW_SIZE]);
+
+  if (!FileSystem::write_file(path, csv, header)) {
+    OX_LOG_ERROR("Couldn't export the frame stats to {}", path);
+    return false;
+  }
+
+  OX_LOG_INFO("Exported the frame stats to {}", path);
+  return true;
+}
+}
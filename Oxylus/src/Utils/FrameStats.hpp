@@ -0,0 +1,136 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "CVars.hpp"
+
+namespace ox {
+namespace FrameStatsCVar {
+inline AutoCVar_Float cvar_hitch_ms("frame_stats.hitch_ms", "frames slower than this are recorded as hitches, 0 uses twice the rolling median", 0.0f);
+inline AutoCVar_String cvar_export_path("frame_stats.export_path", "where FrameStats::export_csv writes by default", "frame_stats.csv");
+}
+
+/// Parts of the main thread's frame. Nested phases are subtracted from the one they run in, so the times add up to the frame.
+enum class FramePhase : uint32_t {
+  Layers = 0,  // Layer::on_update, minus the scene update
+  Systems,     // ESystem::update
+  SceneUpdate, // Scene::on_runtime_update and on_editor_update
+  UI,          // on_imgui_render of layers and systems
+  RenderGraph, // Building the frame's render graph, or the headless pipeline's CPU work
+  Submit,      // Compiling, submitting and presenting the render graph
+  Other,       // Whatever isn't covered by a phase: input, window events, waiting
+  Count
+};
+
+/// Per-frame CPU time of every FramePhase, rolling histograms over the last WINDOW_SIZE frames and the frames that hitched.
+/// Everything runs on the main thread: App calls begin_frame() and the engine opens a PhaseScope around each phase.
+class FrameStats {
+public:
+  static constexpr uint32_t WINDOW_SIZE = 600;
+  static constexpr uint32_t MAX_HITCHES = 64;
+  static constexpr uint32_t PHASE_COUNT = (uint32_t)FramePhase::Count;
+
+  /// Log scale histogram of the last WINDOW_SIZE samples, 8 buckets per doubling from 1/64 ms to 1 s.
+  /// Percentiles are interpolated inside the bucket they fall in, so they're within a few percent.
+  class Histogram {
+  public:
+    static constexpr uint32_t BUCKETS_PER_OCTAVE = 8;
+    static constexpr int32_t MIN_EXPONENT = -6;
+    static constexpr uint32_t BUCKET_COUNT = 16 * BUCKETS_PER_OCTAVE;
+
+    void add(float ms);
+    void reset();
+
+    float get_percentile(float percentile) const;
+    float get_max() const;
+    float get_mean() const;
+    uint32_t get_count() const { return count; }
+
+    const std::array<uint32_t, BUCKET_COUNT>& get_buckets() const { return buckets; }
+    /// Lower edge of the bucket in milliseconds.
+    static float get_bucket_start(uint32_t bucket);
+    /// The samples oldest first, for frame time graphs.
+    float get_sample(uint32_t index) const { return samples[(next + WINDOW_SIZE - count + index) % WINDOW_SIZE]; }
+
+  private:
+    std::array<uint32_t, BUCKET_COUNT> buckets = {};
+    std::array<float, WINDOW_SIZE> samples = {};
+    uint32_t next = 0;
+    uint32_t count = 0;
+    double sum = 0.0;
+
+    static uint32_t get_bucket(float ms);
+  };
+
+  struct Summary {
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    float mean = 0.0f;
+  };
+
+  struct FrameRecord {
+    uint64_t index = 0;
+    float total_ms = 0.0f;
+    std::array<float, PHASE_COUNT> phase_ms = {};
+  };
+
+  struct Hitch {
+    FrameRecord frame = {};
+    float threshold_ms = 0.0f;
+  };
+
+  class PhaseScope {
+  public:
+    explicit PhaseScope(FramePhase phase);
+    ~PhaseScope();
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+  private:
+    FramePhase phase;
+    uint64_t start_ns = 0; // 0 when opened off the main thread, those aren't counted
+    uint64_t parent_child_ns = 0;
+  };
+
+  /// Closes the previous frame and starts timing the next one.
+  static void begin_frame();
+  static void reset();
+
+  static const Histogram& get_frame_histogram() { return frame_histogram; }
+  static const Histogram& get_histogram(const FramePhase phase) { return phase_histograms[(uint32_t)phase]; }
+  static Summary get_frame_summary() { return summarize(frame_histogram); }
+  static Summary get_summary(const FramePhase phase) { return summarize(phase_histograms[(uint32_t)phase]); }
+
+  static const FrameRecord& get_last_frame() { return last_frame; }
+  /// The most recent MAX_HITCHES, oldest first.
+  static const std::deque<Hitch>& get_hitches() { return hitches; }
+  static uint64_t get_hitch_count() { return hitch_count; }
+  /// What the last frame was compared against.
+  static float get_hitch_threshold() { return last_threshold_ms; }
+
+  static const char* get_phase_name(FramePhase phase);
+
+  /// Percentiles, hitches and the frames in the window as CSV, one row each.
+  static bool export_csv(const std::string& path);
+
+private:
+  static Histogram frame_histogram;
+  static std::array<Histogram, PHASE_COUNT> phase_histograms;
+  static FrameRecord current_frame;
+  static FrameRecord last_frame;
+  static std::array<FrameRecord, WINDOW_SIZE> frames;
+  static std::deque<Hitch> hitches;
+  static uint64_t hitch_count;
+  static uint64_t frame_start_ns;
+  static uint64_t child_ns; // Time spent in phases nested in the innermost open one
+  static float last_threshold_ms;
+  static inline thread_local bool is_frame_thread = false;
+
+  static Summary summarize(const Histogram& histogram);
+};
+}
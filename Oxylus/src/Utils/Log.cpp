@@ -1,28 +1,478 @@
 #include "Log.hpp"
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
 
+#include <fmt/chrono.h>
+
+#include "CVars.hpp"
 #include "Profiler.hpp"
 
+#include "Core/Base.hpp"
+
 namespace ox {
+namespace LogCVar {
+static AutoCVar_Int cvar_rate_limit("log.rate_limit", "messages a single log call site may write per second, 0 disables the limit", 100);
+}
+
+/// Single producer single consumer byte ring. The owning thread writes records, the log thread reads them.
+/// Every record starts with its size, a size of WRAP_MARKER means the rest of the buffer is padding.
+struct LogQueue {
+  static constexpr uint32_t SIZE = 1 << 18;
+  static constexpr uint32_t PREFIX_SIZE = 8;
+  static constexpr uint32_t MAX_RECORD_SIZE = SIZE / 4;
+  static constexpr uint32_t WRAP_MARKER = UINT32_MAX;
+
+  alignas(64) std::atomic<uint64_t> head = 0; // Published by the owning thread
+  uint64_t reserved_head = 0;
+  uint64_t cached_tail = 0;
+
+  alignas(64) std::atomic<uint64_t> tail = 0; // Published by the log thread
+  std::atomic<uint64_t> dropped = 0;
+
+  uint32_t thread_index = 0;
+  std::unique_ptr<std::byte[]> buffer = std::make_unique<std::byte[]>(SIZE);
+};
+
+struct LogCallback {
+  std::string id = {};
+  loguru::log_handler_t callback = nullptr;
+  void* user_data = nullptr;
+  loguru::Verbosity verbosity = loguru::Verbosity_INFO;
+  loguru::close_handler_t on_close = nullptr;
+  loguru::flush_handler_t on_flush = nullptr;
+};
+
+struct ConsoleEntry {
+  static constexpr uint32_t MAX_TEXT_SIZE = 512;
+
+  loguru::Verbosity verbosity = loguru::Verbosity_INFO;
+  uint32_t size = 0;
+  char text[MAX_TEXT_SIZE] = {};
+};
+
+static thread_local LogQueue* thread_queue = nullptr;
+
+static std::mutex queues_mutex;
+static std::vector<Unique<LogQueue>> queues = {}; // Never shrinks, threads keep a pointer to theirs
+static std::atomic<uint32_t> queues_version = 0;
+
+static std::recursive_mutex callbacks_mutex; // Fatal messages written from inside a callback come back in
+static std::vector<LogCallback> callbacks = {};
+
+static std::mutex console_mutex;
+static std::array<ConsoleEntry, Log::CONSOLE_RING_SIZE> console_ring = {};
+static uint64_t console_head = 0;
+
+static std::FILE* everything_file = nullptr;
+static std::FILE* latest_file = nullptr;
+static loguru::Verbosity stderr_verbosity = loguru::Verbosity_INFO;
+static std::thread::id main_thread_id = {};
+
+static std::thread log_thread = {};
+static std::mutex wake_mutex;
+static std::condition_variable wake_condition;
+static bool stop_requested = false;
+static uint64_t flush_requested = 0;
+static uint64_t flush_completed = 0;
+
+static LogQueue* register_thread() {
+  std::lock_guard lock(queues_mutex);
+  auto& queue = queues.emplace_back(create_unique<LogQueue>());
+  queue->thread_index = std::this_thread::get_id() == main_thread_id ? 0 : (uint32_t)queues.size();
+  queues_version.fetch_add(1, std::memory_order_release);
+  thread_queue = queue.get();
+  return thread_queue;
+}
+
+static void wake_log_thread() {
+  std::lock_guard lock(wake_mutex);
+  ++flush_requested;
+  wake_condition.notify_one();
+}
+
+std::byte* Log::begin_record(const uint32_t size, const loguru::Verbosity verbosity) {
+  auto* queue = thread_queue ? thread_queue : register_thread();
+
+  const uint32_t total = (LogQueue::PREFIX_SIZE + size + 7u) & ~7u;
+  if (total > LogQueue::MAX_RECORD_SIZE) {
+    queue->dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  uint64_t head = queue->head.load(std::memory_order_relaxed);
+  const uint32_t offset = (uint32_t)(head % LogQueue::SIZE);
+  const uint32_t padding = offset + total > LogQueue::SIZE ? LogQueue::SIZE - offset : 0;
+  const uint64_t end = head + padding + total;
+
+  if (end - queue->cached_tail > LogQueue::SIZE) {
+    queue->cached_tail = queue->tail.load(std::memory_order_acquire);
+    // Infos are dropped when the log thread can't keep up, warnings and errors wait for it unless they come from it.
+    while (end - queue->cached_tail > LogQueue::SIZE) {
+      if (verbosity >= loguru::Verbosity_INFO || !running.load(std::memory_order_relaxed) || std::this_thread::get_id() == log_thread.get_id()) {
+        queue->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+      wake_log_thread();
+      std::this_thread::yield();
+      queue->cached_tail = queue->tail.load(std::memory_order_acquire);
+    }
+  }
+
+  auto* buffer = queue->buffer.get();
+  if (padding != 0) {
+    std::memcpy(buffer + offset, &LogQueue::WRAP_MARKER, sizeof(uint32_t));
+    head += padding;
+  }
+
+  std::memcpy(buffer + head % LogQueue::SIZE, &total, sizeof(uint32_t));
+  queue->reserved_head = head + total;
+  return buffer + head % LogQueue::SIZE + LogQueue::PREFIX_SIZE;
+}
+
+void Log::end_record() {
+  thread_queue->head.store(thread_queue->reserved_head, std::memory_order_release);
+}
+
+static std::string_view get_file_name(const std::string_view path) {
+  const auto separator = path.find_last_of("/\\");
+  return separator == std::string_view::npos ? path : path.substr(separator + 1);
+}
+
+static const char* get_level_name(const loguru::Verbosity verbosity) {
+  switch (verbosity) {
+    case loguru::Verbosity_FATAL  : return "FATL";
+    case loguru::Verbosity_ERROR  : return " ERR";
+    case loguru::Verbosity_WARNING: return "WARN";
+    case loguru::Verbosity_INFO   : return "INFO";
+    default                       : return "   V";
+  }
+}
+
+/// The log thread's side, friend of Log for the record layout.
+struct LogBackend {
+  static void dispatch(loguru::Verbosity verbosity,
+                       const char* file,
+                       uint32_t line,
+                       uint32_t thread_index,
+                       uint64_t time,
+                       std::string_view message,
+                       fmt::memory_buffer& line_buffer,
+                       bool to_stderr);
+  static void drain_queues();
+  static void run();
+  static void on_loguru_message(void* user_data, const loguru::Message& message);
+};
+
+/// Writes one formatted message to every sink.
+void LogBackend::dispatch(const loguru::Verbosity verbosity,
+                          const char* file,
+                          const uint32_t line,
+                          const uint32_t thread_index,
+                          const uint64_t time,
+                          const std::string_view message,
+                          fmt::memory_buffer& line_buffer,
+                          const bool to_stderr) {
+  const auto seconds = (std::time_t)(time / 1'000'000'000ull);
+  const auto millis = (uint32_t)(time / 1'000'000ull % 1000);
+  const auto file_name = get_file_name(file);
+
+  line_buffer.clear();
+  fmt::format_to(fmt::appender(line_buffer), "{:%H:%M:%S}.{:03} ", fmt::localtime(seconds), millis);
+  if (thread_index == 0)
+    fmt::format_to(fmt::appender(line_buffer), "[  main] ");
+  else
+    fmt::format_to(fmt::appender(line_buffer), "[T{:>5}] ", thread_index);
+  fmt::format_to(fmt::appender(line_buffer), "{:>24}:{:<5} {}| {}\n", file_name, line, get_level_name(verbosity), message);
+  const auto line_text = std::string_view(line_buffer.data(), line_buffer.size());
+
+  if (to_stderr && verbosity <= stderr_verbosity)
+    std::fwrite(line_text.data(), 1, line_text.size(), stderr);
+  if (everything_file)
+    std::fwrite(line_text.data(), 1, line_text.size(), everything_file);
+  if (latest_file && verbosity <= loguru::Verbosity_INFO)
+    std::fwrite(line_text.data(), 1, line_text.size(), latest_file);
+
+  if (verbosity <= loguru::Verbosity_INFO) {
+    std::lock_guard lock(console_mutex);
+    auto& entry = console_ring[console_head % Log::CONSOLE_RING_SIZE];
+    entry.verbosity = verbosity;
+    entry.size = (uint32_t)std::min(message.size(), (size_t)ConsoleEntry::MAX_TEXT_SIZE);
+    std::memcpy(entry.text, message.data(), entry.size);
+    ++console_head;
+  }
+
+  std::lock_guard lock(callbacks_mutex);
+  if (callbacks.empty())
+    return;
+
+  // loguru hands callbacks a null terminated message.
+  const std::string message_text(message);
+  const std::string preamble(line_text.substr(0, line_text.find('|') + 1));
+  loguru::Message callback_message = {};
+  callback_message.verbosity = verbosity;
+  callback_message.filename = file;
+  callback_message.line = line;
+  callback_message.preamble = preamble.c_str();
+  callback_message.indentation = "";
+  callback_message.prefix = "";
+  callback_message.message = message_text.c_str();
+  for (const auto& callback : callbacks) {
+    if (verbosity <= callback.verbosity)
+      callback.callback(callback.user_data, callback_message);
+  }
+}
+
+struct PendingRecord {
+  uint64_t time;
+  uint32_t thread_index;
+  const std::byte* data;
+};
+
+/// Formats and writes everything queued so far, oldest first across threads. Only ever runs on one thread at a time.
+void LogBackend::drain_queues() {
+  OX_SCOPED_ZONE;
+
+  static uint32_t seen_version = UINT32_MAX;
+  static std::vector<LogQueue*> snapshot = {};
+  static std::vector<uint64_t> heads = {};
+  static std::vector<PendingRecord> pending = {};
+  static fmt::memory_buffer message_buffer;
+  static fmt::memory_buffer line_buffer;
+
+  if (const uint32_t version = queues_version.load(std::memory_order_acquire); version != seen_version) {
+    std::lock_guard lock(queues_mutex);
+    snapshot.clear();
+    for (const auto& queue : queues)
+      snapshot.emplace_back(queue.get());
+    seen_version = version;
+  }
+
+  pending.clear();
+  heads.resize(snapshot.size());
+  for (size_t i = 0; i < snapshot.size(); i++) {
+    const auto* queue = snapshot[i];
+    const uint64_t head = queue->head.load(std::memory_order_acquire);
+    uint64_t position = queue->tail.load(std::memory_order_relaxed);
+    while (position < head) {
+      const uint32_t offset = (uint32_t)(position % LogQueue::SIZE);
+      uint32_t size = 0;
+      std::memcpy(&size, queue->buffer.get() + offset, sizeof(uint32_t));
+      if (size == LogQueue::WRAP_MARKER) {
+        position += LogQueue::SIZE - offset;
+        continue;
+      }
+
+      const std::byte* data = queue->buffer.get() + offset + LogQueue::PREFIX_SIZE;
+      uint64_t time = 0;
+      std::memcpy(&time, data + offsetof(Log::RecordHeader, time), sizeof(uint64_t));
+      pending.emplace_back(PendingRecord{time, queue->thread_index, data});
+      position += size;
+    }
+    heads[i] = head;
+  }
+
+  std::ranges::stable_sort(pending, {}, &PendingRecord::time);
+
+  for (const auto& record : pending) {
+    Log::RecordHeader header = {};
+    std::memcpy(&header, record.data, sizeof(Log::RecordHeader));
+
+    message_buffer.clear();
+    try {
+      header.format_fn(message_buffer, {header.format, header.format_size}, record.data + sizeof(Log::RecordHeader));
+    } catch (const fmt::format_error& error) {
+      message_buffer.clear();
+      fmt::format_to(fmt::appender(message_buffer), "Couldn't format \"{}\": {}", std::string_view(header.format, header.format_size), error.what());
+    }
+    if (header.suppressed != 0)
+      fmt::format_to(fmt::appender(message_buffer), " ({} similar messages were suppressed)", header.suppressed);
+
+    const auto* site = header.site;
+    dispatch(site->verbosity,
+             site->file,
+             site->line,
+             record.thread_index,
+             record.time,
+             {message_buffer.data(), message_buffer.size()},
+             line_buffer,
+             true);
+  }
+
+  for (size_t i = 0; i < snapshot.size(); i++) {
+    snapshot[i]->tail.store(heads[i], std::memory_order_release);
+
+    if (const uint64_t dropped = snapshot[i]->dropped.exchange(0, std::memory_order_relaxed); dropped != 0) {
+      const auto message = fmt::format("Dropped {} log messages, the queue was full", dropped);
+      dispatch(loguru::Verbosity_WARNING, __FILE__, __LINE__, snapshot[i]->thread_index, Log::get_time(), message, line_buffer, true);
+    }
+  }
+
+  if (!pending.empty()) {
+    if (everything_file)
+      std::fflush(everything_file);
+    if (latest_file)
+      std::fflush(latest_file);
+  }
+}
+
+void LogBackend::run() {
+  while (true) {
+    uint64_t requested = 0;
+    bool stopping = false;
+    {
+      std::unique_lock lock(wake_mutex);
+      // Polls every few milliseconds instead of being notified, so writing a record never has to take a lock.
+      wake_condition.wait_for(lock, std::chrono::milliseconds(5), [] { return stop_requested || flush_requested != flush_completed; });
+      requested = flush_requested;
+      stopping = stop_requested;
+    }
+
+    drain_queues();
+
+    {
+      std::lock_guard lock(wake_mutex);
+      flush_completed = requested;
+    }
+    wake_condition.notify_all();
+
+    if (stopping)
+      return;
+  }
+}
+
+// Fatal messages and failed checks are written by loguru, this puts them into the log files and the callbacks as well.
+void LogBackend::on_loguru_message(void*, const loguru::Message& message) {
+  Log::flush();
+
+  fmt::memory_buffer line_buffer;
+  const auto text = fmt::format("{}{}", message.prefix, message.message);
+  const auto* queue = thread_queue ? thread_queue : register_thread();
+  dispatch(message.verbosity, message.filename, message.line, queue->thread_index, Log::get_time(), text, line_buffer, false);
+
+  if (everything_file)
+    std::fflush(everything_file);
+  if (latest_file)
+    std::fflush(latest_file);
+}
+
 void Log::init(int argc, char** argv) {
   OX_SCOPED_ZONE;
   if (!std::filesystem::exists("logs"))
     std::filesystem::create_directory("logs");
 
+  main_thread_id = std::this_thread::get_id();
+
   loguru::g_stderr_verbosity = loguru::Verbosity_INFO;
   loguru::g_preamble_date = false;
 
   loguru::init(argc, argv, {});
 
+  // loguru only writes fatal messages now, the rest goes through the queues. -v still picks the stderr verbosity.
+  stderr_verbosity = (loguru::Verbosity)loguru::g_stderr_verbosity;
+  loguru::g_stderr_verbosity = loguru::Verbosity_FATAL;
+  loguru::add_callback("ox_log", LogBackend::on_loguru_message, nullptr, loguru::Verbosity_FATAL);
+
   // Put every log message in "everything.log":
-  loguru::add_file("logs/everything.log", loguru::Append, loguru::Verbosity_MAX);
+  everything_file = std::fopen("logs/everything.log", "a");
+
+  // Only log INFO, WARNING, ERROR and FATAL to "latest.log":
+  latest_file = std::fopen("logs/latest.log", "w");
+
+  rate_limit.store((uint32_t)std::max(LogCVar::cvar_rate_limit.get(), 0), std::memory_order_relaxed);
+  LogCVar::cvar_rate_limit.subscribe([](const int32_t limit) { rate_limit.store((uint32_t)std::max(limit, 0), std::memory_order_relaxed); });
 
-  // Only log INFO, WARNING, ERROR and FATAL to "latest_readable.log":
-  loguru::add_file("logs/latest.log", loguru::Truncate, loguru::Verbosity_INFO);
+  stop_requested = false;
+  log_thread = std::thread(LogBackend::run);
+  running.store(true, std::memory_order_release);
+
+  std::atexit(shutdown);
 }
+
 void Log::shutdown() {
+  if (!running.exchange(false, std::memory_order_acq_rel))
+    return;
+
+  {
+    std::lock_guard lock(wake_mutex);
+    stop_requested = true;
+  }
+  wake_condition.notify_all();
+  log_thread.join();
+
+  // Records that were being written while the thread stopped.
+  LogBackend::drain_queues();
+
+  {
+    std::lock_guard lock(callbacks_mutex);
+    for (const auto& callback : callbacks) {
+      if (callback.on_close)
+        callback.on_close(callback.user_data);
+    }
+    callbacks.clear();
+  }
+
+  loguru::remove_callback("ox_log");
   loguru::shutdown();
+
+  if (everything_file)
+    std::fclose(everything_file);
+  if (latest_file)
+    std::fclose(latest_file);
+  everything_file = nullptr;
+  latest_file = nullptr;
+}
+
+void Log::flush() {
+  if (!running.load(std::memory_order_acquire) || std::this_thread::get_id() == log_thread.get_id())
+    return;
+
+  {
+    std::unique_lock lock(wake_mutex);
+    const uint64_t target = ++flush_requested;
+    wake_condition.notify_all();
+    wake_condition.wait(lock, [target] { return flush_completed >= target || stop_requested; });
+  }
+
+  std::lock_guard lock(callbacks_mutex);
+  for (const auto& callback : callbacks) {
+    if (callback.on_flush)
+      callback.on_flush(callback.user_data);
+  }
+}
+
+void Log::write_formatted(LogSite& site, const uint64_t time, const std::string_view text) {
+  if (running.load(std::memory_order_acquire)) {
+    std::byte* record = begin_record((uint32_t)(sizeof(RecordHeader) + get_encoded_size(text)), site.verbosity);
+    if (!record)
+      return;
+
+    const RecordHeader header = {
+      .format_fn = &format_record<std::string_view>,
+      .format = "{}",
+      .format_size = 2,
+      .suppressed = take_suppressed(site),
+      .site = &site,
+      .time = time,
+    };
+    std::memcpy(record, &header, sizeof(RecordHeader));
+    record += sizeof(RecordHeader);
+    encode(record, text);
+    end_record();
+    return;
+  }
+
+  // Before init and after shutdown.
+  if (site.verbosity <= stderr_verbosity)
+    fmt::print(stderr, "{}:{} {}| {}\n", get_file_name(site.file), site.line, get_level_name(site.verbosity), text);
 }
 
 void Log::add_callback(const char* id,
@@ -31,10 +481,29 @@ void Log::add_callback(const char* id,
                        loguru::Verbosity verbosity,
                        loguru::close_handler_t on_close,
                        loguru::flush_handler_t on_flush) {
-  loguru::add_callback(id, callback, user_data, verbosity, on_close, on_flush);
+  std::lock_guard lock(callbacks_mutex);
+  callbacks.emplace_back(LogCallback{id, callback, user_data, verbosity, on_close, on_flush});
 }
 
 void Log::remove_callback(const char* id) {
-  loguru::remove_callback(id);
+  std::lock_guard lock(callbacks_mutex);
+  const auto it = std::ranges::find(callbacks, std::string_view(id), &LogCallback::id);
+  if (it == callbacks.end())
+    return;
+
+  if (it->on_close)
+    it->on_close(it->user_data);
+  callbacks.erase(it);
+}
+
+void Log::get_console_messages(uint64_t& sequence, std::vector<ConsoleMessage>& messages) {
+  std::lock_guard lock(console_mutex);
+  if (console_head - sequence > CONSOLE_RING_SIZE)
+    sequence = console_head - CONSOLE_RING_SIZE;
+
+  for (; sequence < console_head; ++sequence) {
+    const auto& entry = console_ring[sequence % CONSOLE_RING_SIZE];
+    messages.emplace_back(ConsoleMessage{entry.verbosity, std::string(entry.text, entry.size)});
+  }
 }
 } // namespace ox
@@ -1,15 +1,68 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
 #include <loguru.hpp>
 
 #include "Core/PlatformDetection.hpp"
 
 namespace ox {
+/// State of a single OX_LOG_* call site, every macro expansion owns a static one.
+struct LogSite {
+  const char* file;
+  uint32_t line;
+  loguru::Verbosity verbosity;
+  bool rate_limited = true;
+
+  std::atomic<uint64_t> window_start = 0;
+  std::atomic<uint32_t> window_count = 0;
+  std::atomic<uint32_t> suppressed = 0;
+
+  /// Errors are never dropped, only warnings and infos count against the limit.
+  bool is_rate_limited() const { return rate_limited && verbosity > loguru::Verbosity_ERROR; }
+
+  /// False once the site wrote `limit` messages in the current one second window.
+  bool acquire(const uint64_t now, const uint32_t limit) {
+    uint64_t start = window_start.load(std::memory_order_relaxed);
+    if (now - start >= 1'000'000'000ull && window_start.compare_exchange_strong(start, now, std::memory_order_relaxed))
+      window_count.store(0, std::memory_order_relaxed);
+
+    if (window_count.fetch_add(1, std::memory_order_relaxed) < limit)
+      return true;
+
+    suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+};
+
+/// OX_LOG_* doesn't format on the calling thread. It copies the format string pointer and the arguments into a lock-free queue owned
+/// by the thread, and the log thread formats and writes them to stderr, the log files, the console ring and the callbacks.
+/// Format strings have to outlive the program (literals), pass runtime text as an argument: OX_LOG_INFO("{}", text).
+/// Arithmetic and string arguments are copied as they are, anything else is formatted on the calling thread first.
+/// Fatal messages and failed checks still go through loguru, after flushing the queues.
 class Log {
 public:
+  struct ConsoleMessage {
+    loguru::Verbosity verbosity = loguru::Verbosity_INFO;
+    std::string text = {};
+  };
+
   static void init(int argc, char** argv);
+  /// Writes what's left in the queues and stops the log thread. Logging after it is synchronous and only goes to stderr.
   static void shutdown();
+  /// Blocks until everything logged before the call is written.
+  static void flush();
 
+  /// The callback runs on the log thread.
   static void add_callback(const char* id,
                            loguru::log_handler_t callback,
                            void* user_data,
@@ -18,14 +71,177 @@ public:
                            loguru::flush_handler_t on_flush = nullptr);
 
   static void remove_callback(const char* id);
+
+  /// Appends the INFO and up messages written after `sequence` to `messages` and advances it.
+  /// The ring only keeps the last CONSOLE_RING_SIZE messages, readers that fall behind skip the older ones.
+  static void get_console_messages(uint64_t& sequence, std::vector<ConsoleMessage>& messages);
+
+  template <typename... Args>
+  static void write(LogSite& site, fmt::format_string<Args...> format, Args&&... args) {
+    const uint64_t now = get_time();
+    const uint32_t limit = rate_limit.load(std::memory_order_relaxed);
+    if (limit != 0 && site.is_rate_limited() && !site.acquire(now, limit))
+      return;
+
+    if constexpr ((is_encodable<Args> && ...)) {
+      if (running.load(std::memory_order_acquire)) {
+        const uint32_t size = (uint32_t)sizeof(RecordHeader) + (0 + ... + get_encoded_size(args));
+        std::byte* record = begin_record(size, site.verbosity);
+        if (!record)
+          return;
+
+        const fmt::string_view format_view = format;
+        const RecordHeader header = {
+          .format_fn = &format_record<std::remove_cvref_t<Args>...>,
+          .format = format_view.data(),
+          .format_size = (uint32_t)format_view.size(),
+          .suppressed = take_suppressed(site),
+          .site = &site,
+          .time = now,
+        };
+        std::memcpy(record, &header, sizeof(RecordHeader));
+        record += sizeof(RecordHeader);
+        (encode(record, args), ...);
+        end_record();
+        return;
+      }
+    }
+
+    fmt::memory_buffer buffer;
+    fmt::format_to(fmt::appender(buffer), format, std::forward<Args>(args)...);
+    write_formatted(site, now, {buffer.data(), buffer.size()});
+  }
+
+  /// fmt::runtime() format strings can't be kept by pointer, they are formatted on the calling thread.
+  template <typename... Args>
+  static void write(LogSite& site, const fmt::runtime_format_string<> format, Args&&... args) {
+    const uint64_t now = get_time();
+    const uint32_t limit = rate_limit.load(std::memory_order_relaxed);
+    if (limit != 0 && site.is_rate_limited() && !site.acquire(now, limit))
+      return;
+
+    fmt::memory_buffer buffer;
+    fmt::vformat_to(fmt::appender(buffer), format.str, fmt::make_format_args(args...));
+    write_formatted(site, now, {buffer.data(), buffer.size()});
+  }
+
+  static constexpr uint32_t CONSOLE_RING_SIZE = 256;
+
+private:
+  friend struct LogBackend;
+
+  using FormatFn = void (*)(fmt::memory_buffer& out, std::string_view format, const std::byte* args);
+
+  /// Start of every queued record, followed by the encoded arguments.
+  struct RecordHeader {
+    FormatFn format_fn;
+    const char* format;
+    uint32_t format_size;
+    uint32_t suppressed; // Messages the site dropped since its last record
+    const LogSite* site;
+    uint64_t time;       // Nanoseconds since the epoch
+  };
+
+  template <typename T>
+  static constexpr bool is_string = std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*> ||
+                                    std::is_same_v<std::decay_t<T>, std::string> || std::is_same_v<std::decay_t<T>, std::string_view>;
+
+  template <typename T>
+  static constexpr bool is_encodable = std::is_arithmetic_v<std::remove_cvref_t<T>> || is_string<T>;
+
+  template <typename T>
+  using Decoded = std::conditional_t<is_string<T>, std::string_view, std::remove_cvref_t<T>>;
+
+  template <typename T> static std::string_view as_string_view(const T& arg) {
+    if constexpr (std::is_pointer_v<T>)
+      return arg ? std::string_view(arg) : std::string_view("(null)");
+    else
+      return std::string_view(arg);
+  }
+
+  template <typename T> static uint32_t get_encoded_size(const T& arg) {
+    if constexpr (is_string<T>)
+      return (uint32_t)(sizeof(uint32_t) + as_string_view(arg).size());
+    else
+      return (uint32_t)sizeof(T);
+  }
+
+  template <typename T> static void encode(std::byte*& out, const T& arg) {
+    if constexpr (is_string<T>) {
+      const auto str = as_string_view(arg);
+      const auto size = (uint32_t)str.size();
+      std::memcpy(out, &size, sizeof(uint32_t));
+      std::memcpy(out + sizeof(uint32_t), str.data(), size);
+      out += sizeof(uint32_t) + size;
+    } else {
+      std::memcpy(out, &arg, sizeof(T));
+      out += sizeof(T);
+    }
+  }
+
+  template <typename T> static Decoded<T> decode(const std::byte*& in) {
+    if constexpr (is_string<T>) {
+      uint32_t size = 0;
+      std::memcpy(&size, in, sizeof(uint32_t));
+      const auto str = std::string_view((const char*)in + sizeof(uint32_t), size);
+      in += sizeof(uint32_t) + size;
+      return str;
+    } else {
+      T value;
+      std::memcpy(&value, in, sizeof(T));
+      in += sizeof(T);
+      return value;
+    }
+  }
+
+  template <typename... Args> static void format_record(fmt::memory_buffer& out, const std::string_view format, [[maybe_unused]] const std::byte* args) {
+    // Braced initialization decodes the arguments in order.
+    std::tuple<Decoded<Args>...> values{decode<Args>(args)...};
+    std::apply([&](auto&... value) { fmt::vformat_to(fmt::appender(out), format, fmt::make_format_args(value...)); }, values);
+  }
+
+  static uint64_t get_time() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  static uint32_t take_suppressed(LogSite& site) {
+    return site.suppressed.load(std::memory_order_relaxed) != 0 ? site.suppressed.exchange(0, std::memory_order_relaxed) : 0;
+  }
+
+  /// Room for a record of `size` bytes in the calling thread's queue, null if it's full and the message is dropped.
+  static std::byte* begin_record(uint32_t size, loguru::Verbosity verbosity);
+  static void end_record();
+  /// Queues already formatted text, or writes it to stderr right away when the log thread isn't running.
+  static void write_formatted(LogSite& site, uint64_t time, std::string_view text);
+
+  static inline std::atomic<bool> running = false;
+  static inline std::atomic<uint32_t> rate_limit = 0;
 };
 } // namespace ox
 
+#define OX_LOG_IMPL(verbosity, ...)                                                 \
+  do {                                                                              \
+    static ::ox::LogSite ox_log_site = {__FILE__, (uint32_t)__LINE__, verbosity}; \
+    ::ox::Log::write(ox_log_site, __VA_ARGS__);                                     \
+  } while (false)
+
+// For call sites shared by unrelated callers, like the script bindings, where a per-site limit would drop one caller's messages
+// because of another's.
+#define OX_LOG_IMPL_UNLIMITED(verbosity, ...)                                              \
+  do {                                                                                     \
+    static ::ox::LogSite ox_log_site = {__FILE__, (uint32_t)__LINE__, verbosity, false}; \
+    ::ox::Log::write(ox_log_site, __VA_ARGS__);                                            \
+  } while (false)
+
 // log macros
-#define OX_LOG_INFO(...) LOG_F(INFO, __VA_ARGS__)
-#define OX_LOG_WARN(...) LOG_F(WARNING, __VA_ARGS__)
-#define OX_LOG_ERROR(...) LOG_F(ERROR, __VA_ARGS__)
-#define OX_LOG_FATAL(...) LOG_F(FATAL, __VA_ARGS__)
+#define OX_LOG_INFO(...) OX_LOG_IMPL(loguru::Verbosity_INFO, __VA_ARGS__)
+#define OX_LOG_WARN(...) OX_LOG_IMPL(loguru::Verbosity_WARNING, __VA_ARGS__)
+#define OX_LOG_ERROR(...) OX_LOG_IMPL(loguru::Verbosity_ERROR, __VA_ARGS__)
+#define OX_LOG_FATAL(...)      \
+  do {                         \
+    ::ox::Log::flush();        \
+    LOG_F(FATAL, __VA_ARGS__); \
+  } while (false)
 
 #define OX_ASSERT(test, ...) CHECK_F(test, ##__VA_ARGS__)
 #define OX_CHECK_NULL(test, ...) CHECK_NOTNULL_F(test, ##__VA_ARGS__)
@@ -2,6 +2,8 @@
 
 #include <vuk/Types.hpp>
 
+#include "CpuProfiler.hpp"
+
 // Profilers
 #define GPU_PROFILER_ENABLED 0
 #define CPU_PROFILER_ENABLED 0
@@ -29,12 +31,17 @@
 #define CPU_PROFILER_ENABLED 0
 #endif
 
+// The native CpuProfiler is always compiled in, Tracy zones are added on top when CPU_PROFILER_ENABLED is set.
+#define OX_PROFILER_CONCAT_IMPL(a, b) a##b
+#define OX_PROFILER_CONCAT(a, b) OX_PROFILER_CONCAT_IMPL(a, b)
+#define OX_CPU_ZONE(name) const ::ox::CpuProfiler::Scope OX_PROFILER_CONCAT(ox_cpu_zone_, __LINE__)(name)
+
 #if CPU_PROFILER_ENABLED
-#define OX_SCOPED_ZONE ZoneScoped
-#define OX_SCOPED_ZONE_N(name) ZoneScopedN(name)
+#define OX_SCOPED_ZONE ZoneScoped; OX_CPU_ZONE(__FUNCTION__)
+#define OX_SCOPED_ZONE_N(name) ZoneScopedN(name); OX_CPU_ZONE(name)
 #else
-#define OX_SCOPED_ZONE
-#define OX_SCOPED_ZONE_N(name) 
+#define OX_SCOPED_ZONE OX_CPU_ZONE(__FUNCTION__)
+#define OX_SCOPED_ZONE_N(name) OX_CPU_ZONE(name)
 #endif
 
 #ifdef OX_DISTRIBUTION
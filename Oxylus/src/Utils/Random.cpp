@@ -1,36 +1,74 @@
 ﻿#include "Random.hpp"
 
-namespace ox {
-std::mt19937 Random::random_engine;
-std::uniform_int_distribution<std::mt19937::result_type> Random::distribution;
+#include <random>
+
+#include "Log.hpp"
 
+namespace ox {
 void Random::init() {
-  random_engine.seed(std::random_device()());
+  const auto cvar_seed = (uint64_t)(uint32_t)RandomCVar::cvar_seed.get();
+  if (cvar_seed != 0) {
+    set_seed(cvar_seed);
+    OX_LOG_INFO("Random seed: {}", cvar_seed);
+    return;
+  }
+
+  std::random_device device;
+  set_seed((uint64_t)device() << 32u | device());
 }
 
 void Random::deinit() {}
 
-uint32_t Random::get_uint() {
-  return distribution(random_engine);
+void Random::set_seed(const uint64_t seed) {
+  global_seed.store(seed, std::memory_order_relaxed);
+  next_stream.store(0, std::memory_order_relaxed);
+  seed_version.fetch_add(1, std::memory_order_release);
 }
 
-uint32_t Random::get_uint(const uint32_t min, const uint32_t max) {
-  return min + (distribution(random_engine) % (max - min + 1));
+RandomGenerator Random::create_generator() { return create_generator(next_stream.fetch_add(1, std::memory_order_relaxed)); }
+
+RandomGenerator Random::create_generator(const uint64_t stream) { return RandomGenerator(get_seed(), stream); }
+
+RandomGenerator& Random::get_generator() {
+  thread_local RandomGenerator generator = {};
+  thread_local uint32_t generator_version = UINT32_MAX;
+
+  const uint32_t version = seed_version.load(std::memory_order_acquire);
+  if (generator_version != version) {
+    generator = create_generator();
+    generator_version = version;
+  }
+  return generator;
 }
 
-float Random::get_float() {
-  return (float)distribution(random_engine) / (float)std::numeric_limits<uint32_t>::max();
+Vec3 Random::in_unit_sphere() { return glm::normalize(get_vec3(-1.0f, 1.0f)); }
+
+void RandomGenerator::fill(const std::span<uint32_t> out) {
+  uint64_t local_state = state;
+  for (auto& value : out)
+    value = step(local_state, increment);
+  state = local_state;
 }
 
-Vec3 Random::get_vec3() {
-  return {get_float(), get_float(), get_float()};
+void RandomGenerator::fill(const std::span<uint32_t> out, const uint32_t min, const uint32_t max) {
+  uint64_t local_state = state;
+  for (auto& value : out)
+    value = get_uint(local_state, increment, min, max);
+  state = local_state;
 }
 
-glm::vec3 Random::get_vec3(const float min, const float max) {
-  return {get_float() * (max - min) + min, get_float() * (max - min) + min, get_float() * (max - min) + min};
+void RandomGenerator::fill(const std::span<float> out) {
+  uint64_t local_state = state;
+  for (auto& value : out)
+    value = to_float(step(local_state, increment));
+  state = local_state;
 }
 
-glm::vec3 Random::in_unit_sphere() {
-  return glm::normalize(get_vec3(-1.0f, 1.0f));
+void RandomGenerator::fill(const std::span<float> out, const float min, const float max) {
+  const float range = max - min;
+  uint64_t local_state = state;
+  for (auto& value : out)
+    value = min + to_float(step(local_state, increment)) * range;
+  state = local_state;
 }
 }
@@ -1,11 +1,87 @@
 ﻿#pragma once
+#include <atomic>
 #include <cstdint>
-#include <random>
+#include <span>
 
+#include "CVars.hpp"
 #include "Core/ESystem.hpp"
 #include "Core/Types.hpp"
 
 namespace ox {
+namespace RandomCVar {
+inline AutoCVar_Int cvar_seed("random.seed", "seed of the engine's random generators, 0 picks a new one every run", 0);
+}
+
+/// PCG32 (XSH RR): 16 bytes of state, a multiply and a rotate per number.
+/// Generators with the same seed and different streams give independent sequences.
+/// Not thread safe, every thread or system owns its own.
+class RandomGenerator {
+public:
+  RandomGenerator() { seed(0, 0); }
+  explicit RandomGenerator(const uint64_t seed_value, const uint64_t stream = 0) { seed(seed_value, stream); }
+
+  void seed(const uint64_t seed_value, const uint64_t stream = 0) {
+    state = 0;
+    increment = (stream << 1u) | 1u;
+    next_uint();
+    state += seed_value;
+    next_uint();
+  }
+
+  uint32_t next_uint() { return step(state, increment); }
+
+  /// Uniform in [min, max] without modulo bias, min has to be <= max.
+  uint32_t get_uint(const uint32_t min, const uint32_t max) { return get_uint(state, increment, min, max); }
+  /// Uniform in [0, 1), 24 bits so every value is representable.
+  float get_float() { return to_float(next_uint()); }
+  float get_float(const float min, const float max) { return min + get_float() * (max - min); }
+
+  Vec3 get_vec3() { return {get_float(), get_float(), get_float()}; }
+  Vec3 get_vec3(const float min, const float max) { return {get_float(min, max), get_float(min, max), get_float(min, max)}; }
+  Vec3 get_vec3(const Vec3& min, const Vec3& max) { return {get_float(min.x, max.x), get_float(min.y, max.y), get_float(min.z, max.z)}; }
+
+  /// Bulk versions for particles and procedural placement. The state stays in registers for the whole loop
+  /// and the output is a plain array, ready to be consumed by vectorized code.
+  void fill(std::span<uint32_t> out);
+  void fill(std::span<uint32_t> out, uint32_t min, uint32_t max);
+  void fill(std::span<float> out);
+  void fill(std::span<float> out, float min, float max);
+
+private:
+  uint64_t state = 0;
+  uint64_t increment = 0;
+
+  static constexpr uint64_t MULTIPLIER = 6364136223846793005ull;
+
+  static uint32_t step(uint64_t& state, const uint64_t increment) {
+    const uint64_t old_state = state;
+    state = old_state * MULTIPLIER + increment;
+    const auto xorshifted = (uint32_t)(((old_state >> 18u) ^ old_state) >> 27u);
+    const auto rotation = (uint32_t)(old_state >> 59u);
+    return (xorshifted >> rotation) | (xorshifted << ((0u - rotation) & 31u));
+  }
+
+  // Lemire's multiply and reject, the division only runs when the first draw lands in the biased part.
+  static uint32_t get_uint(uint64_t& state, const uint64_t increment, const uint32_t min, const uint32_t max) {
+    const uint32_t range = max - min + 1;
+    if (range == 0)
+      return step(state, increment);
+
+    uint64_t product = (uint64_t)step(state, increment) * range;
+    if ((uint32_t)product < range) {
+      const uint32_t threshold = (0u - range) % range;
+      while ((uint32_t)product < threshold)
+        product = (uint64_t)step(state, increment) * range;
+    }
+    return min + (uint32_t)(product >> 32u);
+  }
+
+  static float to_float(const uint32_t value) { return (float)(value >> 8u) * 0x1.0p-24f; }
+};
+
+/// Owns the engine seed. The static getters draw from a generator local to the calling thread, so worker threads never share state.
+/// Each thread gets its own stream of the seed. Systems that need to replay the same sequence regardless of which
+/// thread runs them should keep a generator from create_generator() instead.
 class Random : public ESystem {
 public:
   Random() = default;
@@ -13,15 +89,28 @@ public:
   void init() override;
   void deinit() override;
 
-  static uint32_t get_uint();
-  static uint32_t get_uint(uint32_t min, uint32_t max);
-  static float get_float();
-  static Vec3 get_vec3();
-  static Vec3 get_vec3(float min, float max);
+  /// Reseeds every generator handed out by get_generator(), threads pick the new seed up on their next draw.
+  static void set_seed(uint64_t seed);
+  static uint64_t get_seed() { return global_seed.load(std::memory_order_relaxed); }
+
+  /// A generator on the next free stream of the engine seed.
+  static RandomGenerator create_generator();
+  /// A generator on a fixed stream of the engine seed, the same stream gives the same sequence every run with the same seed.
+  static RandomGenerator create_generator(uint64_t stream);
+
+  /// The calling thread's generator.
+  static RandomGenerator& get_generator();
+
+  static uint32_t get_uint() { return get_generator().next_uint(); }
+  static uint32_t get_uint(const uint32_t min, const uint32_t max) { return get_generator().get_uint(min, max); }
+  static float get_float() { return get_generator().get_float(); }
+  static Vec3 get_vec3() { return get_generator().get_vec3(); }
+  static Vec3 get_vec3(const float min, const float max) { return get_generator().get_vec3(min, max); }
   static Vec3 in_unit_sphere();
 
 private:
-  static std::mt19937 random_engine;
-  static std::uniform_int_distribution<std::mt19937::result_type> distribution;
+  static inline std::atomic<uint64_t> global_seed = 0;
+  static inline std::atomic<uint32_t> seed_version = 0;
+  static inline std::atomic<uint64_t> next_stream = 0;
 };
 }
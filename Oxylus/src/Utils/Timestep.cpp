@@ -32,4 +32,10 @@ void Timestep::on_update() {
   m_last_time = currentTime;
   m_elapsed += m_timestep;
 }
+
+void Timestep::on_update_fixed(const double millis) {
+  m_timestep = millis;
+  m_last_time = m_Timer->get_elapsed_msd();
+  m_elapsed += m_timestep;
+}
 }
@@ -9,6 +9,8 @@ public:
   ~Timestep();
 
   void on_update();
+  /// Advances by a fixed step instead of the measured frame time.
+  void on_update_fixed(double millis);
   double get_millis() const { return m_timestep; }
   double get_elapsed_millis() const { return m_elapsed; }
 
@@ -0,0 +1,91 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "Core/FileSystem.hpp"
+
+#include "Utils/Log.hpp"
+#include "Utils/Timer.hpp"
+
+namespace ox {
+double BenchmarkResult::get_percentile(const double percentile) const {
+  if (samples.empty())
+    return 0.0;
+
+  // Nearest rank, so p100 is the slowest sample and p50 of an even count is the lower median.
+  std::vector<double> sorted = samples;
+  std::ranges::sort(sorted);
+  const auto rank = (size_t)std::ceil(percentile / 100.0 * (double)sorted.size());
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+double BenchmarkResult::get_mean() const {
+  if (samples.empty())
+    return 0.0;
+  return std::accumulate(samples.begin(), samples.end(), 0.0) / (double)samples.size();
+}
+
+const BenchmarkResult& BenchmarkRunner::run(const std::string& name, const std::function<void()>& work, const std::function<void()>& setup) {
+  for (uint32_t i = 0; i < settings.warmup; i++) {
+    if (setup)
+      setup();
+    work();
+  }
+
+  auto& result = results.emplace_back(BenchmarkResult{.name = name});
+  result.samples.reserve(settings.iterations);
+  for (uint32_t i = 0; i < settings.iterations; i++) {
+    if (setup)
+      setup();
+    const Timer timer = {};
+    work();
+    result.samples.emplace_back(timer.get_elapsed_msd());
+  }
+
+  OX_LOG_INFO("{}: p50 {:.3f}ms, p99 {:.3f}ms", name, result.get_percentile(50.0), result.get_percentile(99.0));
+  return result;
+}
+
+void BenchmarkRunner::add_config(const std::string& key, const std::string& value) { config.emplace_back(key, fmt::format("\"{}\"", value)); }
+
+void BenchmarkRunner::add_config(const std::string& key, const int64_t value) { config.emplace_back(key, fmt::format("{}", value)); }
+
+bool BenchmarkRunner::write_json(const std::string& path) const {
+  std::string json = "{\n  \"config\": {\n";
+  json += fmt::format("    \"hardware_threads\": {},\n", std::thread::hardware_concurrency());
+  json += fmt::format("    \"warmup\": {},\n", settings.warmup);
+  json += fmt::format("    \"iterations\": {}", settings.iterations);
+  for (const auto& [key, value] : config)
+    json += fmt::format(",\n    \"{}\": {}", key, value);
+  json += "\n  },\n  \"benchmarks\": [\n";
+
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto& result = results[i];
+    json += fmt::format("    {{\"name\": \"{}\", \"unit\": \"ms\", \"samples\": {}, \"mean\": {:.6f}, \"min\": {:.6f}, "
+                        "\"p50\": {:.6f}, \"p90\": {:.6f}, \"p99\": {:.6f}, \"max\": {:.6f}}}{}\n",
+                        result.name,
+                        result.samples.size(),
+                        result.get_mean(),
+                        result.get_percentile(0.0),
+                        result.get_percentile(50.0),
+                        result.get_percentile(90.0),
+                        result.get_percentile(99.0),
+                        result.get_percentile(100.0),
+                        i + 1 < results.size() ? "," : "");
+  }
+  json += "  ]\n}";
+
+  if (!FileSystem::write_file(path, json)) {
+    OX_LOG_ERROR("Couldn't write benchmark results to {}", path);
+    return false;
+  }
+
+  OX_LOG_INFO("Benchmark results written to {}", path);
+  return true;
+}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ox {
+struct BenchmarkResult {
+  std::string name;
+  std::vector<double> samples = {}; // Milliseconds, one per timed iteration
+
+  double get_percentile(double percentile) const;
+  double get_mean() const;
+};
+
+/// Times a piece of work over a number of iterations and writes every result as JSON.
+/// Each run gets a few untimed warmup iterations first so caches, pools and Lua's GC settle.
+class BenchmarkRunner {
+public:
+  struct Settings {
+    uint32_t warmup = 5;
+    uint32_t iterations = 100;
+  };
+
+  explicit BenchmarkRunner(const Settings& settings) : settings(settings) {}
+
+  /// setup runs before every iteration outside of the timed region, e.g. to reset state the work consumes.
+  const BenchmarkResult& run(const std::string& name, const std::function<void()>& work, const std::function<void()>& setup = {});
+
+  /// Parameters are written as-is into the "config" object so runs with different scenes aren't compared by accident.
+  void add_config(const std::string& key, const std::string& value);
+  void add_config(const std::string& key, int64_t value);
+
+  bool write_json(const std::string& path) const;
+
+  const std::vector<BenchmarkResult>& get_results() const { return results; }
+
+private:
+  Settings settings;
+  std::vector<std::pair<std::string, std::string>> config = {}; // Values are already JSON encoded
+  std::vector<BenchmarkResult> results = {};
+};
+}
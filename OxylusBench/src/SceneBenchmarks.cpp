@@ -0,0 +1,172 @@
+#include "SceneBenchmarks.hpp"
+
+#include <filesystem>
+
+#include "Render/Mesh.h"
+
+#define TINYGLTF_USE_RAPIDJSON
+#define TINYGLTF_NO_INCLUDE_RAPIDJSON
+// includes for tinygltf
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/rapidjson.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <tiny_gltf.h>
+
+#include "Benchmark.hpp"
+
+#include "Core/FileSystem.hpp"
+#include "Core/FrameAllocator.hpp"
+
+#include "Physics/Physics.hpp"
+
+#include "Render/Camera.hpp"
+#include "Render/NullRenderPipeline.h"
+
+#include "Scene/Scene.hpp"
+#include "Scene/SceneSerializer.hpp"
+
+#include "Scripting/LuaSystem.hpp"
+
+#include "Utils/Log.hpp"
+#include "Utils/Timestep.hpp"
+
+namespace ox {
+// Per-entity state and a bit of math, roughly what a small gameplay script does every frame.
+static constexpr auto BENCH_SCRIPT = R"(
+local time = 0.0
+local phase = math.random() * math.pi
+
+function on_update(dt)
+  time = time + dt * 0.001
+  local x = math.sin(time + phase) * 2.0
+  local z = math.cos(time + phase) * 2.0
+  distance = math.sqrt(x * x + z * z)
+end
+)";
+
+void SceneBenchmarks::run_scene(BenchmarkRunner& runner, const BenchConfig& config) {
+  const auto pipeline = create_shared<NullRenderPipeline>("NullRenderPipeline");
+  const auto proxy_mesh = SceneGenerator::create_proxy_mesh();
+
+  auto desc = config.scene;
+  desc.rigidbody_count = 0;
+  desc.script_count = 0;
+  const auto scene = SceneGenerator::generate(desc, pipeline, proxy_mesh);
+
+  Camera camera(Vec3(0.0f, 40.0f, 0.0f));
+  Timestep timestep = {};
+
+  runner.run(
+    "scene_renderer_update",
+    [&] {
+      scene->on_editor_update(timestep, camera);
+      pipeline->on_render_headless();
+    },
+    [&] {
+      FrameAllocator::begin_frame();
+      timestep.on_update();
+    });
+  const auto& stats = pipeline->get_last_frame_stats();
+  OX_LOG_INFO("{} of {} meshes visible, {} lights, {} shadow cascades", stats.visible_meshes, stats.registered_meshes, stats.lights, stats.shadow_cascades);
+
+  Shared<Scene> copied_scene = nullptr;
+  runner.run("scene_copy", [&] { copied_scene = Scene::copy(scene); }, [&] { copied_scene.reset(); });
+  copied_scene.reset();
+
+  // Mesh components reference their file by path, the proxy mesh has none, so the serialized scene goes without them.
+  desc.meshes = false;
+  const auto serialized_scene = SceneGenerator::generate(desc, pipeline, proxy_mesh);
+  const auto scene_path = FileSystem::append_paths(config.work_directory, "bench_scene.oxscene");
+
+  runner.run("scene_serialize", [&] { SceneSerializer(serialized_scene).serialize(scene_path); });
+
+  Shared<Scene> loaded_scene = nullptr;
+  runner.run(
+    "scene_deserialize",
+    [&] { SceneSerializer(loaded_scene).deserialize(scene_path); },
+    [&] {
+      loaded_scene.reset();
+      loaded_scene = create_shared<Scene>(pipeline);
+    });
+  loaded_scene.reset();
+
+  std::filesystem::remove(scene_path);
+}
+
+void SceneBenchmarks::run_runtime(BenchmarkRunner& runner, const BenchConfig& config) {
+  // Steps have to run on this thread to be timed.
+  PhysicsCVar::cvar_threaded.set(0);
+
+  const auto script_path = FileSystem::append_paths(config.work_directory, "bench_script.lua");
+  if (config.scene.script_count > 0 && !FileSystem::write_file(script_path, BENCH_SCRIPT)) {
+    OX_LOG_ERROR("Couldn't write the benchmark script to {}", script_path);
+    return;
+  }
+
+  const auto pipeline = create_shared<NullRenderPipeline>("NullRenderPipeline");
+  const auto proxy_mesh = SceneGenerator::create_proxy_mesh();
+
+  auto desc = config.scene;
+  desc.script_path = script_path;
+  const auto scene = SceneGenerator::generate(desc, pipeline, proxy_mesh);
+  scene->on_runtime_start();
+
+  Timestep timestep = {};
+
+  runner.run("physics_step", [] { Physics::step(1.0f / Physics::STEP_RATE); });
+
+  const auto script_view = scene->registry.view<LuaScriptComponent>();
+  runner.run(
+    "lua_update",
+    [&] {
+      for (auto&& [e, script_component] : script_view.each()) {
+        for (const auto& script : script_component.lua_systems)
+          script->on_update(timestep);
+      }
+    },
+    [&] { timestep.on_update(); });
+
+  runner.run(
+    "runtime_update",
+    [&] {
+      scene->on_runtime_update(timestep);
+      pipeline->on_render_headless();
+    },
+    [&] {
+      FrameAllocator::begin_frame();
+      timestep.on_update();
+    });
+
+  scene->on_runtime_stop();
+
+  if (config.scene.script_count > 0)
+    std::filesystem::remove(script_path);
+}
+
+void SceneBenchmarks::run_gltf(BenchmarkRunner& runner, const BenchConfig& config) {
+  if (config.gltf_path.empty()) {
+    OX_LOG_INFO("No glTF file given, skipping gltf_import.");
+    return;
+  }
+
+  if (!std::filesystem::exists(config.gltf_path)) {
+    OX_LOG_ERROR("Couldn't find the glTF file: {}", config.gltf_path);
+    return;
+  }
+
+  const bool is_ascii = FileSystem::get_file_extension(config.gltf_path) == "gltf";
+  runner.run("gltf_import", [&] {
+    tinygltf::Model gltf_model;
+    tinygltf::TinyGLTF gltf_context;
+    std::string error, warning;
+
+    const bool file_loaded = is_ascii ? gltf_context.LoadASCIIFromFile(&gltf_model, &error, &warning, config.gltf_path)
+                                      : gltf_context.LoadBinaryFromFile(&gltf_model, &error, &warning, config.gltf_path);
+    if (!file_loaded)
+      OX_LOG_ERROR("Couldnt load gltf file: {}", error);
+  });
+}
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+
+#include "SceneGenerator.hpp"
+
+namespace ox {
+class BenchmarkRunner;
+
+struct BenchConfig {
+  SyntheticSceneDesc scene = {};
+  std::string gltf_path = {};       // Optional, the glTF benchmark is skipped without it
+  std::string work_directory = "."; // Scene files and the generated Lua script are written here
+};
+
+class SceneBenchmarks {
+public:
+  /// SceneRenderer update with culling, Scene::copy and serialization on a scene with the configured hierarchy and lights.
+  static void run_scene(BenchmarkRunner& runner, const BenchConfig& config);
+  /// Physics stepping, Lua on_update and full runtime frames on a running scene with the configured rigidbodies and scripts.
+  static void run_runtime(BenchmarkRunner& runner, const BenchConfig& config);
+  /// glTF parsing and image decoding, the CPU side of Mesh::load_from_file. Uploading needs a device and isn't measured.
+  static void run_gltf(BenchmarkRunner& runner, const BenchConfig& config);
+};
+}
@@ -0,0 +1,114 @@
+#include "SceneGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include "Render/Mesh.h"
+
+#include "Scene/Components.hpp"
+#include "Scene/Entity.hpp"
+#include "Scene/Scene.hpp"
+
+#include "Scripting/LuaSystem.hpp"
+
+#include "Utils/Profiler.hpp"
+#include "Utils/Random.hpp"
+
+namespace ox {
+Shared<Mesh> SceneGenerator::create_proxy_mesh() {
+  auto mesh = create_shared<Mesh>();
+  mesh->name = "BenchProxy";
+
+  auto* node = new Mesh::Node();
+  node->name = "BenchProxy";
+  node->aabb = AABB(Vec3(-0.5f), Vec3(0.5f));
+  mesh->nodes.emplace_back(node);
+  mesh->linear_nodes.emplace_back(node);
+  mesh->aabb = node->aabb;
+
+  return mesh;
+}
+
+Shared<Scene> SceneGenerator::generate(const SyntheticSceneDesc& desc, const Shared<RenderPipeline>& render_pipeline, const Shared<Mesh>& proxy_mesh) {
+  OX_SCOPED_ZONE;
+
+  auto scene = create_shared<Scene>(render_pipeline);
+  auto& registry = scene->registry;
+
+  RandomGenerator rng(desc.seed);
+  const auto world_dist = [&rng] { return rng.get_float(-200.0f, 200.0f); };
+  const auto local_dist = [&rng] { return rng.get_float(-4.0f, 4.0f); };
+  const auto angle_dist = [&rng] { return rng.get_float(-glm::pi<float>(), glm::pi<float>()); };
+
+  const auto add_mesh = [&](const entt::entity entity) {
+    if (!desc.meshes)
+      return;
+    auto& mc = registry.emplace<MeshComponent>(entity);
+    mc.mesh_base = proxy_mesh;
+    mc.node_index = 0;
+  };
+
+  // Hierarchy: runs of hierarchy_depth entities, each one parented to the previous.
+  const uint32_t depth = std::max(desc.hierarchy_depth, 1u);
+  entt::entity previous = entt::null;
+  for (uint32_t i = 0; i < desc.entity_count; i++) {
+    const auto entity = scene->create_entity(fmt::format("Entity {}", i));
+    auto& tc = registry.get<TransformComponent>(entity);
+    const bool is_root = i % depth == 0;
+    tc.position = is_root ? Vec3(world_dist(), world_dist() * 0.1f, world_dist()) : Vec3(local_dist(), local_dist(), local_dist());
+    tc.rotation = Vec3(0.0f, angle_dist(), 0.0f);
+
+    if (!is_root)
+      EUtil::set_parent(scene.get(), entity, previous);
+    add_mesh(entity);
+
+    if (i < desc.script_count && !desc.script_path.empty())
+      registry.emplace<LuaScriptComponent>(entity).lua_systems.emplace_back(create_shared<LuaSystem>(desc.script_path));
+
+    previous = entity;
+  }
+
+  // Lights: one sun, the rest point lights scattered over the scene.
+  for (uint32_t i = 0; i < desc.light_count; i++) {
+    const auto entity = scene->create_entity(fmt::format("Light {}", i));
+    auto& tc = registry.get<TransformComponent>(entity);
+    auto& lc = registry.emplace<LightComponent>(entity);
+    if (i == 0) {
+      lc.type = LightComponent::Directional;
+      tc.rotation = Vec3(glm::radians(-60.0f), glm::radians(30.0f), 0.0f);
+    }
+    else {
+      lc.type = LightComponent::Point;
+      lc.range = 20.0f;
+      tc.position = Vec3(world_dist(), 10.0f, world_dist());
+    }
+  }
+
+  // Rigidbodies: a grid of boxes a bit above a static ground that is large enough to catch all of them.
+  if (desc.rigidbody_count > 0) {
+    constexpr float spacing = 1.5f;
+    const auto side = (uint32_t)std::ceil(std::sqrt((float)desc.rigidbody_count));
+    const float half_extent = (float)side * spacing * 0.5f;
+
+    const auto ground = scene->create_entity("Ground");
+    registry.get<TransformComponent>(ground).position = Vec3(0.0f, -0.5f, 0.0f);
+    registry.emplace<BoxColliderComponent>(ground).size = Vec3(half_extent + 10.0f, 0.5f, half_extent + 10.0f);
+    registry.emplace<RigidbodyComponent>(ground).type = RigidbodyComponent::BodyType::Static;
+
+    for (uint32_t i = 0; i < desc.rigidbody_count; i++) {
+      const auto entity = scene->create_entity(fmt::format("Body {}", i));
+      auto& tc = registry.get<TransformComponent>(entity);
+      tc.position = Vec3((float)(i % side) * spacing - half_extent, 6.0f + local_dist() * 0.25f, (float)(i / side) * spacing - half_extent);
+      tc.rotation = Vec3(angle_dist(), angle_dist(), angle_dist()) * 0.1f;
+
+      registry.emplace<BoxColliderComponent>(entity);
+      registry.emplace<RigidbodyComponent>(entity);
+      add_mesh(entity);
+    }
+  }
+
+  return scene;
+}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+
+#include "Core/Base.hpp"
+
+namespace ox {
+class Mesh;
+class RenderPipeline;
+class Scene;
+
+struct SyntheticSceneDesc {
+  uint32_t entity_count = 10000;
+  uint32_t hierarchy_depth = 4; // Entities are chained into parent/child runs of this length
+  uint32_t light_count = 64;
+  uint32_t rigidbody_count = 0; // Dynamic boxes dropped onto a static ground
+  uint32_t script_count = 0;    // Entities that get script_path attached
+  std::string script_path = {};
+  bool meshes = true; // Meshes can't be serialized without a device, they are skipped in scenes used for that
+  uint32_t seed = 1337;
+};
+
+class SceneGenerator {
+public:
+  /// A single node mesh with a unit cube bounding box and no GPU data, enough for the mesh system and culling.
+  static Shared<Mesh> create_proxy_mesh();
+
+  /// Same description and seed give the same scene, so results from different runs stay comparable.
+  static Shared<Scene> generate(const SyntheticSceneDesc& desc, const Shared<RenderPipeline>& render_pipeline, const Shared<Mesh>& proxy_mesh);
+};
+}
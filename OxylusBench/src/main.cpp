@@ -0,0 +1,117 @@
+#include <filesystem>
+#include <string>
+
+#include "Benchmark.hpp"
+#include "SceneBenchmarks.hpp"
+
+#include "Core/App.hpp"
+
+#include "Utils/Log.hpp"
+
+namespace ox {
+static void print_usage() {
+  OX_LOG_INFO("Usage: OxylusBench [--entities N] [--depth D] [--lights M] [--rigidbodies K] [--scripts S] [--seed X]\n"
+              "                   [--iterations I] [--warmup W] [--gltf path] [--out results.json]");
+}
+
+static bool parse_args(const int argc, char** argv, BenchConfig& config, BenchmarkRunner::Settings& settings, std::string& output_path) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h")
+      return false;
+
+    if (i + 1 >= argc) {
+      OX_LOG_ERROR("Missing value for {}", arg);
+      return false;
+    }
+
+    const std::string value = argv[++i];
+    if (arg == "--entities")
+      config.scene.entity_count = (uint32_t)std::stoul(value);
+    else if (arg == "--depth")
+      config.scene.hierarchy_depth = (uint32_t)std::stoul(value);
+    else if (arg == "--lights")
+      config.scene.light_count = (uint32_t)std::stoul(value);
+    else if (arg == "--rigidbodies")
+      config.scene.rigidbody_count = (uint32_t)std::stoul(value);
+    else if (arg == "--scripts")
+      config.scene.script_count = (uint32_t)std::stoul(value);
+    else if (arg == "--seed")
+      config.scene.seed = (uint32_t)std::stoul(value);
+    else if (arg == "--iterations")
+      settings.iterations = (uint32_t)std::stoul(value);
+    else if (arg == "--warmup")
+      settings.warmup = (uint32_t)std::stoul(value);
+    else if (arg == "--gltf")
+      config.gltf_path = value;
+    else if (arg == "--out")
+      output_path = value;
+    else {
+      OX_LOG_ERROR("Unknown argument {}", arg);
+      return false;
+    }
+  }
+
+  return true;
+}
+}
+
+int main(int argc, char** argv) {
+  ox::Log::init(argc, argv);
+
+  ox::BenchConfig config = {};
+  config.scene.rigidbody_count = 1000;
+  config.scene.script_count = 1000;
+  ox::BenchmarkRunner::Settings settings = {};
+  std::string output_path = "bench_results.json";
+
+  try {
+    if (!ox::parse_args(argc, argv, config, settings, output_path)) {
+      ox::print_usage();
+      return 1;
+    }
+  }
+  catch (const std::exception&) {
+    OX_LOG_ERROR("Arguments have to be unsigned integers, except for --gltf and --out.");
+    ox::print_usage();
+    return 1;
+  }
+
+  const auto output_directory = std::filesystem::absolute(output_path).parent_path();
+  config.work_directory = output_directory.string();
+
+  ox::AppSpec spec;
+  spec.name = "Oxylus Bench";
+  spec.assets_path = config.work_directory; // Nothing is loaded from it, the app just requires it to exist
+  spec.headless = true;
+  spec.command_line_args = {argc, argv};
+  const auto app = new ox::App(spec);
+
+  ox::BenchmarkRunner runner(settings);
+  runner.add_config("entities", config.scene.entity_count);
+  runner.add_config("hierarchy_depth", config.scene.hierarchy_depth);
+  runner.add_config("lights", config.scene.light_count);
+  runner.add_config("rigidbodies", config.scene.rigidbody_count);
+  runner.add_config("scripts", config.scene.script_count);
+  runner.add_config("seed", config.scene.seed);
+#if defined(OX_DEBUG)
+  runner.add_config("build", "Debug");
+#elif defined(OX_RELEASE)
+  runner.add_config("build", "Release");
+#else
+  runner.add_config("build", "Distribution");
+#endif
+
+  ox::SceneBenchmarks::run_scene(runner, config);
+  ox::SceneBenchmarks::run_runtime(runner, config);
+  ox::SceneBenchmarks::run_gltf(runner, config);
+
+  const bool written = runner.write_json(output_path);
+
+  app->shutdown();
+  delete app;
+
+  ox::Log::shutdown();
+
+  return written ? 0 : 1;
+}
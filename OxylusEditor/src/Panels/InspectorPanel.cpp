@@ -395,6 +395,7 @@ void InspectorPanel::draw_components(Entity entity) {
     OxUI::property("Pitch Multiplier", &config.pitch_multiplier);
     OxUI::property("Play On Awake", &config.play_on_awake);
     OxUI::property("Looping", &config.looping);
+    OxUI::property("Priority", &config.priority, 0, 255);
     OxUI::end_properties();
 
     ImGui::Spacing();
@@ -630,6 +631,11 @@ void InspectorPanel::draw_components(Entity entity) {
 
     OxUI::property("Friction", &component.friction, 0.0f, 1.0f);
     OxUI::property("CollisionTolerance", &component.collision_tolerance);
+    OxUI::property("MaxSlopeAngle", &component.max_slope_angle, 0.0f, 90.0f);
+    OxUI::property("MaxStepHeight", &component.max_step_height);
+    OxUI::property("StickToFloorDistance", &component.stick_to_floor_distance);
+    OxUI::property("Mass", &component.mass);
+    OxUI::property("MaxStrength", &component.max_strength);
     OxUI::end_properties();
   });
 
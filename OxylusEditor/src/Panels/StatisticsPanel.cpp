@@ -1,8 +1,21 @@
 ﻿#include "StatisticsPanel.hpp"
 
+#include <algorithm>
+#include <cfloat>
+
 #include <icons/IconsMaterialDesignIcons.h>
 #include <imgui.h>
 
+#include "Core/App.hpp"
+#include "Core/FrameAllocator.hpp"
+#include "Core/Memory.hpp"
+
+#include "Scripting/LuaManager.hpp"
+#include "Scripting/LuaProfiler.hpp"
+
+#include "Utils/CpuProfiler.hpp"
+#include "Utils/FrameStats.hpp"
+
 namespace ox {
   StatisticsPanel::StatisticsPanel() : EditorPanel("Statistics", ICON_MDI_CLIPBOARD_TEXT, false) {}
 
@@ -13,8 +26,16 @@ namespace ox {
           MemoryTab();
           ImGui::EndTabItem();
         }
-        if (ImGui::BeginTabItem("Renderer")) {
-          RendererTab();
+        if (ImGui::BeginTabItem("Frame")) {
+          FrameTab();
+          ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem("Scripting")) {
+          ScriptingTab();
+          ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem("Profiler")) {
+          ProfilerTab();
           ImGui::EndTabItem();
         }
 
@@ -25,55 +46,331 @@ namespace ox {
   }
 
   void StatisticsPanel::MemoryTab() const {
-#if 0
-    static bool showInMegabytes;
-    ImGui::Checkbox("Show in megabytes", &showInMegabytes);
+    static bool show_in_megabytes = false;
+    ImGui::Checkbox("Show in megabytes", &show_in_megabytes);
     ImGui::Separator();
-    const auto sizetype = showInMegabytes ? "mb" : "kb";
-    {
-      ImGui::Text("RAM");
-      auto totalAllocated = showInMegabytes ? (float)Memory::TotalAllocated / 1024.0f / 1024.0f : (float)Memory::TotalAllocated / 1024.0f;
-      auto totalFreed = showInMegabytes ? (float)Memory::TotalFreed / 1024.0f / 1024.0f : (float)Memory::TotalFreed / 1024.0f;
-      auto currentUsage = showInMegabytes ? (float)Memory::CurrentUsage() / 1024.0f / 1024.0f : (float)Memory::CurrentUsage() / 1024.0f;
-      ImGui::Text("%s", fmt::format("Total Allocated: {0} {1}", totalAllocated, sizetype).c_str());
-      ImGui::Text("%s", fmt::format("Total Freed: {0} {1}", totalFreed, sizetype).c_str());
-      ImGui::Text("%s", fmt::format("Current Usage: {0} {1}", currentUsage, sizetype).c_str());
+    const auto to_unit = [](const int64_t bytes) { return (double)bytes / (show_in_megabytes ? 1024.0 * 1024.0 : 1024.0); };
+    const char* unit = show_in_megabytes ? "mb" : "kb";
+
+    const auto total = Memory::get_total_stats();
+    ImGui::Text("Tracked RAM: %.2f %s (%lld allocations)", to_unit(total.live_bytes), unit, static_cast<long long>(total.live_allocations));
+    ImGui::Text("Frame allocator: %.2f / %.2f %s", to_unit((int64_t)FrameAllocator::get_used()), to_unit((int64_t)FrameAllocator::get_capacity()), unit);
+
+    constexpr ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders;
+    if (ImGui::BeginTable("MemoryTags", 5, table_flags)) {
+      ImGui::TableSetupColumn("Tag");
+      ImGui::TableSetupColumn(show_in_megabytes ? "Live (mb)" : "Live (kb)");
+      ImGui::TableSetupColumn(show_in_megabytes ? "Peak (mb)" : "Peak (kb)");
+      ImGui::TableSetupColumn("Live allocations");
+      ImGui::TableSetupColumn("Total allocations");
+      ImGui::TableHeadersRow();
+      for (size_t i = 0; i < (size_t)MemoryTag::Count; i++) {
+        const auto tag = (MemoryTag)i;
+        const auto stats = Memory::get_stats(tag);
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(Memory::get_tag_name(tag));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2f", to_unit(stats.live_bytes));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2f", to_unit(stats.peak_bytes));
+        ImGui::TableNextColumn();
+        ImGui::Text("%lld", static_cast<long long>(stats.live_allocations));
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(stats.total_allocations));
+      }
+      ImGui::EndTable();
+    }
+  }
+
+  void StatisticsPanel::FrameTab() {
+    const auto& last_frame = FrameStats::get_last_frame();
+    const auto frame_summary = FrameStats::get_frame_summary();
+    ImGui::Text("FPS: %.1f (p50 frame)", frame_summary.p50 > 0.0f ? 1000.0 / (double)frame_summary.p50 : 0.0);
+    ImGui::Text("Last frame: %.3f ms", (double)last_frame.total_ms);
+
+    float hitch_ms = FrameStatsCVar::cvar_hitch_ms.get();
+    ImGui::SetNextItemWidth(100);
+    if (ImGui::DragFloat("Hitch threshold (ms)", &hitch_ms, 0.1f, 0.0f, 1000.0f, "%.1f"))
+      FrameStatsCVar::cvar_hitch_ms.set(hitch_ms);
+    if (hitch_ms <= 0.0f) {
+      ImGui::SameLine();
+      ImGui::TextDisabled("(auto: %.1f ms)", (double)FrameStats::get_hitch_threshold());
+    }
+    if (ImGui::Button("Reset"))
+      FrameStats::reset();
+    ImGui::SameLine();
+    if (ImGui::Button("Export"))
+      FrameStats::export_csv(FrameStatsCVar::cvar_export_path.get());
+
+    constexpr ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders;
+    if (ImGui::BeginTable("FramePhases", 7, table_flags)) {
+      ImGui::TableSetupColumn("Phase");
+      ImGui::TableSetupColumn("Last (ms)");
+      ImGui::TableSetupColumn("p50");
+      ImGui::TableSetupColumn("p95");
+      ImGui::TableSetupColumn("p99");
+      ImGui::TableSetupColumn("Max");
+      ImGui::TableSetupColumn("Mean");
+      ImGui::TableHeadersRow();
+
+      const auto add_row = [this](const char* name, const int32_t phase, const float last_ms, const FrameStats::Summary& summary) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        if (ImGui::Selectable(name, m_SelectedPhase == phase, ImGuiSelectableFlags_SpanAllColumns))
+          m_SelectedPhase = phase;
+        for (const float value : {last_ms, summary.p50, summary.p95, summary.p99, summary.max, summary.mean}) {
+          ImGui::TableNextColumn();
+          ImGui::Text("%.3f", (double)value);
+        }
+      };
+
+      add_row("Frame", -1, last_frame.total_ms, frame_summary);
+      for (uint32_t i = 0; i < FrameStats::PHASE_COUNT; i++)
+        add_row(FrameStats::get_phase_name((FramePhase)i), (int32_t)i, last_frame.phase_ms[i], FrameStats::get_summary((FramePhase)i));
+      ImGui::EndTable();
+    }
+
+    const auto& histogram = m_SelectedPhase < 0 ? FrameStats::get_frame_histogram() : FrameStats::get_histogram((FramePhase)m_SelectedPhase);
+    const char* selected_name = m_SelectedPhase < 0 ? "Frame" : FrameStats::get_phase_name((FramePhase)m_SelectedPhase);
+
+    // Frame times oldest first.
+    ImGui::PlotLines("##FrameTimes",
+                     [](void* data, const int32_t i) { return static_cast<const FrameStats::Histogram*>(data)->get_sample((uint32_t)i); },
+                     (void*)&histogram,
+                     (int32_t)histogram.get_count(),
+                     0,
+                     selected_name,
+                     0.0f,
+                     FLT_MAX,
+                     {ImGui::GetContentRegionAvail().x, 80});
+
+    // Only the range that has samples, the buckets are log scale.
+    const auto& buckets = histogram.get_buckets();
+    uint32_t first = FrameStats::Histogram::BUCKET_COUNT, last = 0;
+    for (uint32_t i = 0; i < FrameStats::Histogram::BUCKET_COUNT; i++) {
+      if (buckets[i] > 0) {
+        first = std::min(first, i);
+        last = i;
+      }
+    }
+    if (first <= last) {
+      const auto overlay = fmt::format("{:.2f} - {:.2f} ms", FrameStats::Histogram::get_bucket_start(first), FrameStats::Histogram::get_bucket_start(last + 1));
+      ImGui::PlotHistogram("##Histogram",
+                           [](void* data, const int32_t i) { return (float)static_cast<const uint32_t*>(data)[i]; },
+                           (void*)(buckets.data() + first),
+                           (int32_t)(last - first + 1),
+                           0,
+                           overlay.c_str(),
+                           0.0f,
+                           FLT_MAX,
+                           {ImGui::GetContentRegionAvail().x, 80});
+    }
+
+    const auto& hitches = FrameStats::get_hitches();
+    ImGui::Text("Hitches: %llu", static_cast<unsigned long long>(FrameStats::get_hitch_count()));
+    if (hitches.empty())
+      return;
+
+    if (ImGui::BeginTable("Hitches", 3, table_flags | ImGuiTableFlags_ScrollY, {0, 150})) {
+      ImGui::TableSetupColumn("Frame");
+      ImGui::TableSetupColumn("Total (ms)");
+      ImGui::TableSetupColumn("Threshold (ms)");
+      ImGui::TableHeadersRow();
+      for (int32_t i = (int32_t)hitches.size() - 1; i >= 0; i--) {
+        const auto& hitch = hitches[i];
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        const auto label = fmt::format("{}##hitch{}", hitch.frame.index, i);
+        if (ImGui::Selectable(label.c_str(), m_SelectedHitch == i, ImGuiSelectableFlags_SpanAllColumns))
+          m_SelectedHitch = i;
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", (double)hitch.frame.total_ms);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", (double)hitch.threshold_ms);
+      }
+      ImGui::EndTable();
     }
+
+    // Where the selected hitch spent its time.
+    if (m_SelectedHitch >= 0 && m_SelectedHitch < (int32_t)hitches.size()) {
+      const auto& hitch = hitches[m_SelectedHitch];
+      for (uint32_t i = 0; i < FrameStats::PHASE_COUNT; i++) {
+        const float fraction = hitch.frame.total_ms > 0.0f ? hitch.frame.phase_ms[i] / hitch.frame.total_ms : 0.0f;
+        const auto overlay = fmt::format("{}: {:.3f} ms", FrameStats::get_phase_name((FramePhase)i), hitch.frame.phase_ms[i]);
+        ImGui::ProgressBar(fraction, {-1, 0}, overlay.c_str());
+      }
+    }
+  }
+
+  void StatisticsPanel::ScriptingTab() const {
+    const auto* lua_manager = App::get_system<LuaManager>();
+    const auto& gc_stats = lua_manager->get_gc_stats();
+    ImGui::Text("Lua heap: %.1f kb", static_cast<double>(gc_stats.heap_kb));
+    ImGui::Text("GC mode: %s", lua_manager->is_gc_generational() ? "generational" : "incremental");
+    ImGui::Text("GC time last frame (us): %.1f", static_cast<double>(gc_stats.step_time_us));
+    ImGui::Text("GC steps last frame: %u", gc_stats.steps);
+    ImGui::Text("Incremental cycles: %llu", static_cast<unsigned long long>(gc_stats.cycles));
+
+    int32_t budget = LuaCVar::cvar_gc_step_budget.get();
+    if (ImGui::DragInt("GC budget (us)", &budget, 10.0f, 0, 10000))
+      LuaCVar::cvar_gc_step_budget.set(budget);
+
     ImGui::Separator();
-    //GPU
-    {
-      ImGui::Text("GPU");
-      if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayShort)) {
-        ImGui::BeginTooltip();
-        ImGui::Text("Only image and buffer allocations are included.");
-        ImGui::EndTooltip();
+    int32_t profiler_mode = LuaCVar::cvar_profiler.get();
+    const char* profiler_modes[] = {"Off", "Timers", "Sampling"};
+    if (ImGui::Combo("Profiler", &profiler_mode, profiler_modes, 3))
+      LuaCVar::cvar_profiler.set(profiler_mode);
+    ImGui::SameLine();
+    if (ImGui::Button("Reset"))
+      LuaProfiler::reset();
+    ImGui::SameLine();
+    if (ImGui::Button("Export"))
+      LuaProfiler::export_csv("lua_profile.csv");
+
+    constexpr ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY;
+    if (ImGui::BeginTable("LuaCallbacks", 5, table_flags, {0, 200})) {
+      ImGui::TableSetupColumn("Script");
+      ImGui::TableSetupColumn("Callback");
+      ImGui::TableSetupColumn("Calls");
+      ImGui::TableSetupColumn("Total (ms)");
+      ImGui::TableSetupColumn("Max (ms)");
+      ImGui::TableHeadersRow();
+      for (const auto& stats : LuaProfiler::get_callback_stats()) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(stats.script.c_str());
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(stats.callback);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(stats.calls));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", stats.total_ms);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", stats.max_ms);
       }
-      auto totalAllocated = showInMegabytes ? (float)GPUMemory::TotalAllocated / 1024.0f / 1024.0f : (float)GPUMemory::TotalAllocated / 1024.0f;
-      auto totalFreed = showInMegabytes ? (float)GPUMemory::TotalFreed / 1024.0f / 1024.0f : (float)GPUMemory::TotalFreed / 1024.0f;
-      auto currentUsage = showInMegabytes ? (float)GPUMemory::CurrentUsage() / 1024.0f / 1024.0f : (float)GPUMemory::CurrentUsage() / 1024.0f;
-      ImGui::Text("%s", fmt::format("Total Allocated: {0} {1}", totalAllocated, sizetype).c_str());
-      ImGui::Text("%s", fmt::format("Total Freed: {0} {1}", totalFreed, sizetype).c_str());
-      ImGui::Text("%s", fmt::format("Current Usage: {0} {1}", currentUsage, sizetype).c_str());
-    }
-#endif
+      ImGui::EndTable();
+    }
+
+    if (ImGui::BeginTable("LuaEntities", 3, table_flags, {0, 150})) {
+      ImGui::TableSetupColumn("Entity");
+      ImGui::TableSetupColumn("Script");
+      ImGui::TableSetupColumn("Total (ms)");
+      ImGui::TableHeadersRow();
+      for (const auto& stats : LuaProfiler::get_entity_stats()) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", entt::to_integral(stats.entity));
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(stats.script.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", stats.total_ms);
+      }
+      ImGui::EndTable();
+    }
+
+    if (LuaProfiler::get_mode() == LuaProfiler::Mode::Sampling && ImGui::BeginTable("LuaSamples", 3, table_flags, {0, 200})) {
+      ImGui::TableSetupColumn("Location");
+      ImGui::TableSetupColumn("Function");
+      ImGui::TableSetupColumn("Samples");
+      ImGui::TableHeadersRow();
+      for (const auto& stats : LuaProfiler::get_sample_stats()) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%s:%d", stats.source.c_str(), stats.line);
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(stats.function.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(stats.samples));
+      }
+      ImGui::EndTable();
+    }
   }
 
-  void StatisticsPanel::RendererTab() {
-    float avg = 0.0;
+  void StatisticsPanel::ProfilerTab() {
+    ImGui::SetNextItemWidth(100);
+    ImGui::DragInt("Frames", &m_CaptureFrameCount, 1.0f, 1, (int)CpuProfiler::MAX_CAPTURE_FRAMES);
+    ImGui::SameLine();
+    ImGui::BeginDisabled(CpuProfiler::is_capturing());
+    if (ImGui::Button("Capture"))
+      CpuProfiler::capture((uint32_t)m_CaptureFrameCount);
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    if (ImGui::Button("Export"))
+      CpuProfiler::export_chrome_trace(ProfilerCVar::cvar_trace_path.get());
 
-    const size_t size = m_FrameTimes.size();
-    if (size >= 50)
-      m_FrameTimes.erase(m_FrameTimes.begin());
+    const auto& capture = CpuProfiler::get_last_capture();
+    if (capture.frames.empty()) {
+      ImGui::TextUnformatted("No capture yet.");
+      return;
+    }
+
+    m_SelectedFrame = std::clamp(m_SelectedFrame, 0, (int32_t)capture.frames.size() - 1);
+    const auto& frame = capture.frames[m_SelectedFrame];
+    const double frame_ms = (double)(frame.end_ns - frame.start_ns) / 1e6;
+    ImGui::SliderInt("Frame", &m_SelectedFrame, 0, (int32_t)capture.frames.size() - 1);
+    ImGui::SameLine();
+    ImGui::Text("%.3f ms", frame_ms);
+    ImGui::SliderFloat("Zoom", &m_TimelineZoom, 1.0f, 50.0f, "%.1fx", ImGuiSliderFlags_Logarithmic);
+    if (capture.dropped_events > 0)
+      ImGui::TextColored({1, 0.5f, 0, 1}, "%llu zones were dropped", static_cast<unsigned long long>(capture.dropped_events));
+
+    // Lanes per thread, as deep as the deepest zone of this frame.
+    std::vector<uint32_t> lane_depths(capture.thread_names.size(), 0);
+    for (const auto& event : capture.events) {
+      if (event.end_ns >= frame.start_ns && event.start_ns <= frame.end_ns && event.thread < lane_depths.size())
+        lane_depths[event.thread] = std::max(lane_depths[event.thread], event.depth + 1);
+    }
+
+    constexpr float row_height = 18.0f;
+    constexpr float label_width = 90.0f;
+    std::vector<float> lane_offsets(lane_depths.size(), 0.0f);
+    float total_height = 0.0f;
+    for (size_t i = 0; i < lane_depths.size(); i++) {
+      lane_offsets[i] = total_height;
+      if (lane_depths[i] > 0)
+        total_height += (float)lane_depths[i] * row_height + 4.0f;
+    }
+
+    ImGui::BeginChild("Timeline", {0, 0}, true, ImGuiWindowFlags_HorizontalScrollbar);
+    const float width = (ImGui::GetContentRegionAvail().x - label_width) * m_TimelineZoom;
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::Dummy({label_width + width, total_height});
+    auto* draw_list = ImGui::GetWindowDrawList();
+
+    const double ns_to_px = (double)width / (double)std::max<uint64_t>(frame.end_ns - frame.start_ns, 1);
+    for (const auto& event : capture.events) {
+      if (event.end_ns < frame.start_ns || event.start_ns > frame.end_ns || event.thread >= lane_depths.size())
+        continue;
+
+      const float x0 = origin.x + label_width + (float)((double)((int64_t)event.start_ns - (int64_t)frame.start_ns) * ns_to_px);
+      const float x1 = std::max(origin.x + label_width + (float)((double)((int64_t)event.end_ns - (int64_t)frame.start_ns) * ns_to_px), x0 + 1.0f);
+      const float y0 = origin.y + lane_offsets[event.thread] + (float)event.depth * row_height;
+      const ImVec2 min = {std::max(x0, origin.x + label_width), y0};
+      const ImVec2 max = {x1, y0 + row_height - 1.0f};
+
+      // Same color for the same zone everywhere.
+      const auto hash = (uint32_t)(((uintptr_t)event.name >> 4) * 2654435761u);
+      const ImU32 color = IM_COL32(80 + (hash & 0x7F), 80 + ((hash >> 8) & 0x7F), 80 + ((hash >> 16) & 0x7F), 255);
+      draw_list->AddRectFilled(min, max, color);
+      if (max.x - min.x > 30.0f) {
+        draw_list->PushClipRect(min, max, true);
+        draw_list->AddText({min.x + 2.0f, min.y + 1.0f}, IM_COL32_WHITE, event.name);
+        draw_list->PopClipRect();
+      }
+
+      if (ImGui::IsMouseHoveringRect(min, max)) {
+        ImGui::BeginTooltip();
+        ImGui::Text("%s", event.name);
+        ImGui::Text("%.3f ms", (double)(event.end_ns - event.start_ns) / 1e6);
+        ImGui::EndTooltip();
+      }
+    }
 
-    m_FrameTimes.emplace_back(ImGui::GetIO().Framerate);
-    for (uint32_t i = 0; i < size; i++) {
-      const float frameTime = m_FrameTimes[i];
-      m_FpsValues[i] = frameTime;
-      avg += frameTime;
+    for (size_t i = 0; i < lane_depths.size(); i++) {
+      if (lane_depths[i] > 0)
+        draw_list->AddText({ImGui::GetWindowPos().x + 4.0f, origin.y + lane_offsets[i]}, IM_COL32_WHITE, capture.thread_names[i].c_str());
     }
-    avg /= (float)size;
-    ImGui::Text("FPS: %lf", static_cast<double>(avg));
-    const double fps = (1.0 / static_cast<double>(avg)) * 1000.0;
-    ImGui::Text("Frame time (ms): %lf", fps);
+    ImGui::EndChild();
   }
 }
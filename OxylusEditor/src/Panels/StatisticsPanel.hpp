@@ -10,10 +10,16 @@ namespace ox {
     void on_imgui_render() override;
 
   private:
-    float m_FpsValues[50] = {};
-    std::vector<float> m_FrameTimes{};
-
     void MemoryTab() const;
-    void RendererTab();
+    void FrameTab();
+    void ScriptingTab() const;
+    void ProfilerTab();
+
+    int32_t m_SelectedPhase = -1; // -1 is the whole frame
+    int32_t m_SelectedHitch = -1;
+
+    int32_t m_CaptureFrameCount = 60;
+    int32_t m_SelectedFrame = 0;
+    float m_TimelineZoom = 1.0f;
   };
 }